@@ -0,0 +1,37 @@
+#version 100
+
+// Canvas positions reach 800 pixels and the texture coordinates need sub-texel
+// precision across the big quad, so use full precision where the GPU has it
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+// Menu background: bgMenu drawn as a rotated, offset quad three times the
+// canvas size. Only a canvas-sized quad is rasterised; each fragment maps its
+// canvas position back into the big quad's texture coordinates, so the
+// fragment work is one canvas, not nine.
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+uniform vec2 size;          // canvas size in pixels
+
+uniform vec2 bgCenter;      // centre of the big quad, canvas pixels
+uniform vec2 bgSize;        // size of the big quad, canvas pixels
+uniform vec2 bgRotation;    // cos and sin of its rotation
+
+void main() {
+	// Undo the rotation about the quad's centre
+	vec2 d = fragTexCoord * size - bgCenter;
+	vec2 local = vec2(bgRotation.x * d.x + bgRotation.y * d.y, -bgRotation.y * d.x + bgRotation.x * d.y);
+	vec2 uv = local / bgSize + 0.5;
+
+	gl_FragColor = texture2D(texture0, uv)*colDiffuse*fragColor;
+}
@@ -0,0 +1,32 @@
+#version 330
+
+// Menu background: bgMenu drawn as a rotated, offset quad three times the
+// canvas size. Only a canvas-sized quad is rasterised; each fragment maps its
+// canvas position back into the big quad's texture coordinates, so the
+// fragment work is one canvas, not nine.
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+uniform vec2 size;          // canvas size in pixels
+
+uniform vec2 bgCenter;      // centre of the big quad, canvas pixels
+uniform vec2 bgSize;        // size of the big quad, canvas pixels
+uniform vec2 bgRotation;    // cos and sin of its rotation
+
+void main() {
+	// Undo the rotation about the quad's centre
+	vec2 d = fragTexCoord * size - bgCenter;
+	vec2 local = vec2(bgRotation.x * d.x + bgRotation.y * d.y, -bgRotation.y * d.x + bgRotation.x * d.y);
+	vec2 uv = local / bgSize + 0.5;
+
+	finalColor = texture(texture0, uv)*colDiffuse*fragColor;
+}
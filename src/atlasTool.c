@@ -0,0 +1,48 @@
+/*
+ * atlasTool.c - Sprite atlas packer (pinball_atlastool)
+ *
+ * Packs the gameplay sprites (see spriteAtlas.h) into sprites.png and writes
+ * their rects to sprites.atlas, which Resources_Init loads from
+ * Resources/Textures. The atlas target runs it into the build directory and
+ * install copies the result into place; by hand:
+ *
+ *   pinball_atlastool resources/assets/Textures build
+ *
+ * Usage: pinball_atlastool TEXTURE_DIR [OUTPUT_DIR]
+ *   TEXTURE_DIR : directory holding the sprite PNGs
+ *   OUTPUT_DIR  : where to write the atlas and table (default TEXTURE_DIR)
+ */
+
+#include <stdio.h>
+#include "raylib.h"
+#include "spriteAtlas.h"
+
+int main(int argc, char **argv){
+    if (argc != 2 && argc != 3){
+        fprintf(stderr, "usage: %s TEXTURE_DIR [OUTPUT_DIR]\n", argv[0]);
+        return 1;
+    }
+    const char *outputDir = argc == 3 ? argv[2] : argv[1];
+    SetTraceLogLevel(LOG_WARNING);
+
+    Image atlas;
+    Rectangle rects[SPRITE_COUNT];
+    if (SpriteAtlas_Pack(argv[1], &atlas, rects) != 0){
+        return 1;
+    }
+
+    char imagePath[1024];
+    char tablePath[1024];
+    snprintf(imagePath, sizeof(imagePath), "%s/%s", outputDir, SPRITE_ATLAS_IMAGE);
+    snprintf(tablePath, sizeof(tablePath), "%s/%s", outputDir, SPRITE_ATLAS_TABLE);
+    int ok = ExportImage(atlas, imagePath);
+    if (!ok){
+        printf("cannot write %s\n", imagePath);
+    }
+    ok = ok && SpriteAtlas_WriteTable(tablePath, atlas.width, atlas.height, rects) == 0;
+    if (ok){
+        printf("%d sprites packed into %s (%d x %d)\n", SPRITE_COUNT, imagePath, atlas.width, atlas.height);
+    }
+    UnloadImage(atlas);
+    return ok ? 0 : 1;
+}
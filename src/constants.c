@@ -1,3 +1,6 @@
+// Fixed game-logic / physics ticks per second
+const int tickRate = 60;
+
 // Screen and world dimensions
 const int screenWidth = 450;
 const int screenHeight = 800;
@@ -18,6 +21,8 @@ const float flipperActiveAngleRight = 223.0f; // 213.0f + 10.0f
 // Ball constants
 const int maxBalls = 256;
 const float ballSize = 5.0f;
+const float stuckBallSpeed = 0.1f;
+const int stuckBallTicks = 70;    // plus Box2D's 0.5 s to fall asleep: the old 100-tick kill
 
 // Bumper constants
 const int numBumpers = 14;
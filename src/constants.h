@@ -1,6 +1,9 @@
 #ifndef HEADER_CONSTANTS
 #define HEADER_CONSTANTS
 
+// Fixed game-logic / physics ticks per second
+extern const int tickRate;
+
 // Screen and world dimensions
 extern const int screenWidth;
 extern const int screenHeight;
@@ -21,6 +24,10 @@ extern const float flipperActiveAngleRight;
 // Ball constants
 extern const int maxBalls;
 extern const float ballSize;
+// Box2D puts a ball slower than stuckBallSpeed (units/s) to sleep after half a
+// second; it drains as stuck once it has slept for stuckBallTicks more ticks.
+extern const float stuckBallSpeed;
+extern const int stuckBallTicks;
 
 // Bumper constants
 extern const int numBumpers;
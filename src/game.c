@@ -1,6 +1,7 @@
 #include "game.h"
 #include "constants.h"
 #include "physics.h"
+#include <math.h>
 
 void Game_Init(GameStruct *game, Bumper *bumpers) {
     game->currentScene = SCENE_RAYLIB_TITLE;
@@ -18,6 +19,8 @@ void Game_Init(GameStruct *game, Bumper *bumpers) {
 void Game_StartGame(GameStruct *game, Bumper *bumpers) {
     game->gameState = 1;
     game->currentScene = SCENE_GAME;
+    game->currentMode = game->pendingMode;
+    physics_set_ball_collisions(game, game->currentMode == MODE_MEGA_MULTIBALL);
     game->numLives = 3;
     game->gameScore = 0;
     game->powerupScore = 0;
@@ -57,6 +60,17 @@ void Game_StartGame(GameStruct *game, Bumper *bumpers) {
     bumpers[13].enabled = 0;
 }
 
+const char *Game_GetModeName(GameMode mode) {
+    switch (mode) {
+        case MODE_CLASSIC:
+            return "Classic";
+        case MODE_MEGA_MULTIBALL:
+            return "Mega Multiball";
+        default:
+            return "?";
+    }
+}
+
 void Game_Update(GameStruct *game,
                  Bumper *bumpers,
                  InputManager *input,
@@ -159,3 +173,205 @@ void Game_Update(GameStruct *game,
         }
     }
 }
+
+void Game_UpdatePlayfield(GameStruct *game,
+                          Bumper *bumpers,
+                          b2BodyId *leftFlipperBody,
+                          b2BodyId *rightFlipperBody,
+                          PowerupSystem *ps,
+                          InputManager *input,
+                          SoundManager *sound,
+                          float dt) {
+    float physicsDt = Game_BeginPlayfield(game, ps, input, sound, dt);
+    if (physicsDt > 0.0f) {
+        Game_StepPlayfieldPhysics(game, leftFlipperBody, rightFlipperBody, input, sound, physicsDt);
+        Game_EndPlayfield(game, bumpers, ps, input, sound);
+    }
+}
+
+float Game_BeginPlayfield(GameStruct *game,
+                          PowerupSystem *ps,
+                          InputManager *input,
+                          SoundManager *sound,
+                          float dt) {
+
+    // Update powerup system
+    float effectiveTimestep = dt * ps->slowMotionFactor;
+    Powerups_Update(game, ps, input, sound, effectiveTimestep);
+    if (game->gameState != 1) {
+        return 0.0f;
+    }
+
+    // Clamp effective timestep to a sane, non-zero range to avoid numerical issues.
+    if (effectiveTimestep < (1.0f / 600.0f)) {
+        effectiveTimestep = 1.0f / 600.0f;
+    }
+    if (effectiveTimestep > (1.0f / 20.0f)) {
+        effectiveTimestep = 1.0f / 20.0f;
+    }
+    return effectiveTimestep;
+}
+
+void Game_StepPlayfieldPhysics(GameStruct *game,
+                               b2BodyId *leftFlipperBody,
+                               b2BodyId *rightFlipperBody,
+                               InputManager *input,
+                               SoundManager *sound,
+                               float dt) {
+
+    // Update flippers
+    float deltaAngularVelocityLeft = 0.0f;
+    float deltaAngularVelocityRight = 0.0f;
+    physics_flippers_update(game, leftFlipperBody, rightFlipperBody, input, sound,
+                            dt, &deltaAngularVelocityLeft, &deltaAngularVelocityRight);
+
+    // Buoyancy while the water powerup is up; Box2D clears forces after every step
+    physics_apply_buoyancy(game, fabsf(deltaAngularVelocityLeft) > 0, fabsf(deltaAngularVelocityRight) > 0);
+
+    physics_step(game, dt);
+}
+
+void Game_EndPlayfield(GameStruct *game,
+                       Bumper *bumpers,
+                       PowerupSystem *ps,
+                       InputManager *input,
+                       SoundManager *sound) {
+
+    if (game->oldGameScore != game->gameScore) {
+        inputSetScore(input, game->gameScore);
+        game->oldGameScore = game->gameScore;
+    }
+
+    // Check powerups before dispensing balls
+    if (game->ballPowerupState == 0 && !bumpers[7].enabled && !bumpers[8].enabled && !bumpers[9].enabled) {
+        // spawn balls
+        for (int i = 0; i < 3; i++) {
+            physics_add_ball(game, 89.5 - ballSize / 2, 160 - (i * ballSize), 0, -220, 1);
+        }
+        playBluePowerupSound(sound);
+        game->bluePowerupOverlay = 1.0f;
+        game->ballPowerupState = -1;
+        game->gameScore += 500;
+        if (game->waterPowerupState == 0) {
+            game->powerupScore += 500;
+        }
+    } else if (game->ballPowerupState == -1) {
+        // Check if there are no balls left. Then powerup resets and bumpers reset.
+        if (game->numBalls == 0) {
+            game->ballPowerupState = 0;
+            bumpers[7].enabled = 1;
+            bumpers[8].enabled = 1;
+            bumpers[9].enabled = 1;
+        }
+    }
+
+    if (game->bumperPowerupState == 0 && !bumpers[4].enabled && !bumpers[5].enabled && !bumpers[6].enabled) {
+        // spawn bumpers
+        game->bumperPowerupState = -1;
+        bumpers[10].enabled = 1;
+        bumpers[11].enabled = 1;
+        bumpers[12].enabled = 1;
+        bumpers[13].enabled = 1;
+        playRedPowerupSound(sound);
+        game->redPowerupOverlay = 1.0f;
+        game->gameScore += 500;
+        if (game->waterPowerupState == 0) {
+            game->powerupScore += 500;
+        }
+    } else if (game->bumperPowerupState == -1) {
+        if (!bumpers[10].enabled && !bumpers[11].enabled && !bumpers[12].enabled && !bumpers[13].enabled) {
+            game->bumperPowerupState = 0;
+            bumpers[4].enabled = 1;
+            bumpers[5].enabled = 1;
+            bumpers[6].enabled = 1;
+            game->redPowerupOverlay = 1.0f;
+        }
+    }
+
+    if (game->numBalls == 0) {
+        if (game->numLives >= 1) {
+            if (inputCenterPressed(input)) {
+                physics_add_ball(game, 89.5 - ballSize / 2, 160, 0, -220, 0);
+                // Center button strobes 5 times when ball is launched
+                inputSetButtonLED(input, BUTTON_LED_CENTER, LED_MODE_STROBE, 255, 255, 0, 5);  // Yellow strobe
+            }
+        } else {
+            // game over condition
+            if (game->transitionState == 0) {
+                game->transitionState = 1;
+                game->transitionTarget = TRANSITION_GAME_OVER;
+                inputSetGameState(input, STATE_GAME_OVER);
+            }
+        }
+    }
+
+    // One pass over the active balls, all from the state cached by physics_step:
+    // draining balls that fell out or got stuck, and trail sampling. A ball is
+    // stuck once Box2D has kept it asleep for stuckBallTicks (it cannot sleep
+    // while touching a flipper). Water entry comes from the water sensor (see
+    // physics_drain_events).
+    // Walk the active list back to front: physics_remove_ball swaps the last entry in.
+    Ball *balls = game->balls;
+    BallTrails *trails = &game->trails;
+    for (int k = game->numBalls - 1; k >= 0; k--) {
+        int i = game->activeBalls[k];
+        b2Vec2 pos = balls[i].position;
+        if (balls[i].asleep) {
+            balls[i].killCounter++;
+        }
+        if (pos.y > 170 + ballSize || balls[i].killCounter > stuckBallTicks) {
+            physics_remove_ball(game, i);
+            //Check number of lives and send to score if necessary
+            if (game->numBalls == 0) {
+                if (game->numLives >= 1) {
+                    game->numLives -= 1;
+                    inputSetNumBalls(input, game->numLives);
+                }
+            }
+            continue;
+        }
+
+        //Update ball trails
+        int sample = i * BALL_TRAIL_LENGTH + trails->head[i];
+        trails->x[sample] = pos.x;
+        trails->y[sample] = pos.y;
+        trails->head[i] = (trails->head[i] + 1) % BALL_TRAIL_LENGTH;
+    }
+
+    //handler lower bumpers
+    if (game->leftLowerBumperAnim > 0.0f) {
+        game->leftLowerBumperAnim -= 0.05f;
+        if (game->leftLowerBumperAnim < 0.0f) {
+            game->leftLowerBumperAnim = 0.0f;
+        }
+    }
+    if (game->rightLowerBumperAnim > 0.0f) {
+        game->rightLowerBumperAnim -= 0.05f;
+        if (game->rightLowerBumperAnim < 0.0f) {
+            game->rightLowerBumperAnim = 0.0f;
+        }
+    }
+
+    // Update water height based on powerup state
+    if (game->waterPowerupState == 1) {
+        game->waterHeight += 0.006f * ps->slowMotionFactor;
+        if (game->waterHeight > game->waterHeightTarget) {
+            game->waterHeight = game->waterHeightTarget;
+        }
+    } else if (game->waterPowerupState == 2) {
+        game->waterHeight -= 0.0005f * ps->slowMotionFactor;
+        if (game->waterHeight < 0.0f) {
+            game->waterHeight = 0.0f;
+            game->waterPowerupState = 0;
+        }
+    }
+
+    if (game->waterHeightTimer > 0.0f) {
+        game->waterHeightTimer -= 1.0f * ps->slowMotionFactor;
+        if (game->waterHeightTimer <= 0.0f) {
+            game->waterHeightTarget = 0.0f;
+            game->waterPowerupState = 2;
+            printf("water timer runout\n");
+        }
+    }
+}
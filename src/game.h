@@ -5,6 +5,7 @@
 #include "inputManager.h"
 #include "soundManager.h"
 #include "scores.h"
+#include "powerups.h"
 
 // Initialize game state machine
 void Game_Init(GameStruct *game, Bumper *bumpers);
@@ -17,7 +18,45 @@ void Game_Update(GameStruct *game,
                  SoundManager *sound,
                  float dt);
 
-// Start a new game
+// Advance powerups and, while a game is in progress, the playfield by one fixed tick:
+// flippers, physics, powerup dispensing, ball draining, trails and water.
+void Game_UpdatePlayfield(GameStruct *game,
+                          Bumper *bumpers,
+                          b2BodyId *leftFlipperBody,
+                          b2BodyId *rightFlipperBody,
+                          PowerupSystem *ps,
+                          InputManager *input,
+                          SoundManager *sound,
+                          float dt);
+
+// Game_UpdatePlayfield in three parts, for callers that run several physics
+// steps per game tick (the sim thread polls input between them):
+//   Game_BeginPlayfield       - powerups; returns the tick's physics time (slow
+//                               motion applied), or 0 when no game is in progress
+//   Game_StepPlayfieldPhysics - flippers, buoyancy and one physics_step of dt
+//   Game_EndPlayfield         - powerup dispensing, ball draining, trails and water
+// Game_UpdatePlayfield is Begin, one Step of the returned time, then End.
+float Game_BeginPlayfield(GameStruct *game,
+                          PowerupSystem *ps,
+                          InputManager *input,
+                          SoundManager *sound,
+                          float dt);
+void Game_StepPlayfieldPhysics(GameStruct *game,
+                               b2BodyId *leftFlipperBody,
+                               b2BodyId *rightFlipperBody,
+                               InputManager *input,
+                               SoundManager *sound,
+                               float dt);
+void Game_EndPlayfield(GameStruct *game,
+                       Bumper *bumpers,
+                       PowerupSystem *ps,
+                       InputManager *input,
+                       SoundManager *sound);
+
+// Start a new game in game->pendingMode
 void Game_StartGame(GameStruct *game, Bumper *bumpers);
 
+// Display name of a mode ("Classic", "Mega Multiball")
+const char *Game_GetModeName(GameMode mode);
+
 #endif // GAME_H
@@ -1 +1,30 @@
 #include "gameStruct.h"
+#include "constants.h"
+
+void GameStruct_AllocBalls(GameStruct *game) {
+    game->balls = malloc(maxBalls * sizeof(Ball));
+    game->activeBalls = malloc(maxBalls * sizeof(int));
+    game->trails.x = malloc(maxBalls * BALL_TRAIL_LENGTH * sizeof(float));
+    game->trails.y = malloc(maxBalls * BALL_TRAIL_LENGTH * sizeof(float));
+    game->trails.head = malloc(maxBalls * sizeof(int));
+    game->numBalls = 0;
+    for (int i = 0; i < maxBalls; i++) {
+        game->balls[i].active = 0;
+        game->activeBalls[i] = i;  // entries past numBalls are the free slots
+        game->trails.head[i] = 0;
+    }
+}
+
+void GameStruct_FreeBalls(GameStruct *game) {
+    free(game->balls);
+    free(game->activeBalls);
+    free(game->trails.x);
+    free(game->trails.y);
+    free(game->trails.head);
+    game->balls = NULL;
+    game->activeBalls = NULL;
+    game->trails.x = NULL;
+    game->trails.y = NULL;
+    game->trails.head = NULL;
+    game->numBalls = 0;
+}
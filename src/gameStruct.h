@@ -1,46 +1,50 @@
 #ifndef HEADER_GAME_STRUCT
 #define HEADER_GAME_STRUCT
-#include "raylib.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
 #include <math.h>
 #include <box2d/box2d.h>
 #include "inputManager.h"
+#include "water.h"
 
 typedef struct GameStructData GameStruct;
 
-typedef struct SoundManagerObject {
-    Music menuMusic;
-    Music gameMusic;
-    Sound* redPowerup;
-    Sound* bluePowerup;
-    Sound* slowdown;
-    Sound* speedup;
-    Sound* upperBouncer;
-    Sound* click;
-    Sound* bounce1;
-    Sound* bounce2;
-    Sound *flipper;
-    Sound *waterSplash;
-    Sound launch;
-    Sound water;
-    float gameMusicVolume;
-} SoundManager;
+// Per-world physics state, private to physics.c
+typedef struct PhysicsContextObject PhysicsContext;
 
+// Defined by the active sound backend (soundManager.c or soundManagerNull.c)
+// so the simulation core does not depend on raylib's audio types.
+typedef struct SoundManagerObject SoundManager;
+
+// Number of trail samples kept per ball
+#define BALL_TRAIL_LENGTH 16
+
+// Per-tick ball state. Trail history lives in BallTrails so the passes over
+// active balls only touch this.
 typedef struct {
     int active;
-    b2ShapeId shape;
-    b2BodyId body;
-    GameStruct *game;
-    float locationHistoryX[16];
-    float locationHistoryY[16];
-    int trailStartIndex;
     int type;
-    int killCounter;
+    int killCounter;        // ticks the body has been asleep; drained past stuckBallTicks
+    int asleep;             // Box2D put the body to sleep (no move events until it wakes)
+    int flipperContacts;    // flipper shapes touching; sleep is off while nonzero
     int underwaterState;
+    int activeIndex;    // position in game->activeBalls while active
+    b2Vec2 position;    // cached after each physics_step
+    b2Vec2 velocity;    // cached after each physics_step
+    b2Vec2 previousPosition;  // position before the last physics_step, for render interpolation
+    b2BodyId body;
+    b2ShapeId shape;
 } Ball;
 
+// Trail history for all balls, structure-of-arrays.
+// Sample k of ball i is x[i * BALL_TRAIL_LENGTH + k]; head[i] is the next sample to overwrite.
+typedef struct {
+    float *x;
+    float *y;
+    int *head;
+} BallTrails;
+
 typedef enum {
     TRANSITION_TO_MENU,
     TRANSITION_TO_GAME,
@@ -55,12 +59,15 @@ typedef enum {
 } SceneId;
 
 typedef enum {
-    MODE_CLASSIC   // Currently only one mode exists
+    MODE_CLASSIC,          // balls pass through each other
+    MODE_MEGA_MULTIBALL,   // balls collide with each other (physics_set_ball_collisions)
+    MODE_COUNT
 } GameMode;
 
 typedef struct {
     b2ShapeId shape;
     b2BodyId body;
+    b2Vec2 position;    // static body position, so drawing needs no Box2D call
     float bounceEffect;
     int type;
     int enabled;
@@ -95,13 +102,25 @@ enum CollisionCategoryBits {
     CATEGORY_PADDLE = (1 << 3),            // 0x0008
     CATEGORY_LEFT_LOWER_BUMPER = (1 << 4), // 0x0010
     CATEGORY_RIGHT_LOWER_BUMPER = (1 << 5),// 0x0020
-    CATEGORY_ONE_WAY = (1 << 6)            // 0x0040
+    CATEGORY_ONE_WAY = (1 << 6),           // 0x0040
+    CATEGORY_WATER = (1 << 7)              // 0x0080
 };
 
 struct GameStructData {
     b2WorldId world;
+    PhysicsContext *physics;  // Owned by physics; created in physics_init, freed in physics_shutdown
+    int physicsWorkers;  // Box2D solver threads incl. the caller, read by physics_init (0 = one per CPU)
+    const char *tablePath;  // Table geometry file read by physics_init (NULL = built-in table)
     int numBalls;
     Ball *balls;
+    int *activeBalls;    // maxBalls slot indices: [0, numBalls) active, the rest free (see physics_add_ball)
+    BallTrails trails;
+    b2Vec2 flipperPositions[2];      // left / right flipper pivot (set in physics_init)
+    float flipperAngles[2];          // left / right flipper body angle (radians) after the last physics_step
+    float previousFlipperAngles[2];  // the same before it; the renderer interpolates between the two
+    float leftLowerBumperAnim;       // 1 when a slingshot is hit, fades to 0 (see Game_EndPlayfield)
+    float rightLowerBumperAnim;
+    Bumper *bumpers;  // Owned by physics; set in physics_init
     int active;
     int gameState;  // Legacy: 0=menu, 1=game, 2=gameover, 5=title
     SceneId currentScene;
@@ -133,6 +152,7 @@ struct GameStructData {
     float bluePowerupOverlay;
     float slowMotionFactor;
     SoundManager *sound;
+    WaterSystem *water;
     int leftFlipperState;
     int rightFlipperState;
     
@@ -147,4 +167,8 @@ struct GameStructData {
 
 };
 
+// Allocate / free game->balls, game->activeBalls and game->trails for maxBalls balls
+void GameStruct_AllocBalls(GameStruct *game);
+void GameStruct_FreeBalls(GameStruct *game);
+
 #endif
@@ -0,0 +1,91 @@
+/*
+ * hashDiff.c - State hash stream comparison (pinball_hashdiff)
+ *
+ * Compares two streams written with --hash (see stateHash.h), e.g. the same
+ * recording replayed on the dev machine and on the Pi:
+ *
+ *   pinball_sim --replay session.rec --hash x86.hash
+ *   pinball_sim --replay session.rec --hash pi.hash     (on the Pi)
+ *   pinball_hashdiff x86.hash pi.hash
+ *
+ * Prints the first step where the streams differ and which fields differ
+ * there, then how many steps differ in total. Exits with 0 when the streams
+ * match, 1 when they differ or cannot be read.
+ *
+ * Usage: pinball_hashdiff A B
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "stateHash.h"
+
+int main(int argc, char **argv){
+    if (argc != 3){
+        fprintf(stderr, "usage: %s A B\n", argv[0]);
+        return 1;
+    }
+    StateHashReader *a = StateHashReader_Open(argv[1]);
+    StateHashReader *b = StateHashReader_Open(argv[2]);
+    if (a == NULL || b == NULL){
+        StateHashReader_Close(a);
+        StateHashReader_Close(b);
+        return 1;
+    }
+    if (StateHashReader_GetFieldCount(a) != StateHashReader_GetFieldCount(b)){
+        printf("field counts differ (%d and %d); only the shared fields are compared\n",
+               StateHashReader_GetFieldCount(a), StateHashReader_GetFieldCount(b));
+    }
+
+    long steps = 0;
+    long divergentSteps = 0;
+    long fieldSteps[STATE_HASH_FIELDS] = {0};
+    int endA = 0;
+    int endB = 0;
+    for (;;){
+        StateHashRecord recordA;
+        StateHashRecord recordB;
+        endA = !StateHashReader_Next(a, &recordA);
+        endB = !StateHashReader_Next(b, &recordB);
+        if (endA || endB){
+            break;
+        }
+        if (recordA.step != recordB.step){
+            printf("step numbers part at record %ld (%u and %u)\n", steps, recordA.step, recordB.step);
+            divergentSteps++;
+            break;
+        }
+
+        int differs = 0;
+        for (int f = 0; f < STATE_HASH_FIELDS; f++){
+            if (recordA.fields[f] != recordB.fields[f]){
+                if (divergentSteps == 0){
+                    if (!differs){
+                        printf("first divergence at step %u\n", recordA.step);
+                    }
+                    printf("  %-16s %08x %08x\n", StateHash_GetFieldName(f), recordA.fields[f], recordB.fields[f]);
+                }
+                fieldSteps[f]++;
+                differs = 1;
+            }
+        }
+        divergentSteps += differs;
+        steps++;
+    }
+
+    if (endA != endB){
+        printf("%s ends after %ld steps; the other continues\n", endA ? argv[1] : argv[2], steps);
+    }
+    if (divergentSteps == 0 && endA == endB){
+        printf("%ld steps match\n", steps);
+    } else if (divergentSteps > 0){
+        printf("%ld of %ld steps differ\n", divergentSteps, steps);
+        for (int f = 0; f < STATE_HASH_FIELDS; f++){
+            if (fieldSteps[f] > 0){
+                printf("  %-16s %ld steps\n", StateHash_GetFieldName(f), fieldSteps[f]);
+            }
+        }
+    }
+    StateHashReader_Close(a);
+    StateHashReader_Close(b);
+    return (divergentSteps == 0 && endA == endB) ? 0 : 1;
+}
@@ -7,6 +7,7 @@ typedef struct {
     int leftKeyPressed;
     int rightKeyPressed;
     int centerKeyPressed;
+    int tick;              // Input updates seen so far (scripted/replay backends)
 } InputManager;
 
 typedef enum {
@@ -38,6 +39,17 @@ int inputCenter(InputManager* input);
 int inputLeftPressed(InputManager* input);
 int inputRightPressed(InputManager* input);
 int inputCenterPressed(InputManager* input);
+
+// The desktop backend reads the keyboard and gamepad through raylib, which is
+// only safe on the window thread. inputSampleDevices reads them there once per
+// frame; inputFeedDevices hands the sample to the InputManager on the thread
+// that calls inputUpdate. Both use the keyState bits (1 left, 2 center,
+// 4 right); pressed holds the keys that went down since the previous feed and
+// is what the *Pressed functions report until the next one.
+// inputSampleDevices returns 0, and inputFeedDevices does nothing, on backends
+// that read their own hardware in inputUpdate.
+int inputSampleDevices(int *keyState, int *pressed);
+void inputFeedDevices(InputManager *input, int keyState, int pressed);
 void inputSetGameState(InputManager* input, InputGameState state);
 void inputSetScore(InputManager *input, long score);
 void inputSetNumBalls(InputManager *input, int numBalls);
@@ -3,7 +3,8 @@
 #include <stdlib.h>
 
 InputManager* inputInit(){
-    InputManager *input = malloc(sizeof(InputManager));
+    InputManager *input = calloc(1, sizeof(InputManager));
+    input->fd = -1;
     return input;
 }
 
@@ -11,31 +12,65 @@ void inputUpdate(InputManager* input){
     return;
 }
 void inputShutdown(InputManager* input){
-    return;
+    free(input);
+}
+
+// Window thread only: raylib updates these in EndDrawing
+int inputSampleDevices(int *keyState, int *pressed){
+    int state = 0;
+    if (IsKeyDown(KEY_LEFT) || GetGamepadAxisMovement(0, 4) > -0.75){
+        state |= 1;
+    }
+    if (IsKeyDown(KEY_SPACE) || IsGamepadButtonDown(0, 7)){
+        state |= 2;
+    }
+    if (IsKeyDown(KEY_RIGHT) || GetGamepadAxisMovement(0, 5) > -0.75){
+        state |= 4;
+    }
+    int down = 0;
+    if (IsKeyPressed(KEY_LEFT)){
+        down |= 1;
+    }
+    if (IsKeyPressed(KEY_SPACE) || IsGamepadButtonPressed(0, 7)){
+        down |= 2;
+    }
+    if (IsKeyPressed(KEY_RIGHT)){
+        down |= 4;
+    }
+    *keyState = state;
+    *pressed = down;
+    return 1;
+}
+
+void inputFeedDevices(InputManager* input, int keyState, int pressed){
+    input->keyState = keyState;
+    input->leftKeyPressed = pressed & 1;
+    input->centerKeyPressed = pressed & 2;
+    input->rightKeyPressed = pressed & 4;
 }
 
 int inputLeft(InputManager* input){
-    return IsKeyDown(KEY_LEFT) || GetGamepadAxisMovement(0, 4) > -0.75;
+    return (input->keyState & 1);
 }
 
 int inputRight(InputManager* input){
-    return IsKeyDown(KEY_RIGHT) || GetGamepadAxisMovement(0, 5) > -0.75;
+    return (input->keyState & 4);
 }
 
 int inputCenter(InputManager* input){
-    return IsKeyDown(KEY_SPACE) || IsGamepadButtonDown(0, 7);
+    return (input->keyState & 2);
 }
 
 int inputLeftPressed(InputManager* input){
-    return IsKeyPressed(KEY_LEFT);
+    return input->leftKeyPressed;
 }
 
 int inputRightPressed(InputManager* input){
-    return IsKeyPressed(KEY_RIGHT);
+    return input->rightKeyPressed;
 }
 
 int inputCenterPressed(InputManager* input){
-    return IsKeyPressed(KEY_SPACE) || IsGamepadButtonPressed(0, 7);
+    return input->centerKeyPressed;
 }
 
 void inputSetGameState(InputManager* input, InputGameState state){
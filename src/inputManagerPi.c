@@ -112,6 +112,7 @@ InputManager* inputInit(){
     input->leftKeyPressed = 0;
     input->rightKeyPressed = 0;
     input->centerKeyPressed = 0;
+    input->tick = 0;
     return input;
 }
 
@@ -126,6 +127,19 @@ void inputUpdate(InputManager* input){
     }
 }
 
+// The Pico reports the buttons over serial, read in inputUpdate
+int inputSampleDevices(int *keyState, int *pressed){
+    *keyState = 0;
+    *pressed = 0;
+    return 0;
+}
+
+void inputFeedDevices(InputManager* input, int keyState, int pressed){
+    (void)input;
+    (void)keyState;
+    (void)pressed;
+}
+
 int inputLeft(InputManager* input){
     // Physical left button corresponds to bit 0 (0x01)
     return (input->keyState & 1);
@@ -0,0 +1,174 @@
+#include "inputManager.h"
+#include "inputRecord.h"
+#include <stdlib.h>
+
+// Scripted input backend for the headless simulation runner (pinball_sim).
+// There is no hardware: buttons follow a fixed, deterministic pattern so that
+// every run exercises the same flipper and launch workload, or, with a replay
+// attached (pinball_sim --replay), the key state recorded by the game.
+//
+// keyState uses the same bit layout as the Pico serial protocol:
+//   bit 0 (0x01) = left, bit 1 (0x02) = center, bit 2 (0x04) = right
+
+#define SIM_LEFT_PERIOD    47
+#define SIM_RIGHT_PERIOD   53
+#define SIM_FLIP_HOLD      12
+#define SIM_CENTER_PERIOD  90
+#define SIM_CENTER_HOLD    2
+
+// pinball_sim drives a single InputManager
+static InputReplay *replay = NULL;
+static InputTick replayTick;
+static int replayDone = 0;
+
+InputManager* inputInit(){
+    InputManager *input = malloc(sizeof(InputManager));
+    input->fd = -1;
+    input->keyState = 0;
+    input->leftKeyPressed = 0;
+    input->rightKeyPressed = 0;
+    input->centerKeyPressed = 0;
+    input->tick = 0;
+    return input;
+}
+
+void inputShutdown(InputManager* input){
+    free(input);
+}
+
+void inputSimAttachReplay(InputManager *input, InputReplay *source){
+    (void)input;
+    replay = source;
+    replayDone = 0;
+}
+
+const InputTick *inputSimReplayTick(InputManager *input){
+    (void)input;
+    return (replay != NULL && !replayDone) ? &replayTick : NULL;
+}
+
+void inputSimReplayStep(InputManager *input, int step){
+    if (replay == NULL || replayDone){
+        return;
+    }
+    for (int i = 0; i < replayTick.numEvents; i++){
+        if (replayTick.events[i].type == INPUT_EVENT_KEYS && replayTick.events[i].step == step){
+            input->keyState = replayTick.events[i].value;
+        }
+    }
+}
+
+void inputUpdate(InputManager* input){
+    int t = input->tick++;
+    if (replay != NULL){
+        if (!replayDone && !InputReplay_NextTick(replay, &replayTick)){
+            replayDone = 1;
+        }
+        input->keyState = replayDone ? 0 : replayTick.keyState;
+        return;
+    }
+    int state = 0;
+    if ((t % SIM_LEFT_PERIOD) < SIM_FLIP_HOLD){
+        state |= 1;
+    }
+    if ((t % SIM_CENTER_PERIOD) < SIM_CENTER_HOLD){
+        state |= 2;
+    }
+    if ((t % SIM_RIGHT_PERIOD) < SIM_FLIP_HOLD){
+        state |= 4;
+    }
+    input->keyState = state;
+}
+
+// No devices: the buttons are scripted or replayed in inputUpdate
+int inputSampleDevices(int *keyState, int *pressed){
+    *keyState = 0;
+    *pressed = 0;
+    return 0;
+}
+
+void inputFeedDevices(InputManager* input, int keyState, int pressed){
+    (void)input;
+    (void)keyState;
+    (void)pressed;
+}
+
+int inputLeft(InputManager* input){
+    return (input->keyState & 1);
+}
+
+int inputRight(InputManager* input){
+    return (input->keyState & 4);
+}
+
+int inputCenter(InputManager* input){
+    return (input->keyState & 2);
+}
+
+int inputLeftPressed(InputManager* input){
+    if (inputLeft(input)){
+        if (input->leftKeyPressed == 0){
+            input->leftKeyPressed = 1;
+            return 1;
+        }
+    } else {
+        input->leftKeyPressed = 0;
+    }
+    return 0;
+}
+
+int inputRightPressed(InputManager* input){
+    if (inputRight(input)){
+        if (input->rightKeyPressed == 0){
+            input->rightKeyPressed = 1;
+            return 1;
+        }
+    } else {
+        input->rightKeyPressed = 0;
+    }
+    return 0;
+}
+
+int inputCenterPressed(InputManager* input){
+    if (inputCenter(input)){
+        if (input->centerKeyPressed == 0){
+            input->centerKeyPressed = 1;
+            return 1;
+        }
+    } else {
+        input->centerKeyPressed = 0;
+    }
+    return 0;
+}
+
+// Cabinet outputs (Pico LEDs and score display) have nowhere to go headless.
+void inputSetGameState(InputManager* input, InputGameState state){
+    (void)input;
+    (void)state;
+}
+void inputSetScore(InputManager *input, long score){
+    (void)input;
+    (void)score;
+}
+void inputSetNumBalls(InputManager *input, int numBalls){
+    (void)input;
+    (void)numBalls;
+}
+void inputSetButtonLED(InputManager *input, int button_idx, InputLEDMode mode, int r, int g, int b, int count){
+    (void)input;
+    (void)button_idx;
+    (void)mode;
+    (void)r;
+    (void)g;
+    (void)b;
+    (void)count;
+}
+void inputSendEvent(InputManager *input, const char *event_name){
+    (void)input;
+    (void)event_name;
+}
+void inputSendGameStart(InputManager *input){ (void)input; }
+void inputSendBallReady(InputManager *input){ (void)input; }
+void inputSendBallLaunched(InputManager *input){ (void)input; }
+void inputSendBallSavedAnimation(InputManager *input){ (void)input; }
+void inputSendMultiballAnimation(InputManager *input){ (void)input; }
@@ -0,0 +1,318 @@
+/*
+ * inputRecord.c - Per-tick input recording and replay (see inputRecord.h)
+ *
+ * Most ticks repeat the previous key state, so ticks are stored as runs of up
+ * to 16 identical ticks per byte; an hour of play is typically a few kilobytes.
+ */
+
+#include "inputRecord.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char recordMagic[4] = { 'P', 'B', 'I', 'R' };
+
+#define RECORD_HEADER_SIZE  16
+#define RECORD_KEY_MASK     0x07
+#define RECORD_EVENTS_FLAG  0x08
+#define RECORD_MAX_RUN      16
+
+struct InputRecorderObject {
+    FILE *file;
+    int runKeyState;
+    int runLength;      // ticks in the pending run, 0 if none
+    int numEvents;
+    InputEvent events[INPUT_RECORD_MAX_EVENTS];
+    int droppedEvents;
+};
+
+struct InputReplayObject {
+    uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint32_t seed;
+    int tickRate;
+    int physicsRate;
+    int quality;
+    int mode;
+    int runKeyState;
+    int runRemaining;   // ticks left in the current run after the one returned
+};
+
+/* -------------------------------------------------------------------------- */
+/*  Recording                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static void put_u16(uint8_t *p, uint16_t value) {
+    p[0] = value & 0xff;
+    p[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t value) {
+    p[0] = value & 0xff;
+    p[1] = (value >> 8) & 0xff;
+    p[2] = (value >> 16) & 0xff;
+    p[3] = value >> 24;
+}
+
+static void put_f32(uint8_t *p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u32(p, bits);
+}
+
+InputRecorder *InputRecorder_Create(const char *path, uint32_t seed, int tickRate, int physicsRate, int quality, int mode) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("InputRecorder_Create: cannot open %s\n", path);
+        return NULL;
+    }
+    InputRecorder *recorder = calloc(1, sizeof(InputRecorder));
+    recorder->file = file;
+
+    uint8_t header[RECORD_HEADER_SIZE] = {0};
+    memcpy(header, recordMagic, sizeof(recordMagic));
+    put_u16(header + 4, INPUT_RECORD_VERSION);
+    put_u16(header + 6, (uint16_t)tickRate);
+    put_u32(header + 8, seed);
+    header[12] = (uint8_t)quality;
+    header[13] = (uint8_t)mode;
+    put_u16(header + 14, (uint16_t)physicsRate);
+    fwrite(header, 1, sizeof(header), file);
+    return recorder;
+}
+
+static void recorder_flush_run(InputRecorder *recorder) {
+    if (recorder->runLength == 0) {
+        return;
+    }
+    fputc((recorder->runKeyState & RECORD_KEY_MASK) | ((recorder->runLength - 1) << 4), recorder->file);
+    recorder->runLength = 0;
+}
+
+static InputEvent *recorder_add_event(InputRecorder *recorder) {
+    if (recorder->numEvents == INPUT_RECORD_MAX_EVENTS) {
+        if (recorder->droppedEvents++ == 0) {
+            printf("InputRecorder: more than %d events in one tick, dropping (replay will diverge)\n",
+                   INPUT_RECORD_MAX_EVENTS);
+        }
+        return NULL;
+    }
+    InputEvent *event = &recorder->events[recorder->numEvents++];
+    memset(event, 0, sizeof(*event));
+    return event;
+}
+
+void InputRecorder_AddSpawn(InputRecorder *recorder, float x, float y) {
+    InputEvent *event = recorder_add_event(recorder);
+    if (event != NULL) {
+        event->type = INPUT_EVENT_SPAWN;
+        event->x = x;
+        event->y = y;
+    }
+}
+
+void InputRecorder_AddQuality(InputRecorder *recorder, int quality) {
+    InputEvent *event = recorder_add_event(recorder);
+    if (event != NULL) {
+        event->type = INPUT_EVENT_QUALITY;
+        event->value = quality;
+    }
+}
+
+void InputRecorder_AddKeys(InputRecorder *recorder, int step, int keyState) {
+    InputEvent *event = recorder_add_event(recorder);
+    if (event != NULL) {
+        event->type = INPUT_EVENT_KEYS;
+        event->step = step;
+        event->value = keyState & RECORD_KEY_MASK;
+    }
+}
+
+void InputRecorder_EndTick(InputRecorder *recorder, int keyState) {
+    keyState &= RECORD_KEY_MASK;
+
+    if (recorder->numEvents > 0) {
+        recorder_flush_run(recorder);
+        fputc(keyState | RECORD_EVENTS_FLAG, recorder->file);
+        fputc(recorder->numEvents, recorder->file);
+        for (int i = 0; i < recorder->numEvents; i++) {
+            const InputEvent *event = &recorder->events[i];
+            uint8_t payload[9];
+            payload[0] = (uint8_t)event->type;
+            if (event->type == INPUT_EVENT_SPAWN) {
+                put_f32(payload + 1, event->x);
+                put_f32(payload + 5, event->y);
+                fwrite(payload, 1, 9, recorder->file);
+            } else if (event->type == INPUT_EVENT_KEYS) {
+                payload[1] = (uint8_t)event->step;
+                payload[2] = (uint8_t)event->value;
+                fwrite(payload, 1, 3, recorder->file);
+            } else {
+                payload[1] = (uint8_t)event->value;
+                fwrite(payload, 1, 2, recorder->file);
+            }
+        }
+        recorder->numEvents = 0;
+        return;
+    }
+
+    if (recorder->runLength > 0 && recorder->runKeyState == keyState &&
+        recorder->runLength < RECORD_MAX_RUN) {
+        recorder->runLength++;
+        return;
+    }
+    recorder_flush_run(recorder);
+    recorder->runKeyState = keyState;
+    recorder->runLength = 1;
+}
+
+void InputRecorder_Close(InputRecorder *recorder) {
+    if (recorder == NULL) {
+        return;
+    }
+    recorder_flush_run(recorder);
+    if (fclose(recorder->file) != 0) {
+        printf("InputRecorder_Close: write failed\n");
+    }
+    free(recorder);
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Replay                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float get_f32(const uint8_t *p) {
+    uint32_t bits = get_u32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+InputReplay *InputReplay_Open(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("InputReplay_Open: cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *data = size >= RECORD_HEADER_SIZE ? malloc(size) : NULL;
+    if (data == NULL || fread(data, 1, size, file) != (size_t)size) {
+        printf("InputReplay_Open: cannot read %s\n", path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    int version = data[4] | (data[5] << 8);
+    if (memcmp(data, recordMagic, sizeof(recordMagic)) != 0 || version != INPUT_RECORD_VERSION) {
+        printf("InputReplay_Open: %s is not a version %d recording\n", path, INPUT_RECORD_VERSION);
+        free(data);
+        return NULL;
+    }
+
+    int tickRate = data[6] | (data[7] << 8);
+    int physicsRate = data[14] | (data[15] << 8);
+    if (tickRate == 0 || physicsRate < tickRate || physicsRate % tickRate != 0) {
+        printf("InputReplay_Open: %s has physics rate %d for tick rate %d\n", path, physicsRate, tickRate);
+        free(data);
+        return NULL;
+    }
+
+    InputReplay *replay = calloc(1, sizeof(InputReplay));
+    replay->data = data;
+    replay->size = (size_t)size;
+    replay->pos = RECORD_HEADER_SIZE;
+    replay->tickRate = tickRate;
+    replay->physicsRate = physicsRate;
+    replay->seed = get_u32(data + 8);
+    replay->quality = data[12];
+    replay->mode = data[13];
+    return replay;
+}
+
+uint32_t InputReplay_GetSeed(const InputReplay *replay) {
+    return replay->seed;
+}
+
+int InputReplay_GetTickRate(const InputReplay *replay) {
+    return replay->tickRate;
+}
+
+int InputReplay_GetPhysicsRate(const InputReplay *replay) {
+    return replay->physicsRate;
+}
+
+int InputReplay_GetQuality(const InputReplay *replay) {
+    return replay->quality;
+}
+
+int InputReplay_GetMode(const InputReplay *replay) {
+    return replay->mode;
+}
+
+int InputReplay_NextTick(InputReplay *replay, InputTick *tick) {
+    tick->numEvents = 0;
+    if (replay->runRemaining > 0) {
+        replay->runRemaining--;
+        tick->keyState = replay->runKeyState;
+        return 1;
+    }
+    if (replay->pos >= replay->size) {
+        return 0;
+    }
+
+    const uint8_t *data = replay->data;
+    size_t size = replay->size;
+    int b = data[replay->pos++];
+    tick->keyState = b & RECORD_KEY_MASK;
+
+    if (!(b & RECORD_EVENTS_FLAG)) {
+        replay->runKeyState = tick->keyState;
+        replay->runRemaining = b >> 4;
+        return 1;
+    }
+
+    if (replay->pos >= size || data[replay->pos] > INPUT_RECORD_MAX_EVENTS) {
+        printf("InputReplay: corrupt event list at byte %zu\n", replay->pos);
+        replay->pos = size;
+        return 0;
+    }
+    int count = data[replay->pos++];
+    for (int i = 0; i < count; i++) {
+        InputEvent *event = &tick->events[i];
+        memset(event, 0, sizeof(*event));
+        event->type = replay->pos < size ? data[replay->pos++] : 0;
+        if (event->type == INPUT_EVENT_SPAWN && size - replay->pos >= 8) {
+            event->x = get_f32(data + replay->pos);
+            event->y = get_f32(data + replay->pos + 4);
+            replay->pos += 8;
+        } else if (event->type == INPUT_EVENT_QUALITY && size - replay->pos >= 1) {
+            event->value = data[replay->pos++];
+        } else if (event->type == INPUT_EVENT_KEYS && size - replay->pos >= 2) {
+            event->step = data[replay->pos++];
+            event->value = data[replay->pos++] & RECORD_KEY_MASK;
+        } else {
+            printf("InputReplay: corrupt event at byte %zu\n", replay->pos);
+            replay->pos = size;
+            return 0;
+        }
+        tick->numEvents++;
+    }
+    return 1;
+}
+
+void InputReplay_Close(InputReplay *replay) {
+    if (replay == NULL) {
+        return;
+    }
+    free(replay->data);
+    free(replay);
+}
@@ -0,0 +1,105 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <stdint.h>
+#include "inputManager.h"
+
+/*
+ * inputRecord.h - Per-tick input recording and replay
+ *
+ * The game records, for every fixed tick, the buttons it saw (inputLeft /
+ * inputCenter / inputRight) at the tick's first physics step and any change
+ * at a later step, the balls spawned with the mouse and physics quality
+ * changes, plus the rand() seed, game mode and physics rate it ran with. pinball_sim
+ * --replay feeds a recording back tick-for-tick through the same Game_Update /
+ * physics_step sequence, at the recorded physics steps per tick, so a session
+ * from the cabinet can be rerun and profiled on a dev machine.
+ *
+ * File format (little-endian):
+ *
+ *   header : char magic[4] = "PBIR", u16 version, u16 tickRate (ticks per second),
+ *            u32 seed, u8 quality (PhysicsQuality at the first tick),
+ *            u8 mode (GameMode chosen with --mode),
+ *            u16 physicsRate (physics steps per second, a multiple of tickRate)
+ *   ticks  : one byte per run of identical ticks
+ *              bits 0-2 : key state (0x01 left, 0x02 center, 0x04 right, as the Pico sends)
+ *              bit 3    : events follow (run length is then 1)
+ *              bits 4-7 : run length - 1
+ *            with events: u8 count, then per event u8 type and its payload
+ *              INPUT_EVENT_SPAWN   : f32 x, f32 y (world units)
+ *              INPUT_EVENT_QUALITY : u8 quality
+ *              INPUT_EVENT_KEYS    : u8 step, u8 key state
+ *
+ * The cabinet backend derives the *Pressed edges from the same key state, so a
+ * replay reproduces them exactly. On the raylib keyboard backend, where
+ * IsKeyPressed is per frame rather than per tick, presses replay as edges of
+ * the recorded key state.
+ */
+
+#define INPUT_RECORD_VERSION 3
+
+// Events kept per tick; more are dropped with a warning
+#define INPUT_RECORD_MAX_EVENTS 16
+
+typedef enum {
+    INPUT_EVENT_SPAWN   = 1,  // physics_add_ball at (x, y) after Game_UpdatePlayfield
+    INPUT_EVENT_QUALITY = 2,  // physics_set_quality(value) before the tick runs
+    INPUT_EVENT_KEYS    = 3   // key state value from physics step `step` of the tick on
+} InputEventType;
+
+typedef struct {
+    int type;       // InputEventType
+    float x, y;     // INPUT_EVENT_SPAWN
+    int value;      // INPUT_EVENT_QUALITY, INPUT_EVENT_KEYS
+    int step;       // INPUT_EVENT_KEYS: 1 .. physics steps per tick - 1
+} InputEvent;
+
+typedef struct {
+    int keyState;
+    int numEvents;
+    InputEvent events[INPUT_RECORD_MAX_EVENTS];
+} InputTick;
+
+typedef struct InputRecorderObject InputRecorder;
+typedef struct InputReplayObject InputReplay;
+
+// Start a recording. Returns NULL (after printing why) if the file cannot be created.
+InputRecorder *InputRecorder_Create(const char *path, uint32_t seed, int tickRate, int physicsRate, int quality, int mode);
+
+// Events for the tick in progress; call before InputRecorder_EndTick.
+// AddKeys records a key state change before physics step `step` of the tick.
+void InputRecorder_AddSpawn(InputRecorder *recorder, float x, float y);
+void InputRecorder_AddQuality(InputRecorder *recorder, int quality);
+void InputRecorder_AddKeys(InputRecorder *recorder, int step, int keyState);
+
+// Finish the current tick with the key state seen at its first physics step.
+void InputRecorder_EndTick(InputRecorder *recorder, int keyState);
+
+// Flush and close. Safe to call with NULL.
+void InputRecorder_Close(InputRecorder *recorder);
+
+// Load a recording. Returns NULL (after printing why) if it cannot be read.
+InputReplay *InputReplay_Open(const char *path);
+
+uint32_t InputReplay_GetSeed(const InputReplay *replay);
+int InputReplay_GetTickRate(const InputReplay *replay);
+int InputReplay_GetPhysicsRate(const InputReplay *replay);
+int InputReplay_GetQuality(const InputReplay *replay);
+int InputReplay_GetMode(const InputReplay *replay);
+
+// Next recorded tick. Returns 0 once the recording is exhausted.
+int InputReplay_NextTick(InputReplay *replay, InputTick *tick);
+
+void InputReplay_Close(InputReplay *replay);
+
+// Replay backend (inputManagerSim.c): while a replay is attached, inputUpdate
+// takes each tick's key state from it instead of the scripted pattern.
+void inputSimAttachReplay(InputManager *input, InputReplay *replay);
+
+// Tick read by the last inputUpdate, or NULL once the replay has run out.
+const InputTick *inputSimReplayTick(InputManager *input);
+
+// Apply the tick's INPUT_EVENT_KEYS for physics step `step` (call before it).
+void inputSimReplayStep(InputManager *input, int step);
+
+#endif // INPUT_RECORD_H
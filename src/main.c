@@ -1,6 +1,8 @@
 #include "raylib.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <math.h>
 #include <box2d/box2d.h>
 #include "constants.h"
@@ -18,6 +20,11 @@
 #include "water.h"
 #include "powerups.h"
 #include "menu.h"
+#include "inputRecord.h"
+#include "simThread.h"
+#include "stormBench.h"
+#include "rewindBuffer.h"
+#include "stateHash.h"
 
 #if defined(PLATFORM_RPI)
     #define GLSL_VERSION            100
@@ -25,26 +32,64 @@
     #define GLSL_VERSION            330
 #endif
 
-// global pointer to the bumpers array
-Bumper* bumpers = NULL;
-
 // Global water system instance
 static WaterSystem waterSystem;
 
-// AddWaterImpulse: Called from physics.c when ball hits water
-void AddWaterImpulse(float x, float impulse) {
-    Water_AddImpulse(&waterSystem, x, impulse);
-    waterSystem.impactIntensity += 0.6f;
-    if (waterSystem.impactIntensity > 1.5f) {
-        waterSystem.impactIntensity = 1.5f;
+int main(int argc, char **argv){
+
+    // --record FILE: log every fixed tick's input for pinball_sim --replay
+    // --physics-hz N: physics steps per second on the sim thread (multiple of tickRate)
+    // --profile FILE: on exit, dump the per-tick physics profile (CSV, or JSON for *.json)
+    // --hash FILE: write a state hash after every physics step (see stateHash.h); with
+    //     --record, compare it against pinball_sim --replay --hash using pinball_hashdiff
+    // --mode classic|mega: game mode preselected in the menu (mega multiball: balls collide)
+    // --storm [--water] [--slowmo]: start a game, run the ball-storm benchmark with
+    //     rendering (see stormBench.h) and quit; --baseline FILE, --write-baseline and
+    //     --tolerance PCT work as for pinball_sim, and a regression exits with 2
+    const char *recordPath = NULL;
+    const char *profilePath = NULL;
+    const char *hashPath = NULL;
+    int physicsRate = 240;
+    StormBenchConfig stormConfig = { .runner = "game" };
+    int stormBench = 0;
+    const char *baselinePath = NULL;
+    int writeBaseline = 0;
+    float tolerance = 0.2f;
+    GameMode mode = MODE_CLASSIC;
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc){
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--physics-hz") == 0 && i + 1 < argc){
+            physicsRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc){
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc){
+            hashPath = argv[++i];
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc){
+            i++;
+            mode = strcmp(argv[i], "mega") == 0 ? MODE_MEGA_MULTIBALL : MODE_CLASSIC;
+        } else if (strcmp(argv[i], "--storm") == 0){
+            stormBench = 1;
+        } else if (strcmp(argv[i], "--water") == 0){
+            stormConfig.water = 1;
+        } else if (strcmp(argv[i], "--slowmo") == 0){
+            stormConfig.slowMotion = 1;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0){
+            writeBaseline = 1;
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc){
+            tolerance = atof(argv[++i]) / 100.0f;
+        }
     }
-}
-
-int main(void){
 
     // Initialize a struct encoding data about the game.
+    // Zeroed so a replay starts from the same state as the recorded session.
     GameStruct game;
+    memset(&game, 0, sizeof(game));
     game.gameState = 0;
+    game.physicsWorkers = 0;  // one Box2D worker per CPU
+    game.tablePath = "Resources/Tables/default.tbl";
 
 
     SetConfigFlags(FLAG_VSYNC_HINT);
@@ -68,6 +113,7 @@ int main(void){
 
     // Initialize water system
     Water_Init(&waterSystem);
+    game.water = &waterSystem;
     
     // Shader parameters for amplitude scaling
     float ampX = 5.0f;
@@ -76,24 +122,29 @@ int main(void){
     float shaderSeconds = 0.0f;
 
     // Initialize physics simulation
+    Bumper* bumpers = NULL;
     b2BodyId* leftFlipperBody = NULL;
     b2BodyId* rightFlipperBody = NULL;
-    physics_init(&game, &bumpers, &leftFlipperBody, &rightFlipperBody);
-    float timeStep = 1.0/60.0;
+    if (physics_init(&game, &bumpers, &leftFlipperBody, &rightFlipperBody) != 0){
+        CloseWindow();
+        return 1;
+    }
 
     TraceLog(LOG_INFO, "PHYSICS INITIALIZED");
 
-    //create balls array
-    Ball* balls = malloc(maxBalls * sizeof(Ball));
-    game.balls = balls;
-    game.numBalls = 0;
-    for (int i = 0; i < maxBalls; i++){
-        balls[i].active = 0;
-    }
+    //create balls array, active list and trail buffers
+    GameStruct_AllocBalls(&game);
 
     // Setup render texture for special ball effect
     RenderTexture2D renderTarget = LoadRenderTexture(screenWidth, screenHeight);
 
+    // The instant replay is drawn full size here, then shown scaled down
+    RenderTexture2D replayTarget = LoadRenderTexture(screenWidth, screenHeight);
+
+    // Background and lane targets, re-baked only when the lane targets change
+    RenderStaticLayer staticLayer;
+    Render_InitStaticLayer(&staticLayer);
+
     // Menu setup
     MenuPinball* menuPinballs = malloc(32 * sizeof(MenuPinball));
 
@@ -104,11 +155,15 @@ int main(void){
     // Setup score system
     ScoreHelper *scores = initScores();
 
-    // Setup timestepping system
-    int timestep = 1000.0/60.0;
-    long long accumulatedTime = 0;
-    long long startTime = millis();
-    long long endTime = millis();
+    // Seed rand() explicitly so recordings can replay it
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+    InputRecorder *recorder = NULL;
+    if (recordPath != NULL){
+        recorder = InputRecorder_Create(recordPath, seed, tickRate, physicsRate, physics_get_quality(&game), mode);
+        TraceLog(LOG_INFO, "Recording input to %s", recordPath);
+    }
+
     long long elapsedTimeStart = millis();
 
     char nameString[6];
@@ -116,6 +171,7 @@ int main(void){
 
     // Initialize game state machine
     Game_Init(&game, bumpers);
+    game.pendingMode = mode;
     
     // Initialize flippers
     physics_flippers_init(&game, leftFlipperBody, rightFlipperBody);
@@ -128,28 +184,77 @@ int main(void){
     Menu_Init(&game, menuPinballs, 32);
 
     inputSetGameState(input,STATE_MENU);
-    TraceLog(LOG_INFO, "START");
 
-    int lastGameState = game.gameState;
+    // Per-tick physics profile, shown with TAB and dumped with --profile
+    PhysicsProfiler *profiler = PhysicsProfiler_Create();
+    physics_set_profiler(&game, profiler);
+
+    StateHashWriter *stateHash = hashPath != NULL ? StateHashWriter_Create(hashPath) : NULL;
+    physics_set_state_hash(&game, stateHash);
+
+    // The benchmark skips the title and menu and drives the ramp from the sim thread
+    StormBench *storm = NULL;
+    if (stormBench && profiler != NULL){
+        stormConfig.megaMultiball = (mode == MODE_MEGA_MULTIBALL);
+        storm = StormBench_Create(&stormConfig);
+    }
+    if (storm != NULL){
+        Game_StartGame(&game, bumpers);
+        game.transitionState = 0;
+        game.transitionTarget = TRANSITION_TO_GAME;
+    }
+
+    // The last ten seconds of play, replayed on the game-over and attract screens
+    RewindBuffer *rewind = RewindBuffer_Create(physicsRate);
+
+    // From here on the sim thread owns game, the world, input and sound;
+    // this thread draws the snapshots it publishes.
+    SimThreadConfig simConfig = {
+        .game = &game,
+        .bumpers = bumpers,
+        .leftFlipperBody = leftFlipperBody,
+        .rightFlipperBody = rightFlipperBody,
+        .powerups = &powerupSystem,
+        .menuPinballs = menuPinballs,
+        .numMenuPinballs = 32,
+        .input = input,
+        .scores = scores,
+        .sound = sound,
+        .water = &waterSystem,
+        .nameString = nameString,
+        .recorder = recorder,
+        .profiler = profiler,
+        .storm = storm,
+        .rewind = rewind,
+        .physicsRate = physicsRate,
+    };
+    SimThread *simThread = SimThread_Start(&simConfig);
+    if (simThread == NULL){
+        CloseWindow();
+        return 1;
+    }
+    TraceLog(LOG_INFO, "START (physics %d Hz, game logic %d Hz)", physicsRate, tickRate);
 
     // Debug draw toggle state
     int debugDrawEnabled = 0;
 
+    // Render thread work per frame, up to EndDrawing (which waits for vsync)
+    float frameMs = 0.0f;
+
     while (!WindowShouldClose()){
-        int prevGameState = lastGameState;
+        long long frameStart = nanos();
+        const SimSnapshot *snapshot = SimThread_AcquireSnapshot(simThread);
+        const GameStruct *view = &snapshot->game;
 
-        endTime = millis();
-        accumulatedTime += (endTime - startTime);
-        startTime = millis();
         shaderSeconds += GetFrameTime() / 2.0f;
         float secondsVec[2] = { shaderSeconds, 0.0f };
         SetShaderValue(resources.swirlShader, resources.swirlSecondsLoc, secondsVec, SHADER_UNIFORM_VEC2);
 
-        // Update water simulation and shader uniforms
-        Water_Update(&waterSystem, &resources, GetFrameTime());
+        // Upload the water simulation (stepped on the sim thread) and shader uniforms
+        Render_UpdateWaterTexture(&snapshot->water, &resources);
         
         // Drive ripple amplitude based on water impact intensity
-        float ampScale = 1.0f + 2.5f * waterSystem.impactIntensity;
+        float ampScale = 1.0f + 2.5f * snapshot->water.impactIntensity;
         float ampXVecCurrent[2] = { ampX * ampScale, 0.0f };
         float ampYVecCurrent[2] = { ampY * ampScale, 0.0f };
         SetShaderValue(resources.swirlShader, resources.swirlAmpXLoc, ampXVecCurrent, SHADER_UNIFORM_VEC2);
@@ -161,280 +266,45 @@ int main(void){
         float ampYVecWater[2] = { ampY * ampScale, 0.0f };
         SetShaderValue(resources.waterShader, resources.waterAmpXLoc, ampXVecWater, SHADER_UNIFORM_VEC2);
         SetShaderValue(resources.waterShader, resources.waterAmpYLoc, ampYVecWater, SHADER_UNIFORM_VEC2);
-        SetShaderValue(resources.waterShader, resources.waterLevelLoc, &game.waterHeight, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(resources.waterShader, resources.waterLevelLoc, &view->waterHeight, SHADER_UNIFORM_FLOAT);
         SetShaderValueTexture(resources.waterShader, resources.waterRippleTexLoc, resources.rippleTexture);
 
-        float mouseX = GetMouseX();
-        float mouseY = GetMouseY();
-
-        // Poll input
-        inputUpdate(input);
-
-        // STEP SIMULATION AT FIXED RATE with safety cap
-        const int MAX_PHYSICS_STEPS_PER_FRAME = 16;
-        int stepCount = 0;
-        while (accumulatedTime > timestep && stepCount < MAX_PHYSICS_STEPS_PER_FRAME){
-            accumulatedTime -= timestep;
-            stepCount++;
-
-            updateSound(sound,&game);
+        // Keyboard and gamepad are read here, on the window thread, for the sim thread's input
+        int keyState, keysPressed;
+        if (inputSampleDevices(&keyState, &keysPressed)){
+            SimThread_QueueKeys(simThread, keyState, keysPressed);
+        }
 
-            // Update game state machine and transitions
-            Game_Update(&game, bumpers, input, scores, sound, timeStep);
+        // F2 cycles the physics quality preset (low / medium / high / adaptive)
+        if (IsKeyPressed(KEY_F2)){
+            PhysicsQuality quality = (snapshot->quality + 1) % PHYSICS_QUALITY_COUNT;
+            SimThread_QueueQuality(simThread, quality);
+            TraceLog(LOG_INFO, "Physics quality: %s", physics_quality_name(quality));
+        }
 
-            // Update menu if in menu state
-            if (game.gameState == 0){
-                Menu_Update(&game, menuPinballs, 32, input, sound);
-            }
-            
-            // Update powerup system
-            float effectiveTimestep = (timeStep) * powerupSystem.slowMotionFactor;
-            Powerups_Update(&game, &powerupSystem, input, sound, effectiveTimestep);
-            if (game.gameState == 1){
-                // Game
-
-                // Clamp effective timestep to a sane, non-zero range to avoid numerical issues.
-                if (effectiveTimestep < (1.0f / 600.0f)) {
-                    effectiveTimestep = 1.0f / 600.0f;
-                }
-                if (effectiveTimestep > (1.0f / 20.0f)) {
-                    effectiveTimestep = 1.0f / 20.0f;
-                }
-                
-                // Update flippers
-                float deltaAngularVelocityLeft = 0.0f;
-                float deltaAngularVelocityRight = 0.0f;
-                physics_flippers_update(&game, leftFlipperBody, rightFlipperBody, input, sound, 
-                                       effectiveTimestep, &deltaAngularVelocityLeft, &deltaAngularVelocityRight);
-
-                physics_step(&game, effectiveTimestep);
-
-                if (game.oldGameScore != game.gameScore){
-                    inputSetScore(input,game.gameScore);
-                    game.oldGameScore = game.gameScore;
-                }
-                
-                // Check powerups before dispensing balls
-                if (game.ballPowerupState == 0 && !bumpers[7].enabled && !bumpers[8].enabled && !bumpers[9].enabled){
-                    // spawn balls
-                    for (int i =0; i < 3; i++){
-                        physics_add_ball(&game,89.5 - ballSize / 2,160 - (i * ballSize),0,-220,1);
-                    }
-                    playBluePowerupSound(sound);
-                    game.bluePowerupOverlay = 1.0f;
-                    game.ballPowerupState = -1;
-                    game.gameScore += 500;
-                    if (game.waterPowerupState == 0){
-                        game.powerupScore += 500;
-                    }
-                } else if (game.ballPowerupState == -1){
-                    // Check if there are no balls left. Then powerup resets and bumpers reset.
-                    if (game.numBalls == 0){
-                        game.ballPowerupState = 0;
-                        bumpers[7].enabled = 1;
-                        bumpers[8].enabled = 1;
-                        bumpers[9].enabled = 1;
-                    }
-                }
-
-                if (game.bumperPowerupState ==0 && !bumpers[4].enabled && !bumpers[5].enabled && !bumpers[6].enabled){
-                    // spawn bumpers
-                    game.bumperPowerupState = -1;
-                    bumpers[10].enabled = 1;
-                    bumpers[11].enabled = 1;
-                    bumpers[12].enabled = 1;
-                    bumpers[13].enabled = 1;
-                    playRedPowerupSound(sound);
-                    game.redPowerupOverlay = 1.0f;
-                    game.gameScore += 500;
-                    if (game.waterPowerupState == 0){
-                        game.powerupScore += 500;
-                    }
-                } else if (game.bumperPowerupState == -1){
-                    if (!bumpers[10].enabled && !bumpers[11].enabled && !bumpers[12].enabled && !bumpers[13].enabled){
-                        game.bumperPowerupState = 0;
-                        bumpers[4].enabled = 1;
-                        bumpers[5].enabled = 1;
-                        bumpers[6].enabled = 1;
-                        game.redPowerupOverlay = 1.0f;
-                    }
-                }
-
-                if (game.numBalls == 0){
-                    if (game.numLives >= 1){
-                        if (inputCenterPressed(input)){
-                            physics_add_ball(&game,89.5 - ballSize / 2,160,0,-220,0);
-                            // Center button strobes 5 times when ball is launched
-                            inputSetButtonLED(input, BUTTON_LED_CENTER, LED_MODE_STROBE, 255, 255, 0, 5);  // Yellow strobe
-                        }
-                    } else {
-                        // game over condition
-                        if (game.transitionState == 0){
-                            game.transitionState = 1;
-                            game.transitionTarget = TRANSITION_GAME_OVER;
-                            inputSetGameState(input,STATE_GAME_OVER);
-                        }
-                    }
-                }
-
-                if (IsMouseButtonPressed(0)){
-                    physics_add_ball(&game,(mouseX) * screenToWorld,(mouseY) * screenToWorld,0,0,1);
-                }
-
-                // Check if any balls have fallen outside the screen
-                // Remove them if they have.
-                // Check if any balls are standing still for too long and remove.
-                for (int i = 0; i < maxBalls; i++){
-                    if (balls[i].active == 1){
-                        b2Vec2 pos = b2Body_GetPosition(balls[i].body);
-                        b2Vec2 vel = b2Body_GetLinearVelocity(balls[i].body);
-                        float velLengthSq = vel.x * vel.x + vel.y * vel.y;
-                        if (velLengthSq < 0.01f){
-                            balls[i].killCounter++;
-                        } else {
-                            balls[i].killCounter=0;
-                        }
-                        // Reset kill counter near flippers
-                        if (pos.y > 118){
-                            balls[i].killCounter=0;
-                        }
-                        if (pos.y > 170+ballSize || balls[i].killCounter > 100){
-                            balls[i].active = 0;
-                            b2DestroyBody(balls[i].body);
-                            game.numBalls--;
-                            //Check number of lives and send to score if necessary
-                            if (game.numBalls == 0){
-                                if (game.numLives >= 1){
-                                    game.numLives -= 1;
-                                    inputSetNumBalls(input,game.numLives);
-                                }
-                            }
-                        }
-                    }
-                }
-
-                //Update ball trails
-                for (int i = 0; i < maxBalls; i++){
-                    if (balls[i].active == 1){
-                        b2Vec2 pos = b2Body_GetPosition(balls[i].body);
-                        balls[i].locationHistoryX[balls[i].trailStartIndex] = pos.x;
-                        balls[i].locationHistoryY[balls[i].trailStartIndex] = pos.y;
-                        balls[i].trailStartIndex = (balls[i].trailStartIndex + 1) % 16;
-                    }
-                }
-
-                //handler lower bumpers
-                if (leftLowerBumperAnim > 0.0f){
-                    leftLowerBumperAnim -= 0.05f;
-                    if (leftLowerBumperAnim < 0.0f){
-                        leftLowerBumperAnim = 0.0f;
-                    }
-                }
-                if (rightLowerBumperAnim > 0.0f){
-                    rightLowerBumperAnim -= 0.05f;
-                    if (rightLowerBumperAnim < 0.0f){
-                        rightLowerBumperAnim = 0.0f;
-                    }
-                }
-
-                // Update water height based on powerup state
-                if (game.waterPowerupState == 1){
-                    game.waterHeight += 0.006f * powerupSystem.slowMotionFactor;
-                    if (game.waterHeight > game.waterHeightTarget){
-                        game.waterHeight = game.waterHeightTarget;
-                    }
-                } else if (game.waterPowerupState == 2) {
-                    game.waterHeight -= 0.0005f * powerupSystem.slowMotionFactor;
-                    if (game.waterHeight < 0.0f){
-                        game.waterHeight = 0.0f;
-                        game.waterPowerupState = 0;
-                    }
-                }
-
-                if (game.waterHeightTimer > 0.0f){
-                    game.waterHeightTimer -= 1.0f * powerupSystem.slowMotionFactor;
-                    if (game.waterHeightTimer <= 0.0f){
-                        game.waterHeightTarget = 0.0f;
-                        game.waterPowerupState = 2;
-                        printf("water timer runout\n");
-                    }
-                }
-
-                // If water height powerup active, apply buoyancy forces to balls.
-                if (game.waterHeight > 0){
-                    float waterY = worldHeight * (1.0f - game.waterHeight);
-
-                    for (int i = 0; i < maxBalls; i++){
-                        if (balls[i].active == 1){
-                            b2Vec2 pos = b2Body_GetPosition(balls[i].body);
-                            b2Vec2 vel = b2Body_GetLinearVelocity(balls[i].body);
-                            if (pos.y > waterY){
-                                float distUnderwater = fabs(waterY - pos.y);
-                                float bVely = -200.0f + -(distUnderwater * 40.0f);
-                                b2Vec2 force = {0, bVely};
-                                b2Body_ApplyForceToCenter(balls[i].body, force, true);
-                                // Apply special forces for flipper
-                                float flipperForce = -1000.0f;
-                                if (pos.x <= worldWidth / 2.0f && fabsf(deltaAngularVelocityLeft) > 0){
-                                    b2Vec2 flipForce = {0, flipperForce};
-                                    b2Body_ApplyForceToCenter(balls[i].body, flipForce, true);
-                                }
-                                if (pos.x >= worldWidth / 2.0f && fabsf(deltaAngularVelocityRight) > 0){
-                                    b2Vec2 flipForce = {0, flipperForce};
-                                    b2Body_ApplyForceToCenter(balls[i].body, flipForce, true);
-                                }
-                                if (balls[i].underwaterState == 0){
-                                    playWaterSplash(sound);
-                                    balls[i].underwaterState = 1;
-
-                                    // Kick the water ripple intensity on splash so the shader waves react
-                                    waterSystem.impactIntensity += 0.6f;
-                                    if (waterSystem.impactIntensity > 1.5f) {
-                                        waterSystem.impactIntensity = 1.5f;
-                                    }
-                                }
-                            } else {
-                                balls[i].underwaterState = 0;
-                            }
-                        }
-                    }
-
-                }
-            }
-            if (game.gameState == 2){
-                // Game over - delegate to scoreboard update
-                Scoreboard_Update(&game, input, scores, nameString);
-            }
+        if (view->gameState == 1 && IsMouseButtonPressed(0)){
+            SimThread_QueueSpawn(simThread, GetMouseX() * screenToWorld, GetMouseY() * screenToWorld);
         }
 
-        // Check if physics fell behind and clamp accumulated time
-        if (stepCount == MAX_PHYSICS_STEPS_PER_FRAME && accumulatedTime > timestep) {
-            TraceLog(LOG_WARNING,
-                     "Physics fell behind: accumulatedTime=%lld, clamping",
-                     accumulatedTime);
-            accumulatedTime = 0;
+        // Fraction of a physics step since the snapshot was published, for render interpolation
+        float renderAlpha = (float)((nanos() - snapshot->publishNanos) * SimThread_GetPhysicsRate(simThread)) / 1e9f;
+        if (renderAlpha > 1.0f){
+            renderAlpha = 1.0f;
         }
 
-        // If the high-level game state changed this frame, notify the Pico so it can
-        // update button LED baselines (menu, gameplay, game over patterns).
-        if (game.gameState != prevGameState) {
-            switch (game.gameState) {
-                case 0:
-                    // Menu state
-                    inputSetGameState(input, STATE_MENU);
-                    break;
-                case 1:
-                    // Gameplay state
-                    inputSetGameState(input, STATE_GAME);
-                    break;
-                case 2:
-                    // Game over / scoreboard state
-                    inputSetGameState(input, STATE_GAME_OVER);
-                    break;
-                default:
-                    break;
-            }
-            lastGameState = game.gameState;
+        // Re-bake the static layer if a lane target changed. Outside any
+        // texture mode, like the replay below.
+        Render_UpdateStaticLayer(&staticLayer, &resources, snapshot->bumpers, numBumpers);
+
+        // Instant replay of the last drain on the game-over and attract screens.
+        // Drawn first: raylib texture modes do not nest.
+        int showReplay = snapshot->replayFrames > 0 &&
+                         (view->gameState == 2 || (view->gameState == 0 && view->menuState == 0));
+        if (showReplay){
+            BeginTextureMode(replayTarget);
+            Render_Gameplay(&snapshot->replay, &resources, snapshot->bumpers, numBumpers, &staticLayer,
+                            shaderSeconds, 0.0f, 0, elapsedTimeStart, 1.0f);
+            EndTextureMode();
         }
 
         // RENDER AT SPEED GOVERNED BY RAYLIB
@@ -442,27 +312,39 @@ int main(void){
         BeginTextureMode(gameTarget);
         ClearBackground(BLACK);   // or whatever your default background is
 
-        if (game.gameState == 0){
-            // Menu
-            UI_DrawMenu(&game, &resources, menuPinballs, 16, scores, elapsedTimeStart, shaderSeconds);
+        if (view->gameState == 0){
+            // Menu. Scores are only submitted in the game-over state, so the
+            // sim thread never writes them while the menu reads them.
+            UI_DrawMenu(view, &resources, snapshot->menuPinballs, 16, scores, elapsedTimeStart, shaderSeconds);
         }
-        if (game.gameState == 1){
-            // Game
-            Render_Gameplay(&game, &resources, bumpers, numBumpers, 
-                        *leftFlipperBody, *rightFlipperBody,
-                        shaderSeconds, powerupSystem.iceOverlayAlpha, 
-                        debugDrawEnabled, elapsedTimeStart);
+        if (view->gameState == 1){
+            // Game (debug draw walks the live world, so the sim thread is held meanwhile)
+            if (debugDrawEnabled){
+                SimThread_LockWorld(simThread);
+            }
+            Render_Gameplay(view, &resources, snapshot->bumpers, numBumpers, &staticLayer,
+                        shaderSeconds, snapshot->powerups.iceOverlayAlpha, 
+                        debugDrawEnabled, elapsedTimeStart, renderAlpha);
+            if (debugDrawEnabled){
+                SimThread_UnlockWorld(simThread);
+            }
+            if (IsKeyDown(KEY_TAB)){
+                Render_ProfileOverlay(&snapshot->profile, &snapshot->profilePeak, frameMs);
+            }
         }
-        if (game.gameState == 2){
+        if (view->gameState == 2){
             // Game Over
-            UI_DrawGameOver(&game, &resources, menuPinballs, 16, nameString, elapsedTimeStart, shaderSeconds);
+            UI_DrawGameOver(view, &resources, snapshot->menuPinballs, 16, snapshot->nameString, elapsedTimeStart, shaderSeconds);
         }
-        if (game.gameState == 5){
+        if (showReplay){
+            UI_DrawReplay(&resources, replayTarget.texture, snapshot->replayFrame, snapshot->replayFrames);
+        }
+        if (view->gameState == 5){
             ClearBackground(WHITE);
         }
 
         // Draw transition overlay if active (still in virtual space)
-        UI_DrawTransition(&game, shaderSeconds);
+        UI_DrawTransition(view, shaderSeconds);
 
         EndTextureMode();
 
@@ -496,22 +378,46 @@ int main(void){
             WHITE
         );
 
+        frameMs = (float)(nanos() - frameStart) / 1e6f;
         EndDrawing();
+
+        if (storm != NULL){
+            StormBench_AddFrame(storm, snapshot->stormStage, frameMs);
+            if (snapshot->stormFinished){
+                break;
+            }
+        }
     }
 
+    SimThread_Stop(simThread);
+    RewindBuffer_Destroy(rewind);
+    int exitCode = 0;
+    if (storm != NULL){
+        exitCode = StormBench_Finish(storm, baselinePath, writeBaseline, tolerance);
+        StormBench_Destroy(storm);
+    }
+    InputRecorder_Close(recorder);
+    physics_set_state_hash(&game, NULL);
+    StateHashWriter_Close(stateHash);
+    physics_set_profiler(&game, NULL);
+    if (profilePath != NULL && profiler != NULL){
+        PhysicsProfiler_Write(profiler, profilePath);
+    }
+    PhysicsProfiler_Destroy(profiler);
     shutdownScores(scores);
     inputShutdown(input);
     shutdownSound(sound);
     physics_shutdown(&game);
     
     // Unload all resources
+    Render_UnloadStaticLayer(&staticLayer);
     Resources_Unload(&resources);
     
     // Free allocated memory
-    free(game.balls);
+    GameStruct_FreeBalls(&game);
     free(menuPinballs);
     
     CloseWindow();
 
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
@@ -44,6 +44,10 @@ void Menu_Update(GameStruct *game,
     }
     if (inputLeftPressed(input)) {
         playClick(sound);
+        if (game->menuState == 1) {
+            // Left again on the controls page cycles the game mode
+            game->pendingMode = (game->pendingMode + 1) % MODE_COUNT;
+        }
         game->menuState = 1;
     }
     if (inputRightPressed(input)) {
@@ -2,13 +2,17 @@
  * physics.c - Box2D 3.x Physics Implementation (Migrated from Chipmunk)
  *
  * Responsibilities:
- *  - Owns all Box2D physics setup for the pinball table (world, walls, bumpers, flippers).
- *  - Registers Box2D collision handlers and applies their side effects (score, powerups, SFX).
+ *  - Owns all Box2D physics setup for the pinball table (world, walls, bumpers, flippers),
+ *    built from a TableLayout (tableLayout.h) loaded from game->tablePath.
+ *  - Registers Box2D collision handlers and applies their side effects (score, powerups, SFX)
+ *    from a post-step event queue.
  *  - Provides a small API used by the rest of the game via physics.h:
  *      - physics_init      : one-time setup for a GameStruct.
  *      - physics_step      : advance the simulation by dt.
  *      - physics_shutdown  : destroy the Box2D world for a GameStruct.
  *      - physics_add_ball  : spawn a new ball with initial position and velocity.
+ *      - physics_remove_ball: destroy a ball and drop it from the active list.
+ *      - physics_set_quality: choose sub-stepping / CCD quality preset.
  *
  * Collision Category Mapping (Chipmunk → Box2D):
  * ===============================================
@@ -31,78 +35,121 @@
  *   - CATEGORY_LEFT_LOWER_BUMPER   = (1 << 4) = 0x0010
  *   - CATEGORY_RIGHT_LOWER_BUMPER  = (1 << 5) = 0x0020
  *   - CATEGORY_ONE_WAY             = (1 << 6) = 0x0040
+ *   - CATEGORY_WATER               = (1 << 7) = 0x0080 (no Chipmunk equivalent)
  * 
- * All collision logic from physics_old.c is implemented in PreSolveCallback().
- * See the detailed comment above PreSolveCallback for handler-by-handler mapping.
+ * Collision logic from physics_old.c is split between PreSolveCallback() (which
+ * contacts are solid) and physics_drain_events() (score, sound, animation).
+ * See the mapping comment above physics_award_score for handler-by-handler details.
  *
  * Notes for future maintenance:
  *  - Keep Box2D-specific details (b2WorldId, b2ShapeId, b2BodyId, collision callbacks) inside this file.
  *  - If you change the maximum number of balls or walls, update both this file and any matching
  *    configuration in constants.h / GameStruct so the array sizes stay in sync.
- *  - Prefer configuring tunable values (gravity, bumper positions, sizes, bounciness) via constants.h
- *    or a table at the top of this file rather than hardcoding them inline.
+ *  - Table geometry and materials (walls, bumper positions, sizes, bounciness) live in the
+ *    table file / TableLayout_BuildDefault; other tunables belong in constants.h or a table
+ *    at the top of this file rather than hardcoded inline.
  *  - Contact return values: return true to allow collision, return false to disable (make "ghost").
  */
 
 #include "physics.h"
 #include "constants.h"
 #include "soundManager.h"
-#include "physicsDebugDraw.h"
+#include "water.h"
+#include "taskPool.h"
+#include "tableLayout.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include <box2d/box2d.h>
 
 #define DEG_TO_RAD (3.14159265 / 180.0)
 
-// External function from main.c for water ripple impacts
-extern void AddWaterImpulse(float x, float impulse);
+// Table segments (and arc steps) shorter than this are skipped when building the
+// world: Box2D rejects them, and the old fixed-size wall array was padded with
+// zero-length entries.
+static const float minSegmentLength = 0.01f;
 
-// Local geometry/limit constants for this module.
-//
-// numWalls   : number of static wall segments we create in physics_init().
-// maxBalls   : must match the size of game->balls allocated/owned by GameStruct.
-// ballSize   : default ball diameter (in world units) for type==0 balls.
-//              If this changes, make sure any rendering code that assumes the
-//              same size is updated as well.
-// numBumpers : number of bumpers we create in physics_init().
-static const int   numWalls   = 128;
+/* -------------------------------------------------------------------------- */
+/*  Solver quality presets                                                    */
+/* -------------------------------------------------------------------------- */
 
 /*
- * BumperType:
- *  - Encodes gameplay semantics for bumpers so we avoid magic numbers.
- *  - Values must stay in sync with any rendering/UI code that branches on bumper->type.
+ * Balls leave the plunger at 220 units/s and a flipper tip moves at roughly
+ * flipperSpeed (900 deg/s) * flipperWidth = ~300 units/s, i.e. 4-5 units per
+ * 60 Hz step against 1-unit walls and a 5-unit ball. Sub-steps and the bullet
+ * flag (continuous collision against the kinematic flippers) keep that from
+ * tunneling; ADAPTIVE only pays for them while something is moving fast.
  */
-typedef enum {
-    BUMPER_TYPE_STANDARD      = 0,  // Upper playfield round bumpers (score + powerup meter)
-    BUMPER_TYPE_SLOW_MOTION   = 1,  // Special bumper that triggers slow motion + big score
-    BUMPER_TYPE_LANE_TARGET_A = 2,  // Lane/target bumpers, group A
-    BUMPER_TYPE_LANE_TARGET_B = 3,  // Lane/target bumpers, group B
-    BUMPER_TYPE_WATER_POWERUP = 4   // Small bumpers that enable water powerup
-} BumperType;
+typedef struct {
+    int   subSteps;       // Box2D sub-steps per step (max for ADAPTIVE)
+    int   bullets;        // mark balls as bullets (CCD vs kinematic/dynamic bodies)
+    float contactHertz;   // contact stiffness, Box2D clamps to 1/4 of the sub-step rate
+} PhysicsQualityPreset;
+
+static const PhysicsQualityPreset qualityPresets[PHYSICS_QUALITY_COUNT] = {
+    [PHYSICS_QUALITY_LOW]      = { 1, 0, 30.0f },
+    [PHYSICS_QUALITY_MEDIUM]   = { 4, 1, 30.0f },
+    [PHYSICS_QUALITY_HIGH]     = { 8, 1, 60.0f },
+    [PHYSICS_QUALITY_ADAPTIVE] = { 8, 1, 30.0f }
+};
+
+static const char *qualityNames[PHYSICS_QUALITY_COUNT] = {
+    "low", "medium", "high", "adaptive"
+};
+
+// Box2D defaults for the remaining contact tuning parameters
+static const float contactDampingRatio = 10.0f;
+static const float contactPushSpeed    = 3.0f;
+
+// Adaptive mode: allow the fastest ball to travel at most this fraction of its
+// radius per sub-step before adding another sub-step.
+static const float adaptiveTravelPerSubStep = 0.5f;
 
 
 /* -------------------------------------------------------------------------- */
-/*  Local animation state (driven by collision handlers, read by renderer)    */
+/*  Box2D worker threads                                                      */
 /* -------------------------------------------------------------------------- */
 
-// These variables are accessed by main.c for rendering lower bumper animations
-// They are set to 1.0f when a collision occurs and decremented in main.c
-float leftLowerBumperAnim  = 0.0f;
-float rightLowerBumperAnim = 0.0f;
+static void *physics_enqueue_task(b2TaskCallback *task, int itemCount, int minRange,
+                                  void *taskContext, void *userContext) {
+    return TaskPool_EnqueueTask((TaskPool *)userContext, task, itemCount, minRange, taskContext);
+}
+
+static void physics_finish_task(void *userTask, void *userContext) {
+    TaskPool_FinishTask((TaskPool *)userContext, userTask);
+}
 
 /* -------------------------------------------------------------------------- */
-/*  Debug draw state - stores references to bodies and shapes for rendering  */
+/*  Ball body pools                                                           */
 /* -------------------------------------------------------------------------- */
 
+/*
+ * Ball bodies are created once in physics_init, disabled, and parked in a
+ * pool per radius. physics_add_ball enables one and physics_remove_ball
+ * disables it again, so spawning and draining balls never creates or destroys
+ * Box2D bodies mid-tick.
+ */
+typedef struct {
+    b2BodyId body;
+    b2ShapeId shape;
+} PooledBallBody;
+
+typedef struct {
+    PooledBallBody *free;   // stack of disabled bodies
+    int freeCount;
+    float radius;
+} BallBodyPool;
+
+// physics_apply_buoyancy's working arrays, maxBalls entries each
 typedef struct {
-    b2BodyId staticBody;      // The main static body holding all walls
-    b2BodyId *leftFlipper;    // Left flipper body pointer
-    b2BodyId *rightFlipper;   // Right flipper body pointer
-    Bumper *bumpers;          // Pointer to bumpers array
-    int numBumpers;           // Number of bumpers
-} PhysicsDebugState;
+    int *slot;          // game->balls index of each underwater ball
+    float *posX;
+    float *posY;
+    float *forceY;
+} BuoyancyScratch;
 
-static PhysicsDebugState debugState = {0};
+static const int largeBallPoolSize = 8;
 
 /* -------------------------------------------------------------------------- */
 /*  Helper function to create a b2Vec2                                        */
@@ -113,193 +160,438 @@ static inline b2Vec2 pb2_v(float x, float y) {
 }
 
 /* -------------------------------------------------------------------------- */
-/*  Box2D 3.x Contact Event Handlers                                          */
+/*  Shape tags                                                                */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Every shape we create stores a small integer tag in its userData instead of
+ * a pointer: (kind << 16) | index, where index is the slot in game->balls or
+ * game->bumpers. Ball bodies carry the same tag so body move events can be
+ * mapped back to their ball; other bodies leave userData NULL
+ * (SHAPE_KIND_NONE).
+ *
+ * PreSolveCallback runs inside the solver (possibly on Box2D worker threads),
+ * so it only decodes tags and reads state; it never writes.
+ */
+typedef enum {
+    SHAPE_KIND_NONE        = 0,
+    SHAPE_KIND_WALL        = 1,
+    SHAPE_KIND_BALL        = 2,
+    SHAPE_KIND_BUMPER      = 3,
+    SHAPE_KIND_PADDLE      = 4,
+    SHAPE_KIND_LEFT_SLING  = 5,
+    SHAPE_KIND_RIGHT_SLING = 6,
+    SHAPE_KIND_ONE_WAY     = 7,
+    SHAPE_KIND_WATER       = 8
+} ShapeKind;
+
+static inline void *shape_tag(ShapeKind kind, int index) {
+    return (void *)(uintptr_t)(((uint32_t)kind << 16) | ((uint32_t)index & 0xFFFFu));
+}
+
+static inline ShapeKind tag_kind(void *tag) {
+    return (ShapeKind)((uintptr_t)tag >> 16);
+}
+
+static inline int tag_index(void *tag) {
+    return (int)((uintptr_t)tag & 0xFFFFu);
+}
+
+static inline ShapeKind shape_tag_kind(b2ShapeId shapeId) {
+    return tag_kind(b2Shape_GetUserData(shapeId));
+}
+
+static inline int shape_tag_index(b2ShapeId shapeId) {
+    return tag_index(b2Shape_GetUserData(shapeId));
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Post-step gameplay event queue                                            */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Gameplay side effects (score, sound, bumper/slingshot animation, flipper
+ * kill-counter reset) are recorded from Box2D's begin-touch contact and sensor
+ * events after b2World_Step and applied once per touch by physics_drain_events.
+ */
+typedef enum {
+    PHYSICS_EVENT_BUMPER_HIT,   // ball started touching bumper `target`
+    PHYSICS_EVENT_LEFT_SLING,   // ball hit the left lower slingshot
+    PHYSICS_EVENT_RIGHT_SLING,  // ball hit the right lower slingshot
+    PHYSICS_EVENT_PADDLE,       // ball started touching a flipper
+    PHYSICS_EVENT_PADDLE_END,   // ball stopped touching a flipper
+    PHYSICS_EVENT_WATER_ENTER,  // ball center went below the water surface
+    PHYSICS_EVENT_WATER_EXIT    // ball center came back above it
+} PhysicsEventType;
+
+typedef struct {
+    uint8_t  type;      // PhysicsEventType
+    uint16_t ball;      // index into game->balls
+    uint16_t target;    // index into game->bumpers (PHYSICS_EVENT_BUMPER_HIT only)
+    b2ShapeId shape;    // the ball's shape (PHYSICS_EVENT_PADDLE_END / _WATER_EXIT only)
+} PhysicsEvent;
+
+// Must be a power of two. One step with 256 balls produces far fewer begin events.
+#define PHYSICS_EVENT_CAPACITY 1024
+
+/* -------------------------------------------------------------------------- */
+/*  Per-world state                                                           */
 /* -------------------------------------------------------------------------- */
 
+/*
+ * Everything physics.c keeps about one world. physics_init allocates it into
+ * game->physics and physics_shutdown frees it, so several GameStructs can be
+ * simulated side by side (one thread each, see tableInstance.h).
+ */
+struct PhysicsContextObject {
+    PhysicsDebugState debugState;   // bodies for the debug renderer
+    PhysicsQuality quality;
+    int lastSubSteps;
+    TaskPool *taskPool;             // from game->physicsWorkers
+    PhysicsProfiler *profiler;      // optional, see physics_set_profiler
+    StateHashWriter *stateHash;     // optional, see physics_set_state_hash
+
+    BallBodyPool normalBallPool;    // type 0 / 1 balls, maxBalls bodies
+    BallBodyPool largeBallPool;     // type 2 balls
+    BuoyancyScratch buoyancy;
+    int ballCollisions;             // balls collide with each other (physics_set_ball_collisions)
+
+    PhysicsEvent eventRing[PHYSICS_EVENT_CAPACITY];
+    unsigned int eventHead;         // next slot to read
+    unsigned int eventTail;         // next slot to write
+    long droppedEvents;
+
+    b2ShapeId waterSensorShape;
+    float waterSensorHeight;        // waterHeight the box was last sized for
+
+    b2BodyId leftFlipperBody;
+    b2BodyId rightFlipperBody;
+    float leftFlipperAngle;         // degrees
+    float rightFlipperAngle;
+};
+
+static void physics_push_event(PhysicsContext *ctx, PhysicsEventType type, int ball, int target) {
+    if (ctx->eventTail - ctx->eventHead >= PHYSICS_EVENT_CAPACITY) {
+        ctx->droppedEvents++;
+        return;
+    }
+    PhysicsEvent *ev = &ctx->eventRing[ctx->eventTail & (PHYSICS_EVENT_CAPACITY - 1)];
+    ev->type = (uint8_t)type;
+    ev->ball = (uint16_t)ball;
+    ev->target = (uint16_t)target;
+    ev->shape = b2_nullShapeId;
+    ctx->eventTail++;
+}
+
+/*
+ * physics_push_end_event
+ *  - Queues an end-touch event for the ball owning ballShape.
+ *  - End events can arrive for a body that was parked in the step before,
+ *    after its ball slot went to a new ball; the shape id lets
+ *    physics_drain_events tell the two apart.
+ */
+static void physics_push_end_event(PhysicsContext *ctx, PhysicsEventType type, b2ShapeId ballShape) {
+    unsigned int tail = ctx->eventTail;
+    physics_push_event(ctx, type, shape_tag_index(ballShape), 0);
+    if (ctx->eventTail != tail) {
+        ctx->eventRing[tail & (PHYSICS_EVENT_CAPACITY - 1)].shape = ballShape;
+    }
+}
+
 /*
  * COLLISION HANDLER MAPPING: Chipmunk (physics_old.c) → Box2D (physics.c)
  * =========================================================================
- * 
- * This PreSolveCallback implements all collision logic from physics_old.c.
- * Each Chipmunk collision handler is mapped to a branch in this function.
- * 
+ *
  * Category Bits → Gameplay Entities:
  * ----------------------------------
  * CATEGORY_WALL                (0x0001) : Static walls, boundaries
  * CATEGORY_BALL                (0x0002) : Player balls
- * CATEGORY_BUMPER              (0x0004) : All bumpers (type determined by userData)
+ * CATEGORY_BUMPER              (0x0004) : All bumpers (type determined by bumper->type)
  * CATEGORY_PADDLE              (0x0008) : Flippers
  * CATEGORY_LEFT_LOWER_BUMPER   (0x0010) : Left slingshot
  * CATEGORY_RIGHT_LOWER_BUMPER  (0x0020) : Right slingshot
  * CATEGORY_ONE_WAY             (0x0040) : Shooter lane gate
- * 
- * Chipmunk Handler → Box2D Branch Mapping:
- * ----------------------------------------
+ * CATEGORY_WATER               (0x0080) : Water powerup surface (sensor)
+ *
+ * Chipmunk Handler → Box2D:
+ * -------------------------
  * CollisionHandlerBallBumper (BEGIN)
- *   → if (otherCategory == CATEGORY_BUMPER)
- *   → Returns cpTrue for elastic bounce or cpFalse to disable contact
- *   → Box2D: return true for elastic, return false to disable
- * 
+ *   → Standard / water powerup bumpers: solid shapes. PreSolveCallback keeps the
+ *     contact (water powerup only while enabled); effects from the begin-touch event.
+ *   → Slow-motion / lane target bumpers never bounce (cpFalse in Chipmunk), so
+ *     they are sensor shapes; effects from the sensor begin event.
+ *
  * CollisionHandlerBallFlipper (PRESOLVE)
- *   → if (otherCategory == CATEGORY_PADDLE)
- *   → Returns cpTrue, clears ball->killCounter
- *   → Box2D: return true, clears ball->killCounter
- * 
- * CollisionHandlerLeftLowerBumper (BEGIN)
- *   → if (otherCategory == CATEGORY_LEFT_LOWER_BUMPER)
- *   → Returns cpTrue, sets leftLowerBumperAnim, awards 25 points
- *   → Box2D: return true, same side effects
- * 
- * CollisionHandlerRightLowerBumper (BEGIN)
- *   → if (otherCategory == CATEGORY_RIGHT_LOWER_BUMPER)
- *   → Returns cpTrue, sets rightLowerBumperAnim, awards 25 points
- *   → Box2D: return true, same side effects
- * 
+ *   → Contact kept. While a ball touches a flipper its body may not sleep, so
+ *     it never counts as stuck (begin / end-touch events, physics_drain_events).
+ *
+ * CollisionHandlerLeftLowerBumper / CollisionHandlerRightLowerBumper (BEGIN)
+ *   → Contact kept; game->leftLowerBumperAnim / rightLowerBumperAnim, 25 points and
+ *     sound on begin-touch.
+ *
  * CollisionOneWay (PRESOLVE)
- *   → if (otherCategory == CATEGORY_ONE_WAY)
- *   → Uses cpvdot(cpArbiterGetNormal(arb), cpv(0,1)) to check direction
- *   → Returns cpArbiterIgnore(arb) if dot < 0 (pass through), cpTrue if >= 0 (block)
- *   → Box2D: return false if normal dot (0,1) < 0, return true otherwise
+ *   → PreSolveCallback: disable if normal dot (0,1) < 0, keep otherwise.
  *   → CRITICAL: Must account for contact normal direction (depends on shape order)
  */
 
 /*
- * Box2D 3.x uses a custom PreSolve callback function.
- * This function is called for each contact before the solver.
- * We use it to implement collision logic and optionally disable contacts.
+ * physics_award_score
+ *  - Adds points to the game score and, outside the water powerup, to the
+ *    powerup meter.
  */
-static bool PreSolveCallback(b2ShapeId shapeIdA, b2ShapeId shapeIdB, b2Manifold* manifold, void* context) {
-    // Get the collision category bits to identify what's colliding
-    b2Filter filterA = b2Shape_GetFilter(shapeIdA);
-    b2Filter filterB = b2Shape_GetFilter(shapeIdB);
-    
-    uint32_t catA = filterA.categoryBits;
-    uint32_t catB = filterB.categoryBits;
-    
-    // Identify the ball and the other object
-    b2ShapeId ballShapeId = b2_nullShapeId;
-    b2ShapeId otherShapeId = b2_nullShapeId;
-    uint32_t otherCategory = 0;
-    
-    if (catA == CATEGORY_BALL) {
-        ballShapeId = shapeIdA;
-        otherShapeId = shapeIdB;
-        otherCategory = catB;
-    } else if (catB == CATEGORY_BALL) {
-        ballShapeId = shapeIdB;
-        otherShapeId = shapeIdA;
-        otherCategory = catA;
+static void physics_award_score(GameStruct *game, int points) {
+    game->gameScore += points;
+    if (game->waterPowerupState == 0) {
+        game->powerupScore += points;
+    }
+}
+
+/*
+ * physics_apply_bumper_hit
+ *  - Score, sound and animation for a ball reaching a bumper.
+ */
+static void physics_apply_bumper_hit(GameStruct *game, Bumper *bumper) {
+    if (bumper->type == BUMPER_TYPE_STANDARD) {
+        bumper->bounceEffect = 10.0f;
+        physics_award_score(game, 50);
+        playUpperBouncerSound(game->sound);
+    } else if (bumper->type == BUMPER_TYPE_SLOW_MOTION) {
+        // Slow-motion bumper: single-use powerup with cooldown
+        if (game->slowMoPowerupAvailable == 1) {
+            game->slowMotion = 1;
+            game->slowMotionCounter = 1200;
+            physics_award_score(game, 1000);
+            playSlowdownSound(game->sound);
+
+            // Mark powerup as unavailable and start explosion effect
+            game->slowMoPowerupAvailable = 0;
+            game->slowMoExplosionEffect = 1.0f;
+
+            // Show bounce effect only when powerup is triggered
+            bumper->bounceEffect = 20.0f;
+        }
+    } else if (bumper->type == BUMPER_TYPE_LANE_TARGET_A ||
+               bumper->type == BUMPER_TYPE_LANE_TARGET_B) {
+        // Lane target bumpers: score once when enabled
+        if (bumper->enabled == 1) {
+            physics_award_score(game, 50);
+            bumper->enabled = 0;
+            playBounce(game->sound);
+        }
+    } else if (bumper->type == BUMPER_TYPE_WATER_POWERUP) {
+        if (bumper->enabled == 1) {
+            bumper->bounceEffect = 10.0f;
+            physics_award_score(game, 250);
+            bumper->enabled = 0;
+            playBounce(game->sound);
+        }
     } else {
-        // Neither is a ball, allow collision
-        return true;
+        // Fallback: simple one-shot scoring bumper
+        physics_award_score(game, 25);
+        bumper->enabled = 0;
     }
-    
-    // Get ball user data
-    Ball *ball = (Ball *)b2Shape_GetUserData(ballShapeId);
-    if (!ball) {
-        return true;
+}
+
+/*
+ * physics_collect_events
+ *  - Converts this step's begin-touch contact and sensor events into queued
+ *    PhysicsEvents. Called once after b2World_Step.
+ */
+static void physics_collect_events(GameStruct *game) {
+    b2ContactEvents contactEvents = b2World_GetContactEvents(game->world);
+    for (int i = 0; i < contactEvents.beginCount; i++) {
+        b2ShapeId shapeA = contactEvents.beginEvents[i].shapeIdA;
+        b2ShapeId shapeB = contactEvents.beginEvents[i].shapeIdB;
+        if (!b2Shape_IsValid(shapeA) || !b2Shape_IsValid(shapeB)) {
+            continue;
+        }
+
+        b2ShapeId ballShape = shapeA;
+        b2ShapeId otherShape = shapeB;
+        if (shape_tag_kind(shapeB) == SHAPE_KIND_BALL) {
+            ballShape = shapeB;
+            otherShape = shapeA;
+        } else if (shape_tag_kind(shapeA) != SHAPE_KIND_BALL) {
+            continue;
+        }
+
+        int ball = shape_tag_index(ballShape);
+        switch (shape_tag_kind(otherShape)) {
+            case SHAPE_KIND_BUMPER:
+                physics_push_event(game->physics, PHYSICS_EVENT_BUMPER_HIT, ball, shape_tag_index(otherShape));
+                break;
+            case SHAPE_KIND_PADDLE:
+                physics_push_event(game->physics, PHYSICS_EVENT_PADDLE, ball, 0);
+                break;
+            case SHAPE_KIND_LEFT_SLING:
+                physics_push_event(game->physics, PHYSICS_EVENT_LEFT_SLING, ball, 0);
+                break;
+            case SHAPE_KIND_RIGHT_SLING:
+                physics_push_event(game->physics, PHYSICS_EVENT_RIGHT_SLING, ball, 0);
+                break;
+            default:
+                break;
+        }
     }
-    
-    // Handle different collision types
-    if (otherCategory == CATEGORY_BUMPER) {
-        // Ball-Bumper collision
-        Bumper *bumper = (Bumper *)b2Shape_GetUserData(otherShapeId);
-        if (!bumper) {
-            return true;
+    for (int i = 0; i < contactEvents.endCount; i++) {
+        b2ShapeId shapeA = contactEvents.endEvents[i].shapeIdA;
+        b2ShapeId shapeB = contactEvents.endEvents[i].shapeIdB;
+        if (!b2Shape_IsValid(shapeA) || !b2Shape_IsValid(shapeB)) {
+            continue;
         }
-        
-        if (bumper->type == BUMPER_TYPE_STANDARD) {
-            // Standard bumpers: apply bounce effect, score, sound, and allow elastic collision
-            bumper->bounceEffect = 10.0f;
-            (ball->game)->gameScore += 50;
-            if ((ball->game)->waterPowerupState == 0) {
-                (ball->game)->powerupScore += 50;
-            }
-            playUpperBouncerSound((ball->game)->sound);
-            return true;
-        } else if (bumper->type == BUMPER_TYPE_SLOW_MOTION) {
-            // Slow-motion bumper: single-use powerup with cooldown
-            // Only trigger if powerup is available
-            if ((ball->game)->slowMoPowerupAvailable == 1) {
-                // Trigger slow motion effect
-                (ball->game)->slowMotion = 1;
-                (ball->game)->slowMotionCounter = 1200;
-                (ball->game)->gameScore += 1000;
-                if ((ball->game)->waterPowerupState == 0) {
-                    (ball->game)->powerupScore += 1000;
+        if (shape_tag_kind(shapeA) == SHAPE_KIND_PADDLE && shape_tag_kind(shapeB) == SHAPE_KIND_BALL) {
+            physics_push_end_event(game->physics, PHYSICS_EVENT_PADDLE_END, shapeB);
+        } else if (shape_tag_kind(shapeB) == SHAPE_KIND_PADDLE && shape_tag_kind(shapeA) == SHAPE_KIND_BALL) {
+            physics_push_end_event(game->physics, PHYSICS_EVENT_PADDLE_END, shapeA);
+        }
+    }
+
+    // Sensor bumpers (slow motion, lane targets) and the water surface
+    b2SensorEvents sensorEvents = b2World_GetSensorEvents(game->world);
+    for (int i = 0; i < sensorEvents.beginCount; i++) {
+        b2ShapeId sensorShape = sensorEvents.beginEvents[i].sensorShapeId;
+        b2ShapeId visitorShape = sensorEvents.beginEvents[i].visitorShapeId;
+        if (!b2Shape_IsValid(sensorShape) || !b2Shape_IsValid(visitorShape) ||
+            shape_tag_kind(visitorShape) != SHAPE_KIND_BALL) {
+            continue;
+        }
+        if (shape_tag_kind(sensorShape) == SHAPE_KIND_BUMPER) {
+            physics_push_event(game->physics, PHYSICS_EVENT_BUMPER_HIT, shape_tag_index(visitorShape),
+                               shape_tag_index(sensorShape));
+        } else if (shape_tag_kind(sensorShape) == SHAPE_KIND_WATER) {
+            physics_push_event(game->physics, PHYSICS_EVENT_WATER_ENTER, shape_tag_index(visitorShape), 0);
+        }
+    }
+    for (int i = 0; i < sensorEvents.endCount; i++) {
+        b2ShapeId sensorShape = sensorEvents.endEvents[i].sensorShapeId;
+        b2ShapeId visitorShape = sensorEvents.endEvents[i].visitorShapeId;
+        if (!b2Shape_IsValid(sensorShape) || !b2Shape_IsValid(visitorShape)) {
+            continue;
+        }
+        if (shape_tag_kind(sensorShape) == SHAPE_KIND_WATER &&
+            shape_tag_kind(visitorShape) == SHAPE_KIND_BALL) {
+            physics_push_end_event(game->physics, PHYSICS_EVENT_WATER_EXIT, visitorShape);
+        }
+    }
+}
+
+/*
+ * physics_drain_events
+ *  - Applies every queued PhysicsEvent in order and empties the ring.
+ */
+static void physics_drain_events(GameStruct *game) {
+    PhysicsContext *ctx = game->physics;
+    while (ctx->eventHead != ctx->eventTail) {
+        const PhysicsEvent *ev = &ctx->eventRing[ctx->eventHead & (PHYSICS_EVENT_CAPACITY - 1)];
+        ctx->eventHead++;
+
+        switch (ev->type) {
+            case PHYSICS_EVENT_BUMPER_HIT:
+                physics_apply_bumper_hit(game, &game->bumpers[ev->target]);
+                break;
+            case PHYSICS_EVENT_PADDLE: {
+                // A ball cradled on a flipper is still, but not stuck: keep it
+                // awake (it must react when the flipper moves) and off the kill timer
+                Ball *ball = &game->balls[ev->ball];
+                if (ball->active && ball->flipperContacts++ == 0) {
+                    b2Body_EnableSleep(ball->body, false);
+                    ball->asleep = 0;
+                    ball->killCounter = 0;
                 }
-                playSlowdownSound((ball->game)->sound);
-                
-                // Mark powerup as unavailable and start explosion effect
-                (ball->game)->slowMoPowerupAvailable = 0;
-                (ball->game)->slowMoExplosionEffect = 1.0f;
-                
-                // Show bounce effect only when powerup is triggered
-                bumper->bounceEffect = 20.0f;
+                break;
             }
-            // Disable elastic collision regardless of availability
-            return false; // Disable contact to prevent elastic collision
-        } else if (bumper->type == BUMPER_TYPE_LANE_TARGET_A ||
-                   bumper->type == BUMPER_TYPE_LANE_TARGET_B) {
-            // Lane target bumpers: score once when enabled, then disable collision
-            // In Chipmunk this returned cpFalse to prevent elastic bounce
-            if (bumper->enabled == 1) {
-                (ball->game)->gameScore += 50;
-                if ((ball->game)->waterPowerupState == 0) {
-                    (ball->game)->powerupScore += 50;
+            case PHYSICS_EVENT_PADDLE_END: {
+                // Removing a ball can report its end-touch a step late, after
+                // the slot was reused; only count it for the same shape and
+                // never go below zero
+                Ball *ball = &game->balls[ev->ball];
+                if (ball->active && B2_ID_EQUALS(ball->shape, ev->shape) &&
+                    ball->flipperContacts > 0 && --ball->flipperContacts == 0) {
+                    b2Body_EnableSleep(ball->body, true);
                 }
-                bumper->enabled = 0;
-                playBounce((ball->game)->sound);
+                break;
             }
-            return false; // Disable contact - lane targets don't bounce
-        } else if (bumper->type == BUMPER_TYPE_WATER_POWERUP) {
-            if (bumper->enabled == 1) {
-                bumper->bounceEffect = 10.0f;
-                (ball->game)->gameScore += 250;
-                if ((ball->game)->waterPowerupState == 0) {
-                    (ball->game)->powerupScore += 250;
+            case PHYSICS_EVENT_LEFT_SLING:
+                game->leftLowerBumperAnim = 1.0f;
+                physics_award_score(game, 25);
+                playBounce2(game->sound);
+                break;
+            case PHYSICS_EVENT_RIGHT_SLING:
+                game->rightLowerBumperAnim = 1.0f;
+                physics_award_score(game, 25);
+                playBounce2(game->sound);
+                break;
+            case PHYSICS_EVENT_WATER_ENTER: {
+                // Splash with a ripple scaled by how fast the ball dropped in
+                Ball *ball = &game->balls[ev->ball];
+                if (ball->active && !ball->underwaterState) {
+                    ball->underwaterState = 1;
+                    Water_Splash(game->water, ball->position.x, fabsf(ball->velocity.y) * 0.0025f);
+                    playWaterSplash(game->sound);
                 }
-                bumper->enabled = 0;
-                playBounce((ball->game)->sound);
-                return true; // Allow elastic collision for enabled water powerup bumpers
-            } else {
-                return false; // Disable collision if bumper not enabled
+                break;
             }
-        } else {
-            // Fallback: simple one-shot scoring bumper without elastic bounce
-            // In Chipmunk this returned cpFalse to prevent elastic bounce
-            (ball->game)->gameScore += 25;
-            if ((ball->game)->waterPowerupState == 0) {
-                (ball->game)->powerupScore += 25;
+            case PHYSICS_EVENT_WATER_EXIT: {
+                // Same late end-touch as PHYSICS_EVENT_PADDLE_END: a drained
+                // ball's exit must not clear the state of the slot's new ball
+                Ball *ball = &game->balls[ev->ball];
+                if (ball->active && B2_ID_EQUALS(ball->shape, ev->shape)) {
+                    ball->underwaterState = 0;
+                }
+                break;
             }
-            bumper->enabled = 0;
-            return false; // Disable contact for fallback bumpers
+            default:
+                break;
         }
-    } else if (otherCategory == CATEGORY_PADDLE) {
-        // Ball-Flipper collision
-        ball->killCounter = 0;
+    }
+
+    if (ctx->droppedEvents > 0) {
+        fprintf(stderr, "[PHYSICS] event ring full, dropped %ld events\n", ctx->droppedEvents);
+        ctx->droppedEvents = 0;
+    }
+}
+
+/*
+ * PreSolveCallback
+ *  - Called by Box2D for each touching contact of a ball before the solver.
+ *  - Only decides whether the contact is solid (true) or a ghost (false);
+ *    gameplay effects come from physics_collect_events after the step.
+ *  - context is the owning GameStruct.
+ */
+static bool PreSolveCallback(b2ShapeId shapeIdA, b2ShapeId shapeIdB, b2Manifold* manifold, void* context) {
+    GameStruct *game = (GameStruct *)context;
+
+    ShapeKind kindA = shape_tag_kind(shapeIdA);
+    ShapeKind kindB = shape_tag_kind(shapeIdB);
+
+    // Identify the other object; the ball may be either shape
+    ShapeKind otherKind;
+    b2ShapeId otherShapeId;
+    if (kindA == SHAPE_KIND_BALL) {
+        otherKind = kindB;
+        otherShapeId = shapeIdB;
+    } else if (kindB == SHAPE_KIND_BALL) {
+        otherKind = kindA;
+        otherShapeId = shapeIdA;
+    } else {
+        // Neither is a ball, allow collision
         return true;
-    } else if (otherCategory == CATEGORY_LEFT_LOWER_BUMPER) {
-        // Left lower slingshot
-        leftLowerBumperAnim = 1.0f;
-        (ball->game)->gameScore += 25;
-        if ((ball->game)->waterPowerupState == 0) {
-            (ball->game)->powerupScore += 25;
-        }
-        playBounce2((ball->game)->sound);
+    }
+    if (otherKind == SHAPE_KIND_BALL) {
+        // Ball against ball (mega multiball): always solid
         return true;
-    } else if (otherCategory == CATEGORY_RIGHT_LOWER_BUMPER) {
-        // Right lower slingshot
-        rightLowerBumperAnim = 1.0f;
-        (ball->game)->gameScore += 25;
-        if ((ball->game)->waterPowerupState == 0) {
-            (ball->game)->powerupScore += 25;
+    }
+
+    if (otherKind == SHAPE_KIND_BUMPER) {
+        const Bumper *bumper = &game->bumpers[shape_tag_index(otherShapeId)];
+        if (bumper->type == BUMPER_TYPE_WATER_POWERUP) {
+            // Water powerup bumpers are solid only while enabled
+            return bumper->enabled == 1;
         }
-        playBounce2((ball->game)->sound);
         return true;
-    } else if (otherCategory == CATEGORY_ONE_WAY) {
+    } else if (otherKind == SHAPE_KIND_ONE_WAY) {
         // One-way gate logic - ported from Chipmunk's CollisionOneWay handler
-        // 
+        //
         // Chipmunk version:
         //   if (cpvdot(cpArbiterGetNormal(arb), cpv(0,1)) < 0) {
         //       return cpArbiterIgnore(arb);  // Pass through
@@ -310,116 +602,356 @@ static bool PreSolveCallback(b2ShapeId shapeIdA, b2ShapeId shapeIdB, b2Manifold*
         // When the ball passes upward (leaving the shooter), the dot product with (0,1) is negative.
         // When the ball tries to fall back down, the dot product is positive or zero.
         //
-        // Box2D manifold normal: points from shapeA to shapeB
-        // We need to determine which direction the normal is pointing relative to upward (0,1).
-        // 
-        // The manifold normal in Box2D points from shape A to shape B.
-        // Since we identified the ball as either A or B, we need to know which.
+        // Box2D manifold normal points from shapeA to shapeB.
         b2Vec2 normal = manifold->normal;
-        
+
         // If ball is shape A, normal points from ball to gate.
         // If ball is shape B, normal points from gate to ball (so we need to flip it).
-        if (catB == CATEGORY_BALL) {
-            // Ball is shape B, so normal points from gate (A) to ball (B)
-            // We need normal from ball to gate, so flip it
+        if (kindB == SHAPE_KIND_BALL) {
             normal.x = -normal.x;
             normal.y = -normal.y;
         }
-        
+
         // Compute dot product with upward direction (0, 1)
         float dotProduct = normal.x * 0.0f + normal.y * 1.0f;
-        
+
         if (dotProduct < 0) {
             // Ball is moving upward through the gate (leaving shooter lane)
             return false; // Disable contact - allow pass through
         }
-        
+
         // Ball is trying to fall back down into shooter lane
         return true; // Block the ball
     }
-    
+
     return true; // Allow collision by default
 }
 
 /*
- * writeCircleWallSegment
- *  - Fills a contiguous range of entries in the walls[][] array with short line
- *    segments that approximate a circular arc.
- *  - segmentIndex: starting index in the walls array to write into.
- *  - numSegments : how many segments to generate (uses numSegments+1 points).
- *  - degStart/degEnd: arc range in degrees, before the internal -90° offset
- *    that aligns the arc with the table coordinate system.
+ * physics_load_table
+ *  - Reads game->tablePath, falling back to the built-in table if it is unset,
+ *    unreadable or does not have the bumpers the game logic indexes.
  */
-static void writeCircleWallSegment(float walls[numWalls][4], int segmentIndex, int numSegments,
-                                   float degStart, float degEnd, float centerX, float centerY, float radius) {
-    float totalDegreeRange = fabsf(degEnd - degStart);
-    float degPerPoint = totalDegreeRange / (numSegments + 1);
-
-    degStart -= 90;
-
-    // Iterate through numSegments + 1 points.
-    float prevPointX = centerX + (cos(degStart * DEG_TO_RAD) * radius);
-    float prevPointY = centerY + (sin(degStart * DEG_TO_RAD) * radius);
-    float curPointX = 0;
-    float curPointY = 0;
-    for (int i = 1; i <= numSegments; i++) {
-        curPointX = centerX + (cos((degStart + (i * degPerPoint)) * DEG_TO_RAD) * radius);
-        curPointY = centerY + (sin((degStart + (i * degPerPoint)) * DEG_TO_RAD) * radius);
-        walls[segmentIndex + i - 1][0] = prevPointX;
-        walls[segmentIndex + i - 1][1] = prevPointY;
-        walls[segmentIndex + i - 1][2] = curPointX;
-        walls[segmentIndex + i - 1][3] = curPointY;
-        prevPointX = curPointX;
-        prevPointY = curPointY;
+static void physics_load_table(const GameStruct *game, TableLayout *layout) {
+    if (game->tablePath != NULL) {
+        if (TableLayout_Load(layout, game->tablePath) == 0) {
+            if (layout->numBumpers == numBumpers) {
+                return;
+            }
+            printf("physics_init: %s has %d bumpers, expected %d\n",
+                   game->tablePath, layout->numBumpers, numBumpers);
+            TableLayout_Free(layout);
+        }
+        printf("physics_init: using the built-in table\n");
     }
+    TableLayout_BuildDefault(layout);
+}
+
+static b2SurfaceMaterial physics_table_material(const TableLayout *layout, int index) {
+    b2SurfaceMaterial material = b2DefaultShapeDef().material;
+    material.friction = layout->materials[index].friction;
+    material.restitution = layout->materials[index].restitution;
+    return material;
+}
+
+/*
+ * physics_create_table_segment
+ *  - One static segment; the kind picks the collision category and shape tag.
+ */
+static void physics_create_table_segment(b2BodyId staticBody, const TableLayout *layout, int index) {
+    const TableSegment *wall = &layout->segments[index];
+    float dx = wall->x2 - wall->x1;
+    float dy = wall->y2 - wall->y1;
+    if (dx * dx + dy * dy < minSegmentLength * minSegmentLength) {
+        return;
+    }
+
+    b2Segment segment;
+    segment.point1 = pb2_v(wall->x1, wall->y1);
+    segment.point2 = pb2_v(wall->x2, wall->y2);
+
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.material = physics_table_material(layout, wall->material);
+    shapeDef.filter.maskBits = CATEGORY_BALL;
+    shapeDef.enableContactEvents = false;
+    switch (wall->kind) {
+        case TABLE_SEGMENT_LEFT_SLING:
+            shapeDef.filter.categoryBits = CATEGORY_LEFT_LOWER_BUMPER;
+            shapeDef.userData = shape_tag(SHAPE_KIND_LEFT_SLING, 0);
+            shapeDef.enableContactEvents = true;
+            break;
+        case TABLE_SEGMENT_RIGHT_SLING:
+            shapeDef.filter.categoryBits = CATEGORY_RIGHT_LOWER_BUMPER;
+            shapeDef.userData = shape_tag(SHAPE_KIND_RIGHT_SLING, 0);
+            shapeDef.enableContactEvents = true;
+            break;
+        case TABLE_SEGMENT_ONE_WAY:
+            shapeDef.filter.categoryBits = CATEGORY_ONE_WAY;
+            shapeDef.userData = shape_tag(SHAPE_KIND_ONE_WAY, 0);
+            shapeDef.enablePreSolveEvents = true;
+            break;
+        default:
+            shapeDef.filter.categoryBits = CATEGORY_WALL;
+            shapeDef.userData = shape_tag(SHAPE_KIND_WALL, index);
+            break;
+    }
+    b2CreateSegmentShape(staticBody, &shapeDef, &segment);
+}
+
+static b2Vec2 physics_arc_point(const TableArc *arc, int i) {
+    float angle = (arc->startDeg + i * arc->stepDeg) * DEG_TO_RAD;
+    return pb2_v(arc->centerX + cosf(angle) * arc->radius,
+                 arc->centerY + sinf(angle) * arc->radius);
+}
+
+/*
+ * physics_create_table_arc
+ *  - Builds an arc as one chain instead of separate segments, so the ball rolls
+ *    over the joints without catching on internal edges.
+ *  - Chains are one-sided and collide on the right of the point order, which for
+ *    increasing angles is the outside of the arc. A one-sided arc is an open
+ *    chain with one extra point past each end: Box2D uses an open chain's first
+ *    and last edges only as neighbours for smoothing, so the arc still costs one
+ *    broadphase proxy per segment. Two-sided arcs go out and back as a loop.
+ */
+static void physics_create_table_arc(b2BodyId staticBody, const TableLayout *layout, int index) {
+    const TableArc *arc = &layout->arcs[index];
+    int n = arc->segments;
+    if (n < 1 || fabsf(arc->stepDeg) * DEG_TO_RAD * arc->radius < minSegmentLength) {
+        return;
+    }
+
+    b2Vec2 points[2 * TABLE_ARC_MAX_SEGMENTS + 3];
+    int count = 0;
+    bool isLoop = false;
+
+    if (arc->side == TABLE_ARC_SOLID_BOTH) {
+        if (n < 2) {
+            // Too short for a loop; a plain segment is two-sided already
+            b2Segment segment = { physics_arc_point(arc, 0), physics_arc_point(arc, 1) };
+            b2ShapeDef shapeDef = b2DefaultShapeDef();
+            shapeDef.material = physics_table_material(layout, arc->material);
+            shapeDef.filter.categoryBits = CATEGORY_WALL;
+            shapeDef.filter.maskBits = CATEGORY_BALL;
+            shapeDef.enableContactEvents = false;
+            shapeDef.userData = shape_tag(SHAPE_KIND_WALL, layout->numSegments + index);
+            b2CreateSegmentShape(staticBody, &shapeDef, &segment);
+            return;
+        }
+        for (int i = 0; i <= n; i++) {
+            points[count++] = physics_arc_point(arc, i);
+        }
+        for (int i = n - 1; i >= 1; i--) {
+            points[count++] = physics_arc_point(arc, i);
+        }
+        isLoop = true;
+    } else {
+        // Increasing i runs along increasing angle when stepDeg > 0 (solid outside)
+        bool solidOutside = (arc->side == TABLE_ARC_SOLID_OUTSIDE);
+        bool forward = (solidOutside == (arc->stepDeg > 0.0f));
+        for (int i = -1; i <= n + 1; i++) {
+            points[count++] = physics_arc_point(arc, forward ? i : n - i);
+        }
+    }
+
+    b2SurfaceMaterial material = physics_table_material(layout, arc->material);
+    b2ChainDef chainDef = b2DefaultChainDef();
+    chainDef.points = points;
+    chainDef.count = count;
+    chainDef.isLoop = isLoop;
+    chainDef.materials = &material;
+    chainDef.materialCount = 1;
+    chainDef.filter.categoryBits = CATEGORY_WALL;
+    chainDef.filter.maskBits = CATEGORY_BALL;
+    chainDef.userData = shape_tag(SHAPE_KIND_WALL, layout->numSegments + index);
+    b2CreateChain(staticBody, &chainDef);
+}
+
+/*
+ * physics_create_table_bumper
+ *  - Kinematic body with a circle shape. Sensor bumpers report hits through
+ *    sensor events and never bounce the ball.
+ */
+static void physics_create_table_bumper(GameStruct *game, const TableLayout *layout,
+                                        Bumper *bumpers, int index) {
+    const TableBumper *def = &layout->bumpers[index];
+    bool sensor = (def->flags & TABLE_BUMPER_SENSOR) != 0;
+
+    b2BodyDef bumperBodyDef = b2DefaultBodyDef();
+    bumperBodyDef.type = b2_kinematicBody;
+    bumperBodyDef.position = pb2_v(def->x, def->y);
+    bumperBodyDef.enableSleep = !sensor;  // keep the sensor overlap test running
+    bumpers[index].body = b2CreateBody(game->world, &bumperBodyDef);
+
+    b2Circle circle;
+    circle.center = pb2_v(0, 0);
+    circle.radius = def->radius;
+
+    b2ShapeDef bumperShapeDef = b2DefaultShapeDef();
+    bumperShapeDef.material = physics_table_material(layout, def->material);
+    bumperShapeDef.filter.categoryBits = CATEGORY_BUMPER;
+    bumperShapeDef.filter.maskBits     = CATEGORY_BALL;
+    bumperShapeDef.userData = shape_tag(SHAPE_KIND_BUMPER, index);
+    bumperShapeDef.isSensor = sensor;
+    bumperShapeDef.enableSensorEvents = sensor;
+    bumperShapeDef.enableContactEvents = !sensor;
+    bumperShapeDef.enablePreSolveEvents = (def->type == BUMPER_TYPE_WATER_POWERUP);
+
+    bumpers[index].shape = b2CreateCircleShape(bumpers[index].body, &bumperShapeDef, &circle);
+    bumpers[index].position = bumperBodyDef.position;
+    bumpers[index].bounceEffect = 0;
+    bumpers[index].enabledSize = 0.0f;
+    bumpers[index].enabled = (def->flags & TABLE_BUMPER_ENABLED) != 0;
+    bumpers[index].type = def->type;
+    bumpers[index].angle = def->angle;
+}
+
+/*
+ * physics_create_ball_pool
+ *  - Creates `capacity` disabled ball bodies of the given radius and mass.
+ */
+static void physics_create_ball_pool(GameStruct *game, BallBodyPool *pool, int capacity,
+                                     float radius, float mass) {
+    pool->free = malloc(capacity * sizeof(PooledBallBody));
+    pool->freeCount = 0;
+    pool->radius = radius;
+
+    // Calculate density from mass to match Chipmunk behavior
+    // In Chipmunk: mass is set directly
+    // In Box2D: mass = density * area, where area = π * r²
+    // Therefore: density = mass / (π * r²)
+    float area = 3.14159265f * radius * radius;
+    float density = mass / area;
+
+    b2BodyDef ballBodyDef = b2DefaultBodyDef();
+    ballBodyDef.type = b2_dynamicBody;
+    ballBodyDef.position = pb2_v(-100.0f, -100.0f);  // parked off the table
+    ballBodyDef.isEnabled = false;
+    ballBodyDef.sleepThreshold = stuckBallSpeed;  // sleeping is how stuck balls are found
+    ballBodyDef.userData = shape_tag(SHAPE_KIND_BALL, 0);
+
+    b2Circle ballCircle;
+    ballCircle.center = pb2_v(0, 0);
+    ballCircle.radius = radius;
+
+    b2ShapeDef ballShapeDef = b2DefaultShapeDef();
+    // Contact and pre-solve events are enabled on the shapes that need them
+    // (bumpers, flippers, slingshots, the one-way gate), not here: a contact
+    // reports when either shape asks, and walls and other balls never need it.
+    ballShapeDef.enableContactEvents = false;
+    ballShapeDef.enablePreSolveEvents = false;
+    ballShapeDef.enableSensorEvents = true;
+    ballShapeDef.material.friction = 0.0f;
+    ballShapeDef.material.restitution = 0.7f;
+    ballShapeDef.density = density;
+    ballShapeDef.filter.categoryBits = CATEGORY_BALL;
+    ballShapeDef.filter.maskBits =
+        CATEGORY_WALL |
+        CATEGORY_BUMPER |
+        CATEGORY_PADDLE |
+        CATEGORY_LEFT_LOWER_BUMPER |
+        CATEGORY_RIGHT_LOWER_BUMPER |
+        CATEGORY_ONE_WAY |
+        CATEGORY_WATER;
+    // Body and shape are tagged with the ball slot in physics_add_ball
+    ballShapeDef.userData = shape_tag(SHAPE_KIND_BALL, 0);
+
+    for (int i = 0; i < capacity; i++) {
+        PooledBallBody *pooled = &pool->free[pool->freeCount++];
+        pooled->body = b2CreateBody(game->world, &ballBodyDef);
+        pooled->shape = b2CreateCircleShape(pooled->body, &ballShapeDef, &ballCircle);
+    }
+}
+
+/*
+ * Water surface sensor
+ *  - One box sensor on a kinematic body covers the table below the surface;
+ *    Box2D reports balls entering and leaving it (PHYSICS_EVENT_WATER_*), so
+ *    only balls crossing the surface cost anything.
+ *  - Sensor overlap starts when the ball touches the box, so the top sits one
+ *    normal ball radius under the surface: a ball counts as underwater once
+ *    its center is below waterY, as the old per-ball test did.
+ *  - With the water down the box is parked under the table.
+ */
+static const float waterSensorMargin = 100.0f;
+
+static void physics_size_water_sensor(PhysicsContext *ctx, float waterHeight) {
+    float top = worldHeight + waterSensorMargin;
+    if (waterHeight > 0.0f) {
+        top = worldHeight * (1.0f - waterHeight) + ballSize / 2.0f;
+    }
+    float bottom = worldHeight + 2.0f * waterSensorMargin;
+    float halfWidth = worldWidth / 2.0f + waterSensorMargin;
+    b2Polygon box = b2MakeOffsetBox(halfWidth, (bottom - top) / 2.0f,
+                                    pb2_v(worldWidth / 2.0f, (top + bottom) / 2.0f), b2Rot_identity);
+    b2Shape_SetPolygon(ctx->waterSensorShape, &box);
+    ctx->waterSensorHeight = waterHeight;
+}
+
+static void physics_create_water_sensor(GameStruct *game) {
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_kinematicBody;
+    bodyDef.enableSleep = false;
+    b2BodyId body = b2CreateBody(game->world, &bodyDef);
+
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.isSensor = true;
+    shapeDef.enableSensorEvents = true;
+    shapeDef.filter.categoryBits = CATEGORY_WATER;
+    shapeDef.filter.maskBits = CATEGORY_BALL;
+    shapeDef.userData = shape_tag(SHAPE_KIND_WATER, 0);
+    b2Polygon box = b2MakeBox(1.0f, 1.0f);
+    game->physics->waterSensorShape = b2CreatePolygonShape(body, &shapeDef, &box);
+    physics_size_water_sensor(game->physics, game->waterHeight);
 }
 
 /*
  * physics_init
  *  - Creates a Box2D world for the given GameStruct.
- *  - Builds static walls, bumpers, one-way gate, and flippers.
+ *  - Builds static walls, arcs, bumpers, one-way gate, and flippers from the
+ *    table file at game->tablePath (built-in table if NULL or invalid).
  *  - Returns pointers to the bumper array and flipper bodies for use by
  *    rendering and game-logic code.
+ *  - Returns 0, or -1 when Box2D has no free world slot (nothing to shut down).
  */
-void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFlipperBody, b2BodyId **out_rightFlipperBody) {
-    /* ----------------------------- Static walls ----------------------------- */
-    // Each entry is a segment: { x1, y1, x2, y2 } in world coordinates.
-    float walls[128][4] = {
-        {0,0,worldWidth,0},
-        {0,0,0,worldHeight},
-        {worldWidth,0,worldWidth,worldHeight},
-        {worldWidth - 6,56,worldWidth - 6,worldHeight},
-        {worldWidth - 7,56,worldWidth - 7,worldHeight},
-        {worldWidth-6,56,worldWidth-7,56},
-        {0,128,19,142},
-        {worldWidth - 7,128,worldWidth - 26,142},
-        {0,2.1,worldWidth,2.1},
-        {40.4,1.6,41.2,4.0},
-        {41.2,4.0,65.2,1.6},
-        {69.2,16.4,60.4,43.2},
-        {60.4,43.2,68.8,55.6},
-        {74.8,63.6,83.2,76.0},
-        {84.0,56.7,84.0,37.2},
-        {70.8,18.4,68,26.8},
-        {74.8,37.6,68.8,55.6},
-        {82.0,39.2,74.8,63.6},
-        {67.400002,146.400009,83.200005,134.199997},
-        {16.400000,146.199997,0.600000,134.600006}
-    };
-    writeCircleWallSegment(walls, 20, 20, 0, 90, worldWidth-28.5, 30.75, 28.75);
-    writeCircleWallSegment(walls, 40, 20, 270, 360, 28.5, 30.75, 28.75);
-    writeCircleWallSegment(walls, 60, 10, 20, 110, 64.75, 35.6, 10.15);
-    writeCircleWallSegment(walls, 70, 10, 20, 110, 64.75, 35.6, 17.50);
-    writeCircleWallSegment(walls, 80, 10, 13, 110, 64.75, 35.6, 19.50);
+int physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFlipperBody, b2BodyId **out_rightFlipperBody) {
+    TableLayout layout;
+    physics_load_table(game, &layout);
+
+    PhysicsContext *ctx = calloc(1, sizeof(PhysicsContext));
+    ctx->quality = PHYSICS_QUALITY_ADAPTIVE;
+    ctx->lastSubSteps = 1;
+    ctx->waterSensorHeight = -1.0f;
+    game->physics = ctx;
 
     // Initialize physics simulation
     b2WorldDef worldDef = b2DefaultWorldDef();
     worldDef.gravity = pb2_v(0, 100);
 
+    // Multithreaded solver. PreSolveCallback only reads state, so it is safe on workers.
+    ctx->taskPool = TaskPool_Create(game->physicsWorkers);
+    if (TaskPool_GetWorkerCount(ctx->taskPool) > 1) {
+        worldDef.workerCount = TaskPool_GetWorkerCount(ctx->taskPool);
+        worldDef.enqueueTask = physics_enqueue_task;
+        worldDef.finishTask = physics_finish_task;
+        worldDef.userTaskContext = ctx->taskPool;
+    }
+
     game->world = b2CreateWorld(&worldDef);
+    if (B2_IS_NULL(game->world)) {
+        // Box2D has a fixed number of world slots and returns a null id when they are all in use
+        printf("physics_init: Box2D could not create another world\n");
+        TableLayout_Free(&layout);
+        TaskPool_Destroy(ctx->taskPool);
+        free(ctx);
+        game->physics = NULL;
+        return -1;
+    }
+    b2World_SetContactTuning(game->world, qualityPresets[ctx->quality].contactHertz,
+                             contactDampingRatio, contactPushSpeed);
     
     // Register the PreSolve callback for collision handling
-    b2World_SetPreSolveCallback(game->world, PreSolveCallback, NULL);
+    b2World_SetPreSolveCallback(game->world, PreSolveCallback, game);
 
     // Create static body for walls
     b2BodyDef staticBodyDef = b2DefaultBodyDef();
@@ -427,242 +959,40 @@ void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFli
     staticBodyDef.position = pb2_v(0, 0);
     b2BodyId staticBody = b2CreateBody(game->world, &staticBodyDef);
 
-    // Create walls
-    for (int i = 0; i < numWalls; i++) {
-        b2Segment segment;
-        segment.point1 = pb2_v(walls[i][0], walls[i][1]);
-        segment.point2 = pb2_v(walls[i][2], walls[i][3]);
-
-        b2ShapeDef shapeDef = b2DefaultShapeDef();
-        shapeDef.material.friction = 0.5f;
-        shapeDef.material.restitution = 0.5f;
-        shapeDef.filter.categoryBits = CATEGORY_WALL;
-        shapeDef.filter.maskBits     = CATEGORY_BALL;
-
-        b2CreateSegmentShape(staticBody, &shapeDef, &segment);
+    /* ------------------------ Walls, slingshots, arcs ----------------------- */
+    for (int i = 0; i < layout.numSegments; i++) {
+        physics_create_table_segment(staticBody, &layout, i);
+    }
+    for (int i = 0; i < layout.numArcs; i++) {
+        physics_create_table_arc(staticBody, &layout, i);
     }
 
     /* ------------------------------ Bumpers --------------------------------- */
-    // numBumpers and type assignments must stay in sync with rendering code.
-    const float bumperSize = 10.0f;
-    const float smallBumperSize = 4.0f;
-    const float bumperBounciness = 1.8f;
+    // Index order (standard, slow motion, lane targets, water) is relied on by game.c.
     Bumper* bumpers = malloc(numBumpers * sizeof(Bumper));
-
-    // Lower slingshot segments
-    b2Segment leftBouncer, rightBouncer;
-    leftBouncer.point1 = pb2_v(14.800000, 125.200005);
-    leftBouncer.point2 = pb2_v(7.600000, 109.200005);
-    rightBouncer.point1 = pb2_v(75.599998, 108.800003);
-    rightBouncer.point2 = pb2_v(69.200005, 125.200005);
-    
-    b2ShapeDef leftBouncerDef = b2DefaultShapeDef();
-    leftBouncerDef.material.friction = 0.0f;
-    leftBouncerDef.material.restitution = 1.2f;
-    leftBouncerDef.filter.categoryBits = CATEGORY_LEFT_LOWER_BUMPER;
-    leftBouncerDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreateSegmentShape(staticBody, &leftBouncerDef, &leftBouncer);
-
-    b2ShapeDef rightBouncerDef = b2DefaultShapeDef();
-    rightBouncerDef.material.friction = 0.0f;
-    rightBouncerDef.material.restitution = 1.2f;
-    rightBouncerDef.filter.categoryBits = CATEGORY_RIGHT_LOWER_BUMPER;
-    rightBouncerDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreateSegmentShape(staticBody, &rightBouncerDef, &rightBouncer);
-
-    // Bouncer guards
-    b2Segment guard1, guard2;
-    guard1.point1 = pb2_v(7.200000, 111.200005);
-    guard1.point2 = pb2_v(12.800000, 124.400002);
-    guard2.point1 = pb2_v(71.200005, 124.800003);
-    guard2.point2 = pb2_v(76.000000, 110.800003);
-    
-    b2ShapeDef guardDef = b2DefaultShapeDef();
-    guardDef.material.friction = 0.0f;
-    guardDef.material.restitution = 0.9f;
-    guardDef.filter.categoryBits = CATEGORY_WALL;
-    guardDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreateSegmentShape(staticBody, &guardDef, &guard1);
-    b2CreateSegmentShape(staticBody, &guardDef, &guard2);
-
-    // Standard bumpers (0-2)
-    float bumperPositions[3][2] = {
-        {24.9, 19.9},
-        {46.6, 17.8},
-        {38.0, 36.4}
-    };
-
-    for (int i = 0; i < 3; i++) {
-        b2BodyDef bumperBodyDef = b2DefaultBodyDef();
-        bumperBodyDef.type = b2_kinematicBody;
-        bumperBodyDef.position = pb2_v(bumperPositions[i][0], bumperPositions[i][1]);
-        bumpers[i].body = b2CreateBody(game->world, &bumperBodyDef);
-
-        b2Circle circle;
-        circle.center = pb2_v(0, 0);
-        circle.radius = bumperSize / 2.0f;
-
-        b2ShapeDef bumperShapeDef = b2DefaultShapeDef();
-        bumperShapeDef.material.restitution = bumperBounciness;
-        bumperShapeDef.filter.categoryBits = CATEGORY_BUMPER;
-        bumperShapeDef.filter.maskBits     = CATEGORY_BALL;
-        bumperShapeDef.userData = &bumpers[i];
-
-        bumpers[i].shape = b2CreateCircleShape(bumpers[i].body, &bumperShapeDef, &circle);
-        bumpers[i].bounceEffect = 0;
-        bumpers[i].type = BUMPER_TYPE_STANDARD;
-    }
-
-    // Slow motion bumper (3)
-    b2BodyDef slowMoBumperDef = b2DefaultBodyDef();
-    slowMoBumperDef.type = b2_kinematicBody;
-    slowMoBumperDef.position = pb2_v(72.200005, 23.400000);
-    bumpers[3].body = b2CreateBody(game->world, &slowMoBumperDef);
-
-    b2Circle slowMoCircle;
-    slowMoCircle.center = pb2_v(0, 0);
-    slowMoCircle.radius = 2.0f;
-
-    b2ShapeDef slowMoShapeDef = b2DefaultShapeDef();
-    slowMoShapeDef.material.restitution = bumperBounciness;
-    slowMoShapeDef.filter.categoryBits = CATEGORY_BUMPER;
-    slowMoShapeDef.filter.maskBits     = CATEGORY_BALL;
-    slowMoShapeDef.userData = &bumpers[3];
-
-    bumpers[3].shape = b2CreateCircleShape(bumpers[3].body, &slowMoShapeDef, &slowMoCircle);
-    bumpers[3].bounceEffect = 0;
-    bumpers[3].type = BUMPER_TYPE_SLOW_MOTION;
-
-    // Lane target bumpers (4-9)
-    float lanePositions[6][2] = {
-        {63.34, 50.88},
-        {77.38, 70.96},
-        {15.1, 62.04},
-        {18.9, 45.3},
-        {61.02, 35.36},
-        {65.02, 23.02}
-    };
-    BumperType laneTypes[6] = {
-        BUMPER_TYPE_LANE_TARGET_A,
-        BUMPER_TYPE_LANE_TARGET_A,
-        BUMPER_TYPE_LANE_TARGET_A,
-        BUMPER_TYPE_LANE_TARGET_B,
-        BUMPER_TYPE_LANE_TARGET_B,
-        BUMPER_TYPE_LANE_TARGET_B
-    };
-    float laneAngles[6] = {
-        90.0 + 145.2,
-        90.0 + 145.2,
-        90.0 + 25.7,
-        90.0,
-        90.0 - 162.0,
-        90.0 - 162.0
-    };
-
-    for (int i = 4; i < 10; i++) {
-        b2BodyDef laneBumperDef = b2DefaultBodyDef();
-        laneBumperDef.type = b2_kinematicBody;
-        laneBumperDef.position = pb2_v(lanePositions[i-4][0], lanePositions[i-4][1]);
-        bumpers[i].body = b2CreateBody(game->world, &laneBumperDef);
-
-        b2Circle laneCircle;
-        laneCircle.center = pb2_v(0, 0);
-        laneCircle.radius = 2.0f;
-
-        b2ShapeDef laneShapeDef = b2DefaultShapeDef();
-        laneShapeDef.material.restitution = 0.0f;
-        laneShapeDef.filter.categoryBits = CATEGORY_BUMPER;
-        laneShapeDef.filter.maskBits     = CATEGORY_BALL;
-        laneShapeDef.userData = &bumpers[i];
-
-        bumpers[i].shape = b2CreateCircleShape(bumpers[i].body, &laneShapeDef, &laneCircle);
-        bumpers[i].bounceEffect = 0;
-        bumpers[i].type = laneTypes[i-4];
-        bumpers[i].enabled = 1;
-        bumpers[i].angle = laneAngles[i-4];
-    }
-
-    // Water powerup bumpers (10-13)
-    float waterPositions[4][2] = {
-        {12.2, 81.8},
-        {23.8, 91.2},
-        {61.2, 91.2},
-        {72.599998, 81.8}
-    };
-
-    for (int i = 10; i < 14; i++) {
-        b2BodyDef waterBumperDef = b2DefaultBodyDef();
-        waterBumperDef.type = b2_kinematicBody;
-        waterBumperDef.position = pb2_v(waterPositions[i-10][0], waterPositions[i-10][1]);
-        bumpers[i].body = b2CreateBody(game->world, &waterBumperDef);
-
-        b2Circle waterCircle;
-        waterCircle.center = pb2_v(0, 0);
-        waterCircle.radius = smallBumperSize / 2.0f;
-
-        b2ShapeDef waterShapeDef = b2DefaultShapeDef();
-        waterShapeDef.material.restitution = bumperBounciness;
-        waterShapeDef.filter.categoryBits = CATEGORY_BUMPER;
-        waterShapeDef.filter.maskBits     = CATEGORY_BALL;
-        waterShapeDef.userData = &bumpers[i];
-
-        bumpers[i].shape = b2CreateCircleShape(bumpers[i].body, &waterShapeDef, &waterCircle);
-        bumpers[i].bounceEffect = 0;
-        bumpers[i].enabledSize = 0.0f;
-        bumpers[i].enabled = 0;
-        bumpers[i].type = BUMPER_TYPE_WATER_POWERUP;
-    }
-
-    // Create one-way door
-    b2Segment oneWaySegment;
-    oneWaySegment.point1 = pb2_v(69.6, 16.6);
-    oneWaySegment.point2 = pb2_v(73.4, 4.6);
-    
-    b2ShapeDef oneWayDef = b2DefaultShapeDef();
-    oneWayDef.material.restitution = 0.5f;
-    oneWayDef.material.friction = 0.0f;
-    oneWayDef.filter.categoryBits = CATEGORY_ONE_WAY;
-    oneWayDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreateSegmentShape(staticBody, &oneWayDef, &oneWaySegment);
-
-    // Additional static segments
-    b2Segment tempSegments[3];
-    tempSegments[0].point1 = pb2_v(7.800000, 38.200001);
-    tempSegments[0].point2 = pb2_v(7.8, 49.200001);
-    tempSegments[1].point1 = pb2_v(16.000000, 38.400002);
-    tempSegments[1].point2 = pb2_v(16.000000, 53.799999);
-    tempSegments[2].point1 = pb2_v(16.000000, 53.799999);
-    tempSegments[2].point2 = pb2_v(8.600000, 68.800003);
-
-    b2ShapeDef tempDef = b2DefaultShapeDef();
-    tempDef.material.restitution = 0.5f;
-    tempDef.material.friction = 0.5f;
-    tempDef.filter.categoryBits = CATEGORY_WALL;
-    tempDef.filter.maskBits     = CATEGORY_BALL;
-
-    for (int i = 0; i < 3; i++) {
-        b2CreateSegmentShape(staticBody, &tempDef, &tempSegments[i]);
+    for (int i = 0; i < numBumpers; i++) {
+        physics_create_table_bumper(game, &layout, bumpers, i);
     }
 
     /* ------------------------------ Flippers -------------------------------- */
-    // Allocate memory for flipper bodies to return
-    static b2BodyId leftFlipperBodyStatic;
-    static b2BodyId rightFlipperBodyStatic;
 
     // Create left flipper
     // Body position must be adjusted because we offset the polygon vertices
     // Original Chipmunk position: (19.8, 145.45) with polygon at (0,0) and CoG at (height/2, height/2)
     // Box2D: We offset polygon by (-height/2, -height/2), so adjust body position by +(height/2, height/2)
+    // (the table's flipper pivots already include that adjustment)
     b2BodyDef leftFlipperDef = b2DefaultBodyDef();
     leftFlipperDef.type = b2_kinematicBody;
-    leftFlipperDef.position = pb2_v(17.2 + flipperHeight / 2.0f, 142.8 + flipperHeight / 2.0f);
-    leftFlipperBodyStatic = b2CreateBody(game->world, &leftFlipperDef);
+    leftFlipperDef.position = pb2_v(layout.leftFlipper.x, layout.leftFlipper.y);
+    ctx->leftFlipperBody = b2CreateBody(game->world, &leftFlipperDef);
 
     // Create right flipper
     b2BodyDef rightFlipperDef = b2DefaultBodyDef();
     rightFlipperDef.type = b2_kinematicBody;
-    rightFlipperDef.position = pb2_v(61.4 + flipperHeight / 2.0f, 142.8 + flipperHeight / 2.0f);
-    rightFlipperBodyStatic = b2CreateBody(game->world, &rightFlipperDef);
+    rightFlipperDef.position = pb2_v(layout.rightFlipper.x, layout.rightFlipper.y);
+    ctx->rightFlipperBody = b2CreateBody(game->world, &rightFlipperDef);
+    game->flipperPositions[0] = leftFlipperDef.position;
+    game->flipperPositions[1] = rightFlipperDef.position;
 
     // Define flipper polygon shape
     // In Chipmunk, the polygon was at (0,0) to (width, height) with center of gravity at (height/2, height/2)
@@ -688,7 +1018,9 @@ void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFli
     leftFlipperShapeDef.material.restitution = 0.2f;
     leftFlipperShapeDef.filter.categoryBits = CATEGORY_PADDLE;
     leftFlipperShapeDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreatePolygonShape(leftFlipperBodyStatic, &leftFlipperShapeDef, &flipperPoly);
+    leftFlipperShapeDef.enableContactEvents = true;
+    leftFlipperShapeDef.userData = shape_tag(SHAPE_KIND_PADDLE, 0);
+    b2CreatePolygonShape(ctx->leftFlipperBody, &leftFlipperShapeDef, &flipperPoly);
 
     // Create right flipper shape
     b2ShapeDef rightFlipperShapeDef = b2DefaultShapeDef();
@@ -696,19 +1028,105 @@ void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFli
     rightFlipperShapeDef.material.restitution = 0.2f;
     rightFlipperShapeDef.filter.categoryBits = CATEGORY_PADDLE;
     rightFlipperShapeDef.filter.maskBits     = CATEGORY_BALL;
-    b2CreatePolygonShape(rightFlipperBodyStatic, &rightFlipperShapeDef, &flipperPoly);
+    rightFlipperShapeDef.enableContactEvents = true;
+    rightFlipperShapeDef.userData = shape_tag(SHAPE_KIND_PADDLE, 1);
+    b2CreatePolygonShape(ctx->rightFlipperBody, &rightFlipperShapeDef, &flipperPoly);
+
+    /* ---------------------------- Ball bodies ------------------------------- */
+    physics_create_ball_pool(game, &ctx->normalBallPool, maxBalls, ballSize / 2.0f, 1.0f);
+    physics_create_ball_pool(game, &ctx->largeBallPool, largeBallPoolSize, 10.0f, 2.0f);
+    ctx->buoyancy.slot = malloc(maxBalls * sizeof(int));
+    ctx->buoyancy.posX = malloc(maxBalls * sizeof(float));
+    ctx->buoyancy.posY = malloc(maxBalls * sizeof(float));
+    ctx->buoyancy.forceY = malloc(maxBalls * sizeof(float));
+
+    /* ---------------------------- Water surface ----------------------------- */
+    physics_create_water_sensor(game);
 
     // Store references for debug drawing
-    debugState.staticBody = staticBody;
-    debugState.leftFlipper = &leftFlipperBodyStatic;
-    debugState.rightFlipper = &rightFlipperBodyStatic;
-    debugState.bumpers = bumpers;
-    debugState.numBumpers = numBumpers;
+    ctx->debugState.staticBody = staticBody;
+    ctx->debugState.leftFlipper = &ctx->leftFlipperBody;
+    ctx->debugState.rightFlipper = &ctx->rightFlipperBody;
+    ctx->debugState.bumpers = bumpers;
+    ctx->debugState.numBumpers = numBumpers;
+
+    TableLayout_Free(&layout);
 
     // Return bumpers and flipper bodies to caller
+    game->bumpers = bumpers;
     *out_bumpers = bumpers;
-    *out_leftFlipperBody = &leftFlipperBodyStatic;
-    *out_rightFlipperBody = &rightFlipperBodyStatic;
+    *out_leftFlipperBody = &ctx->leftFlipperBody;
+    *out_rightFlipperBody = &ctx->rightFlipperBody;
+    return 0;
+}
+
+/*
+ * physics_adaptive_substeps
+ *  - Picks a sub-step count so the fastest active ball moves at most
+ *    adaptiveTravelPerSubStep of its radius per sub-step, clamped to [1, maxSubSteps].
+ */
+static int physics_adaptive_substeps(GameStruct *game, float dt, int maxSubSteps) {
+    float maxSpeedSq = 0.0f;
+    float minRadius = ballSize / 2.0f;
+    for (int k = 0; k < game->numBalls; k++) {
+        b2Vec2 vel = game->balls[game->activeBalls[k]].velocity;
+        float speedSq = vel.x * vel.x + vel.y * vel.y;
+        if (speedSq > maxSpeedSq) {
+            maxSpeedSq = speedSq;
+        }
+    }
+
+    float travel = sqrtf(maxSpeedSq) * dt;
+    int subSteps = (int)ceilf(travel / (minRadius * adaptiveTravelPerSubStep));
+    if (subSteps < 1) {
+        subSteps = 1;
+    }
+    if (subSteps > maxSubSteps) {
+        subSteps = maxSubSteps;
+    }
+    return subSteps;
+}
+
+/*
+ * physics_set_quality
+ *  - Applies a solver quality preset: contact tuning on the world and the
+ *    bullet flag on every live ball. New balls pick up the flag in physics_add_ball.
+ */
+void physics_set_quality(GameStruct *game, PhysicsQuality quality) {
+    if (quality < 0 || quality >= PHYSICS_QUALITY_COUNT) {
+        quality = PHYSICS_QUALITY_ADAPTIVE;
+    }
+    game->physics->quality = quality;
+    const PhysicsQualityPreset *preset = &qualityPresets[quality];
+
+    b2World_SetContactTuning(game->world, preset->contactHertz, contactDampingRatio, contactPushSpeed);
+
+    for (int k = 0; k < game->numBalls; k++) {
+        b2Body_SetBullet(game->balls[game->activeBalls[k]].body, preset->bullets != 0);
+    }
+}
+
+PhysicsQuality physics_get_quality(const GameStruct *game) {
+    return game->physics->quality;
+}
+
+const char *physics_quality_name(PhysicsQuality quality) {
+    if (quality < 0 || quality >= PHYSICS_QUALITY_COUNT) {
+        return "unknown";
+    }
+    return qualityNames[quality];
+}
+
+int physics_get_last_substeps(const GameStruct *game) {
+    return game->physics->lastSubSteps;
+}
+
+void physics_set_profiler(GameStruct *game, PhysicsProfiler *profiler) {
+    game->physics->profiler = profiler;
+}
+
+void physics_set_state_hash(GameStruct *game, StateHashWriter *writer) {
+    game->physics->stateHash = writer;
 }
 
 /*
@@ -716,51 +1134,131 @@ void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFli
  *  - Advance the physics simulation by dt seconds.
  *  - All Box2D stepping should go through this function so we can
  *    centralize any future debug instrumentation or sub-stepping logic.
+ *  - Sub-step count comes from the active quality preset (see physics_set_quality).
  */
 void physics_step(GameStruct *game, float dt) {
     //TraceLog(LOG_INFO, "[PHYSICS] stepping dt=%f", dt);
     
-    // Box2D 3.x step parameters
-    // Use subStepCount=1 to match Chipmunk's single-step behavior
-    // Higher substep counts can cause excessive velocity accumulation
-    int subStepCount = 1;
+    PhysicsContext *ctx = game->physics;
+    const PhysicsQualityPreset *preset = &qualityPresets[ctx->quality];
+    int subStepCount = preset->subSteps;
+    if (ctx->quality == PHYSICS_QUALITY_ADAPTIVE) {
+        subStepCount = physics_adaptive_substeps(game, dt, preset->subSteps);
+    }
+    ctx->lastSubSteps = subStepCount;
+
+    // Keep the pre-step transforms so frames between ticks can be interpolated.
+    // Velocity is rebuilt from the move events below; a ball without one did not move.
+    for (int k = 0; k < game->numBalls; k++) {
+        Ball *ball = &game->balls[game->activeBalls[k]];
+        ball->previousPosition = ball->position;
+        ball->velocity = pb2_v(0.0f, 0.0f);
+    }
+    game->previousFlipperAngles[0] = game->flipperAngles[0];
+    game->previousFlipperAngles[1] = game->flipperAngles[1];
+
+    // The water level eases in and out over a few seconds and is still otherwise
+    if (game->waterHeight != ctx->waterSensorHeight) {
+        physics_size_water_sensor(ctx, game->waterHeight);
+    }
+
     b2World_Step(game->world, dt, subStepCount);
-    
-    // Contact events are processed during PreSolveCallback
-    // which is called automatically during b2World_Step
-    
-    // Check for water intersections and apply ripple impulses
-    if (game->waterPowerupState > 0) {
-        // Water level in world coordinates (water rises from bottom)
-        float waterWorldY = worldHeight * (1.0f - game->waterHeight);
-        
-        for (int i = 0; i < maxBalls; i++) {
-            if (game->balls[i].active) {
-                b2Vec2 pos = b2Body_GetPosition(game->balls[i].body);
-                b2Vec2 vel = b2Body_GetLinearVelocity(game->balls[i].body);
-                
-                // Check if ball just entered water (was above, now at or below water level)
-                int wasUnderwater = game->balls[i].underwaterState;
-                int isUnderwater = (pos.y >= waterWorldY) ? 1 : 0;
-                
-                // On water entry, create ripple impulse
-                if (!wasUnderwater && isUnderwater) {
-                    // Map ball x-position (0 to worldWidth) to ripple index
-                    float impulse = fabsf(vel.y) * 0.0025f;
-                    AddWaterImpulse(pos.x, impulse);
-                }
-                
-                game->balls[i].underwaterState = isUnderwater;
-            }
+    if (ctx->profiler != NULL) {
+        PhysicsProfiler_AddStep(ctx->profiler, game->world);
+    }
+
+    // Cache ball state once; the rest of the tick and the renderer read the cache.
+    // Box2D reports every body that moved in one array, so this costs one call
+    // per step instead of a position and a velocity query per ball. Velocity is
+    // the average over the step (displacement / dt), which is what splashes and
+    // adaptive sub-stepping need. A ball that falls asleep (slower than
+    // stuckBallSpeed for half a second) reports once with fellAsleep and then
+    // nothing until it wakes; Game_EndPlayfield times how long it sleeps.
+    b2BodyEvents bodyEvents = b2World_GetBodyEvents(game->world);
+    float invDt = (dt > 0.0f) ? 1.0f / dt : 0.0f;
+    for (int e = 0; e < bodyEvents.moveCount; e++) {
+        const b2BodyMoveEvent *move = &bodyEvents.moveEvents[e];
+        if (tag_kind(move->userData) != SHAPE_KIND_BALL) {
+            continue;
+        }
+        Ball *ball = &game->balls[tag_index(move->userData)];
+        ball->position = move->transform.p;
+        ball->velocity = pb2_v((ball->position.x - ball->previousPosition.x) * invDt,
+                               (ball->position.y - ball->previousPosition.y) * invDt);
+        ball->asleep = move->fellAsleep;
+        if (!move->fellAsleep) {
+            ball->killCounter = 0;
         }
     }
+    game->flipperAngles[0] = b2Rot_GetAngle(b2Body_GetRotation(ctx->leftFlipperBody));
+    game->flipperAngles[1] = b2Rot_GetAngle(b2Body_GetRotation(ctx->rightFlipperBody));
+    
+    // Apply score/sound/animation for contacts that began during this step
+    physics_collect_events(game);
+    physics_drain_events(game);
+
+    if (ctx->stateHash != NULL) {
+        StateHashWriter_Add(ctx->stateHash, game);
+    }
     
     //TraceLog(LOG_INFO, "[PHYSICS] done");
 }
 
+/*
+ * physics_apply_buoyancy
+ *  - While the water is up, pushes every submerged ball upward (harder the
+ *    deeper it is) and kicks balls on the side of a moving flipper.
+ *  - Only balls the water sensor reported as underwater are gathered; their
+ *    positions go into contiguous scratch arrays (PhysicsContext.buoyancy) and
+ *    the forces are worked out in one loop without Box2D calls, then applied
+ *    with one b2Body_ApplyForceToCenter each.
+ *  - Box2D clears forces after every step, so call this before each physics_step.
+ */
+void physics_apply_buoyancy(GameStruct *game, int leftFlipperMoving, int rightFlipperMoving) {
+    if (game->waterHeight <= 0.0f || game->numBalls == 0) {
+        return;
+    }
+
+    BuoyancyScratch *scratch = &game->physics->buoyancy;
+    int *slot = scratch->slot;
+    float *posX = scratch->posX;
+    float *posY = scratch->posY;
+    float *forceY = scratch->forceY;
+    int count = 0;
+    for (int k = 0; k < game->numBalls; k++) {
+        const Ball *ball = &game->balls[game->activeBalls[k]];
+        if (ball->underwaterState) {
+            slot[count] = game->activeBalls[k];
+            posX[count] = ball->position.x;
+            posY[count] = ball->position.y;
+            count++;
+        }
+    }
+
+    const float waterY = worldHeight * (1.0f - game->waterHeight);
+    const float halfWidth = worldWidth / 2.0f;
+    const float flipperForce = -1000.0f;
+    const float leftKick = leftFlipperMoving ? flipperForce : 0.0f;
+    const float rightKick = rightFlipperMoving ? flipperForce : 0.0f;
+    for (int k = 0; k < count; k++) {
+        float depth = posY[k] - waterY;
+        float force = -200.0f - depth * 40.0f;
+        force += (posX[k] <= halfWidth) ? leftKick : 0.0f;
+        force += (posX[k] >= halfWidth) ? rightKick : 0.0f;
+        forceY[k] = (depth > 0.0f) ? force : 0.0f;
+    }
+
+    for (int k = 0; k < count; k++) {
+        if (forceY[k] != 0.0f) {
+            b2Body_ApplyForceToCenter(game->balls[slot[k]].body, pb2_v(0.0f, forceY[k]), true);
+        }
+    }
+}
+
 /*
  * physics_shutdown
- *  - Frees the Box2D world owned by this GameStruct.
+ *  - Frees the Box2D world owned by this GameStruct (including the pooled ball
+ *    bodies) and its worker threads.
  *  - Does not free GameStruct itself or any rendering data.
  */
 void physics_shutdown(GameStruct *game) {
@@ -768,6 +1266,23 @@ void physics_shutdown(GameStruct *game) {
         b2DestroyWorld(game->world);
         game->world = b2_nullWorldId;
     }
+    PhysicsContext *ctx = game->physics;
+    if (ctx == NULL) {
+        return;
+    }
+    TaskPool_Destroy(ctx->taskPool);
+    free(ctx->normalBallPool.free);
+    free(ctx->largeBallPool.free);
+    free(ctx->buoyancy.slot);
+    free(ctx->buoyancy.posX);
+    free(ctx->buoyancy.posY);
+    free(ctx->buoyancy.forceY);
+    free(ctx);
+    game->physics = NULL;
+}
+
+int physics_get_worker_count(const GameStruct *game) {
+    return TaskPool_GetWorkerCount(game->physics->taskPool);
 }
 
 /*
@@ -778,199 +1293,151 @@ void physics_shutdown(GameStruct *game) {
  *  - type     : gameplay type (0 = normal, 2 = large, etc.).
  *
  *  Notes:
- *    - Updates game->numBalls and initializes the Ball struct at the chosen index.
+ *    - Takes the next free slot from game->activeBalls and a parked body from
+ *      the normal or large ball pool; no Box2D bodies are created here.
+ *    - Initializes the Ball struct and its trail at the chosen index.
  *    - Plays the launch sound via the SoundManager.
  */
 void physics_add_ball(GameStruct *game, float px, float py, float vx, float vy, int type) {
-    if (game->numBalls < maxBalls) {
-        game->numBalls++;
-        // Find the first index that isn't active
-        int ballIndex = 0;
-        for (int i = 0; i < maxBalls; i++) {
-            if (game->balls[i].active == 0) {
-                ballIndex = i;
-                break;
-            }
-        }
-
-        float radius = ballSize / 2.0;
-        float mass = 1.0;
-        if (type == 2) {
-            radius = 10.0f;
-            mass = 2.0f;
-        }
-        
-        // Calculate density from mass to match Chipmunk behavior
-        // In Chipmunk: mass is set directly
-        // In Box2D: mass = density * area, where area = π * r²
-        // Therefore: density = mass / (π * r²)
-        float area = 3.14159265f * radius * radius;
-        float density = mass / area;
-
-        // Create ball body
-        b2BodyDef ballBodyDef = b2DefaultBodyDef();
-        ballBodyDef.type = b2_dynamicBody;
-        ballBodyDef.position = pb2_v(px, py);
-        ballBodyDef.linearVelocity = pb2_v(vx, vy);
-        game->balls[ballIndex].body = b2CreateBody(game->world, &ballBodyDef);
-
-        // Create ball shape
-        b2Circle ballCircle;
-        ballCircle.center = pb2_v(0, 0);
-        ballCircle.radius = radius;
-
-        b2ShapeDef ballShapeDef = b2DefaultShapeDef();
-        ballShapeDef.enableContactEvents = true;
-        ballShapeDef.enablePreSolveEvents = true;
-        ballShapeDef.material.friction = 0.0f;
-        ballShapeDef.material.restitution = 0.7f;
-        ballShapeDef.density = density;
-        ballShapeDef.filter.categoryBits = CATEGORY_BALL;
-        ballShapeDef.filter.maskBits =
-            CATEGORY_WALL |
-            CATEGORY_BUMPER |
-            CATEGORY_PADDLE |
-            CATEGORY_LEFT_LOWER_BUMPER |
-            CATEGORY_RIGHT_LOWER_BUMPER |
-            CATEGORY_ONE_WAY;
-        ballShapeDef.userData = &(game->balls[ballIndex]);
-
-        game->balls[ballIndex].shape = b2CreateCircleShape(game->balls[ballIndex].body, &ballShapeDef, &ballCircle);
-        game->balls[ballIndex].active = 1;
-        game->balls[ballIndex].game = game;
-        game->balls[ballIndex].trailStartIndex = 0;
-        game->balls[ballIndex].type = type;
-        game->balls[ballIndex].killCounter = 0;
-        game->balls[ballIndex].underwaterState = 0;
-
-        if (type == 0) {
-            game->slowMotion = 0;
-        }
+    if (game->numBalls >= maxBalls) {
+        return;
+    }
 
-        for (int i = 0; i < 16; i++) {
-            game->balls[ballIndex].locationHistoryX[i] = px;
-            game->balls[ballIndex].locationHistoryY[i] = py;
-        }
+    PhysicsContext *ctx = game->physics;
+    BallBodyPool *pool = (type == 2) ? &ctx->largeBallPool : &ctx->normalBallPool;
+    if (pool->freeCount == 0) {
+        printf("[PHYSICS] ball body pool (radius %.1f) exhausted, ball not spawned\n", pool->radius);
+        return;
+    }
+    PooledBallBody pooled = pool->free[--pool->freeCount];
+
+    // Free ball slots are kept after the active entries in game->activeBalls
+    int ballIndex = game->activeBalls[game->numBalls];
+    Ball *ball = &game->balls[ballIndex];
+    ball->activeIndex = game->numBalls;
+    game->numBalls++;
+
+    // Move the parked body into place, then enable it. Velocity can only be set
+    // once the body is back in the simulation.
+    ball->body = pooled.body;
+    ball->shape = pooled.shape;
+    b2Body_SetUserData(ball->body, shape_tag(SHAPE_KIND_BALL, ballIndex));
+    b2Shape_SetUserData(ball->shape, shape_tag(SHAPE_KIND_BALL, ballIndex));
+    b2Body_SetTransform(ball->body, pb2_v(px, py), b2Rot_identity);
+    b2Body_SetBullet(ball->body, qualityPresets[ctx->quality].bullets != 0);
+    b2Body_Enable(ball->body);
+    b2Body_SetLinearVelocity(ball->body, pb2_v(vx, vy));
+    b2Body_SetAngularVelocity(ball->body, 0.0f);
+    b2Body_SetAwake(ball->body, true);
+
+    ball->active = 1;
+    ball->type = type;
+    ball->killCounter = 0;
+    ball->asleep = 0;
+    ball->flipperContacts = 0;
+    ball->underwaterState = 0;
+    ball->position = pb2_v(px, py);
+    ball->previousPosition = ball->position;
+    ball->velocity = pb2_v(vx, vy);
+
+    if (type == 0) {
+        game->slowMotion = 0;
+    }
 
-        playLaunch(game->sound);
+    float *trailX = &game->trails.x[ballIndex * BALL_TRAIL_LENGTH];
+    float *trailY = &game->trails.y[ballIndex * BALL_TRAIL_LENGTH];
+    for (int i = 0; i < BALL_TRAIL_LENGTH; i++) {
+        trailX[i] = px;
+        trailY[i] = py;
     }
+    game->trails.head[ballIndex] = 0;
+
+    playLaunch(game->sound);
 }
 
 /*
- * Helper to draw a Box2D body and its shapes for debug visualization
+ * physics_remove_ball
+ *  - Disables the ball's body, returns it to its pool and swap-removes the
+ *    ball from game->activeBalls.
+ *  - The last active ball moves into the freed list position, so callers walking
+ *    the list while removing should walk it back to front.
  */
-static void debug_draw_body(b2BodyId bodyId, DebugColor outlineColor, DebugColor fillColor) {
-    if (B2_IS_NULL(bodyId)) {
+void physics_remove_ball(GameStruct *game, int ballIndex) {
+    Ball *ball = &game->balls[ballIndex];
+    if (!ball->active) {
         return;
     }
-    
-    b2Vec2 pos = b2Body_GetPosition(bodyId);
-    b2Rot rot = b2Body_GetRotation(bodyId);
-    float angle = b2Rot_GetAngle(rot);
-    
-    // Get shape IDs for this body
-    // Box2D 3.x requires iterating through shape IDs
-    // We'll use b2Body_GetShapes to get all shapes
-    int shapeCount = b2Body_GetShapeCount(bodyId);
-    if (shapeCount == 0) {
-        return;
+    if (ball->flipperContacts > 0) {
+        // Parked bodies keep their flags; the next ball from the pool must be able to sleep
+        b2Body_EnableSleep(ball->body, true);
+        ball->flipperContacts = 0;
     }
-    
-    b2ShapeId shapeIds[16]; // Max shapes per body
-    int actualCount = b2Body_GetShapes(bodyId, shapeIds, 16);
-    
-    for (int i = 0; i < actualCount; i++) {
-        b2ShapeId shapeId = shapeIds[i];
-        if (B2_IS_NULL(shapeId)) {
-            continue;
-        }
-        
-        b2ShapeType shapeType = b2Shape_GetType(shapeId);
-        
-        if (shapeType == b2_circleShape) {
-            b2Circle circle = b2Shape_GetCircle(shapeId);
-            Vec2 debugPos = {pos.x + circle.center.x, pos.y + circle.center.y};
-            ChipmunkDebugDrawCircle(debugPos, angle, circle.radius, outlineColor, fillColor);
-        } else if (shapeType == b2_segmentShape) {
-            b2Segment segment = b2Shape_GetSegment(shapeId);
-            // Transform segment points to world space
-            float cosA = cosf(angle);
-            float sinA = sinf(angle);
-            Vec2 p1 = {
-                pos.x + (segment.point1.x * cosA - segment.point1.y * sinA),
-                pos.y + (segment.point1.x * sinA + segment.point1.y * cosA)
-            };
-            Vec2 p2 = {
-                pos.x + (segment.point2.x * cosA - segment.point2.y * sinA),
-                pos.y + (segment.point2.x * sinA + segment.point2.y * cosA)
-            };
-            ChipmunkDebugDrawSegment(p1, p2, outlineColor);
-        } else if (shapeType == b2_polygonShape) {
-            b2Polygon polygon = b2Shape_GetPolygon(shapeId);
-            Vec2 verts[B2_MAX_POLYGON_VERTICES];
-            float cosA = cosf(angle);
-            float sinA = sinf(angle);
-            for (int v = 0; v < polygon.count; v++) {
-                verts[v].x = pos.x + (polygon.vertices[v].x * cosA - polygon.vertices[v].y * sinA);
-                verts[v].y = pos.y + (polygon.vertices[v].x * sinA + polygon.vertices[v].y * cosA);
-            }
-            ChipmunkDebugDrawPolygon(polygon.count, verts, 0.5f, outlineColor, fillColor);
-        }
+    b2Body_Disable(ball->body);
+    PhysicsContext *ctx = game->physics;
+    BallBodyPool *pool = (ball->type == 2) ? &ctx->largeBallPool : &ctx->normalBallPool;
+    pool->free[pool->freeCount].body = ball->body;
+    pool->free[pool->freeCount].shape = ball->shape;
+    pool->freeCount++;
+    ball->active = 0;
+
+    // Swap with the last active entry; the freed slot lands just past the active range
+    int slot = ball->activeIndex;
+    int lastSlot = game->numBalls - 1;
+    int last = game->activeBalls[lastSlot];
+    game->activeBalls[slot] = last;
+    game->balls[last].activeIndex = slot;
+    game->activeBalls[lastSlot] = ballIndex;
+    ball->activeIndex = lastSlot;
+    game->numBalls--;
+}
+
+// Adds or removes CATEGORY_BALL from one ball shape's mask
+static void physics_filter_ball_shape(b2ShapeId shape, int ballCollisions) {
+    b2Filter filter = b2Shape_GetFilter(shape);
+    if (ballCollisions) {
+        filter.maskBits |= CATEGORY_BALL;
+    } else {
+        filter.maskBits &= ~(uint64_t)CATEGORY_BALL;
     }
+    b2Shape_SetFilter(shape, filter);
 }
 
 /*
- * physics_debug_draw
- *  - Iterates through all bodies and shapes in the Box2D world and draws them
- *    using the debug draw API defined in physicsDebugDraw.h
- *  - This provides a visual representation of the physics simulation for debugging
+ * physics_set_ball_collisions
+ *  - Adds or removes CATEGORY_BALL from every ball shape's mask, parked bodies
+ *    included, so pooled balls keep the setting when they are spawned.
+ *  - Box2D already finds overlapping ball pairs in the broadphase and drops them
+ *    at the filter; with collisions on they become contacts for the (threaded)
+ *    solver. Ball shapes do not ask for contact or pre-solve events, so
+ *    ball-ball contacts reach neither physics_collect_events nor PreSolveCallback.
  */
-void physics_debug_draw(GameStruct *game) {
-    if (B2_IS_NULL(game->world)) {
+void physics_set_ball_collisions(GameStruct *game, int enabled) {
+    PhysicsContext *ctx = game->physics;
+    enabled = enabled != 0;
+    if (ctx->ballCollisions == enabled) {
         return;
     }
-    
-    // Define colors for different shape types
-    DebugColor wallColor = {0.6f, 0.6f, 0.6f, 1.0f};      // Light gray
-    DebugColor bumperColor = {1.0f, 0.4f, 0.4f, 1.0f};    // Red
-    DebugColor paddleColor = {0.4f, 1.0f, 0.4f, 1.0f};    // Green
-    DebugColor ballColor = {0.4f, 0.4f, 1.0f, 1.0f};      // Blue
-    DebugColor fillColor = {0.2f, 0.2f, 0.2f, 0.3f};      // Semi-transparent fill
-    
-    // Draw static body (walls and static geometry)
-    if (B2_IS_NON_NULL(debugState.staticBody)) {
-        debug_draw_body(debugState.staticBody, wallColor, fillColor);
-    }
-    
-    // Draw bumpers
-    for (int i = 0; i < debugState.numBumpers; i++) {
-        if (B2_IS_NON_NULL(debugState.bumpers[i].body)) {
-            debug_draw_body(debugState.bumpers[i].body, bumperColor, fillColor);
-        }
-    }
-    
-    // Draw flippers
-    if (debugState.leftFlipper != NULL) {
-        b2BodyId leftFlipperBody = *debugState.leftFlipper;
-        if (B2_IS_NON_NULL(leftFlipperBody)) {
-            debug_draw_body(leftFlipperBody, paddleColor, fillColor);
+    ctx->ballCollisions = enabled;
+
+    BallBodyPool *pools[2] = { &ctx->normalBallPool, &ctx->largeBallPool };
+    for (int p = 0; p < 2; p++) {
+        for (int i = 0; i < pools[p]->freeCount; i++) {
+            physics_filter_ball_shape(pools[p]->free[i].shape, enabled);
         }
     }
-    if (debugState.rightFlipper != NULL) {
-        b2BodyId rightFlipperBody = *debugState.rightFlipper;
-        if (B2_IS_NON_NULL(rightFlipperBody)) {
-            debug_draw_body(rightFlipperBody, paddleColor, fillColor);
-        }
-    }
-    
-    // Draw all active balls
-    for (int i = 0; i < maxBalls; i++) {
-        if (game->balls[i].active && B2_IS_NON_NULL(game->balls[i].body)) {
-            debug_draw_body(game->balls[i].body, ballColor, fillColor);
-        }
+    for (int k = 0; k < game->numBalls; k++) {
+        physics_filter_ball_shape(game->balls[game->activeBalls[k]].shape, enabled);
     }
 }
 
+/*
+ * physics_get_debug_state
+ *  - Exposes the bodies created by physics_init() to the debug renderer.
+ */
+const PhysicsDebugState *physics_get_debug_state(const GameStruct *game) {
+    return &game->physics->debugState;
+}
+
 // ============================================================================
 // FLIPPER CONTROL
 // ============================================================================
@@ -978,14 +1445,12 @@ void physics_debug_draw(GameStruct *game) {
 #define DEG_TO_RAD (3.14159265 / 180.0)
 #define RAD_TO_DEG (180.0 / 3.14159265)
 
-// Module-level state for flipper angles
-static float leftFlipperAngle = 0.0f;
-static float rightFlipperAngle = 0.0f;
-static float flipperSpeedScalar = 1.0f;
-
 void physics_flippers_init(GameStruct *game, b2BodyId *leftFlipperBody, b2BodyId *rightFlipperBody) {
-    leftFlipperAngle = flipperRestAngleLeft;
-    rightFlipperAngle = flipperRestAngleRight;
+    PhysicsContext *ctx = game->physics;
+    ctx->leftFlipperAngle = flipperRestAngleLeft;
+    ctx->rightFlipperAngle = flipperRestAngleRight;
+    game->flipperAngles[0] = game->previousFlipperAngles[0] = ctx->leftFlipperAngle * DEG_TO_RAD;
+    game->flipperAngles[1] = game->previousFlipperAngles[1] = ctx->rightFlipperAngle * DEG_TO_RAD;
     game->leftFlipperState = 0;
     game->rightFlipperState = 0;
 }
@@ -998,9 +1463,9 @@ void physics_flippers_update(GameStruct *game,
                               float dt,
                               float *out_leftDeltaAngularVelocity,
                               float *out_rightDeltaAngularVelocity) {
-    
-    float oldAngleLeft = leftFlipperAngle;
-    float oldAngleRight = rightFlipperAngle;
+    PhysicsContext *ctx = game->physics;
+    float oldAngleLeft = ctx->leftFlipperAngle;
+    float oldAngleRight = ctx->rightFlipperAngle;
     float targetAngleLeft = 0.0f;
     float targetAngleRight = 0.0f;
 
@@ -1011,9 +1476,9 @@ void physics_flippers_update(GameStruct *game,
             game->leftFlipperState = 1;
         }
         targetAngleLeft = flipperActiveAngleLeft;
-        leftFlipperAngle -= (flipperSpeed * dt);
-        if (leftFlipperAngle < targetAngleLeft) {
-            leftFlipperAngle = targetAngleLeft;
+        ctx->leftFlipperAngle -= (flipperSpeed * dt);
+        if (ctx->leftFlipperAngle < targetAngleLeft) {
+            ctx->leftFlipperAngle = targetAngleLeft;
         }
     } else {
         if (game->leftFlipperState == 1) {
@@ -1021,9 +1486,9 @@ void physics_flippers_update(GameStruct *game,
         }
         game->leftFlipperState = 0;
         targetAngleLeft = flipperRestAngleLeft;
-        leftFlipperAngle += (flipperSpeed * dt);
-        if (leftFlipperAngle > targetAngleLeft) {
-            leftFlipperAngle = targetAngleLeft;
+        ctx->leftFlipperAngle += (flipperSpeed * dt);
+        if (ctx->leftFlipperAngle > targetAngleLeft) {
+            ctx->leftFlipperAngle = targetAngleLeft;
         }
     }
 
@@ -1034,9 +1499,9 @@ void physics_flippers_update(GameStruct *game,
             game->rightFlipperState = 1;
         }
         targetAngleRight = flipperActiveAngleRight;
-        rightFlipperAngle += (flipperSpeed * dt);
-        if (rightFlipperAngle > targetAngleRight) {
-            rightFlipperAngle = targetAngleRight;
+        ctx->rightFlipperAngle += (flipperSpeed * dt);
+        if (ctx->rightFlipperAngle > targetAngleRight) {
+            ctx->rightFlipperAngle = targetAngleRight;
         }
     } else {
         if (game->rightFlipperState == 1) {
@@ -1044,29 +1509,33 @@ void physics_flippers_update(GameStruct *game,
         }
         game->rightFlipperState = 0;
         targetAngleRight = flipperRestAngleRight;
-        rightFlipperAngle -= (flipperSpeed * dt);
-        if (rightFlipperAngle < targetAngleRight) {
-            rightFlipperAngle = targetAngleRight;
+        ctx->rightFlipperAngle -= (flipperSpeed * dt);
+        if (ctx->rightFlipperAngle < targetAngleRight) {
+            ctx->rightFlipperAngle = targetAngleRight;
         }
     }
 
-    // Calculate delta angular velocities
+    // Angular velocity over the coming step
     float deltaAngularVelocityLeft = 0.0f;
     float deltaAngularVelocityRight = 0.0f;
     if (dt > 0.0f) {
-        deltaAngularVelocityLeft = ((leftFlipperAngle * DEG_TO_RAD) - (oldAngleLeft * DEG_TO_RAD)) / dt;
-        deltaAngularVelocityRight = ((rightFlipperAngle * DEG_TO_RAD) - (oldAngleRight * DEG_TO_RAD)) / dt;
+        deltaAngularVelocityLeft = ((ctx->leftFlipperAngle * DEG_TO_RAD) - (oldAngleLeft * DEG_TO_RAD)) / dt;
+        deltaAngularVelocityRight = ((ctx->rightFlipperAngle * DEG_TO_RAD) - (oldAngleRight * DEG_TO_RAD)) / dt;
     }
 
-    // Update Box2D bodies
-    b2Rot leftRot = b2MakeRot(leftFlipperAngle * DEG_TO_RAD);
-    b2Rot rightRot = b2MakeRot(rightFlipperAngle * DEG_TO_RAD);
-    b2Body_SetTransform(*leftFlipperBody, b2Body_GetPosition(*leftFlipperBody), leftRot);
-    b2Body_SetTransform(*rightFlipperBody, b2Body_GetPosition(*rightFlipperBody), rightRot);
-    b2Body_SetAngularVelocity(*leftFlipperBody, deltaAngularVelocityLeft * flipperSpeedScalar);
-    b2Body_SetAngularVelocity(*rightFlipperBody, deltaAngularVelocityRight * flipperSpeedScalar);
+    // Drive the kinematic bodies toward the new angles instead of teleporting them:
+    // b2Body_SetTargetTransform sets the angular velocity that lands on the target
+    // at the end of the step, so the solver sees the real surface speed (momentum
+    // transfer on a flip) and speculative contacts catch a ball in the path of a
+    // full stroke.
+    b2Transform leftTarget = { b2Body_GetPosition(*leftFlipperBody), b2MakeRot(ctx->leftFlipperAngle * DEG_TO_RAD) };
+    b2Transform rightTarget = { b2Body_GetPosition(*rightFlipperBody), b2MakeRot(ctx->rightFlipperAngle * DEG_TO_RAD) };
+    if (dt > 0.0f) {
+        b2Body_SetTargetTransform(*leftFlipperBody, leftTarget, dt);
+        b2Body_SetTargetTransform(*rightFlipperBody, rightTarget, dt);
+    }
 
-    // Return delta angular velocities for physics integration
+    // Return the angular velocities (rad/s) for the water flipper kick
     *out_leftDeltaAngularVelocity = deltaAngularVelocityLeft;
     *out_rightDeltaAngularVelocity = deltaAngularVelocityRight;
 }
\ No newline at end of file
@@ -4,28 +4,79 @@
 #include "gameStruct.h"
 #include "inputManager.h"
 #include "soundManager.h"
+#include "physicsProfile.h"
+#include "stateHash.h"
 
 // Initialize physics system (Box2D world, walls, bumpers, flippers, collision handlers)
 // Returns pointers to bumpers array, left flipper body, and right flipper body via out parameters
-void physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFlipperBody, b2BodyId **out_rightFlipperBody);
+// All physics state lives in game (game->world, game->physics), so separate
+// GameStructs can be stepped on separate threads. Box2D's world table is not
+// locked, so call physics_init and physics_shutdown from one thread only.
+// Returns 0, or -1 if Box2D could not create the world (it holds at most 128).
+int physics_init(GameStruct *game, Bumper **out_bumpers, b2BodyId **out_leftFlipperBody, b2BodyId **out_rightFlipperBody);
 
 // Step the physics simulation forward by dt seconds
 void physics_step(GameStruct *game, float dt);
 
+// Buoyancy forces on submerged balls for the next physics_step (no-op while the water is down)
+void physics_apply_buoyancy(GameStruct *game, int leftFlipperMoving, int rightFlipperMoving);
+
+// Solver quality presets (sub-steps, ball bullet flag, contact stiffness)
+typedef enum {
+    PHYSICS_QUALITY_LOW = 0,     // 1 sub-step, no bullets (original Chipmunk-like stepping)
+    PHYSICS_QUALITY_MEDIUM,      // 4 sub-steps, balls are bullets
+    PHYSICS_QUALITY_HIGH,        // 8 sub-steps, balls are bullets, stiffer contacts
+    PHYSICS_QUALITY_ADAPTIVE,    // 1-8 sub-steps picked each step from the fastest ball
+    PHYSICS_QUALITY_COUNT
+} PhysicsQuality;
+
+// Select a quality preset; applies contact tuning and the bullet flag to live balls
+void physics_set_quality(GameStruct *game, PhysicsQuality quality);
+PhysicsQuality physics_get_quality(const GameStruct *game);
+const char *physics_quality_name(PhysicsQuality quality);
+
+// Sub-steps used by the most recent physics_step (useful with PHYSICS_QUALITY_ADAPTIVE)
+int physics_get_last_substeps(const GameStruct *game);
+
+// Box2D solver threads in use, including the calling thread (from game->physicsWorkers)
+int physics_get_worker_count(const GameStruct *game);
+
+// Feed every physics_step's Box2D profile and counters into profiler (NULL to stop)
+void physics_set_profiler(GameStruct *game, PhysicsProfiler *profiler);
+
+// Append a state hash record after every physics_step (NULL to stop; see stateHash.h)
+void physics_set_state_hash(GameStruct *game, StateHashWriter *writer);
+
 // Clean up physics resources
 void physics_shutdown(GameStruct *game);
 
+// Whether balls collide with each other (MODE_MEGA_MULTIBALL). Refilters every
+// ball body, parked or active; Game_StartGame sets it from the game mode.
+void physics_set_ball_collisions(GameStruct *game, int enabled);
+
 // Add a ball to the physics simulation
 void physics_add_ball(GameStruct *game, float px, float py, float vx, float vy, int type);
 
-// Draw physics debug visualization (walls, bodies, shapes)
-void physics_debug_draw(GameStruct *game);
+// Destroy a ball and remove it from game->activeBalls (swap-remove; walk the list back to front)
+void physics_remove_ball(GameStruct *game, int ballIndex);
+
+// Bodies created by physics_init, kept for the debug renderer (physicsDebugDraw.c)
+typedef struct {
+    b2BodyId staticBody;      // The main static body holding all walls
+    b2BodyId *leftFlipper;    // Left flipper body pointer
+    b2BodyId *rightFlipper;   // Right flipper body pointer
+    Bumper *bumpers;          // Pointer to bumpers array
+    int numBumpers;           // Number of bumpers
+} PhysicsDebugState;
+
+const PhysicsDebugState *physics_get_debug_state(const GameStruct *game);
 
 // Initialize flipper system
 void physics_flippers_init(GameStruct *game, b2BodyId *leftFlipperBody, b2BodyId *rightFlipperBody);
 
-// Update flipper angles and sounds based on input
-// Returns the delta angular velocities for left and right flippers (for physics integration)
+// Update flipper angles and sounds based on input, and set the flipper bodies'
+// angular velocity so they reach the new angles at the end of the next physics_step
+// Returns the angular velocities for left and right flippers (rad/s)
 void physics_flippers_update(GameStruct *game,
                               b2BodyId *leftFlipperBody,
                               b2BodyId *rightFlipperBody,
@@ -35,8 +86,4 @@ void physics_flippers_update(GameStruct *game,
                               float *out_leftDeltaAngularVelocity,
                               float *out_rightDeltaAngularVelocity);
 
-// Animation state for lower bumpers (set by collision handlers, read by rendering code)
-extern float leftLowerBumperAnim;
-extern float rightLowerBumperAnim;
-
 #endif // PHYSICS_H
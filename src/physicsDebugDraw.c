@@ -3,6 +3,7 @@
 #include "constants.h"
 #include <stddef.h>
 #include "physicsDebugDraw.h"
+#include "physics.h"
 
 
 // Convert our generic DebugColor into a raylib Color
@@ -108,3 +109,123 @@ void ChipmunkDebugDrawDot(float size, Vec2 pos, DebugColor fillColor) {
 
     DrawCircle((int)sx, (int)sy, r, DebugColorToRaylib(fillColor));
 }
+
+/*
+ * Helper to draw a Box2D body and its shapes for debug visualization
+ */
+static void debug_draw_body(b2BodyId bodyId, DebugColor outlineColor, DebugColor fillColor) {
+    if (B2_IS_NULL(bodyId)) {
+        return;
+    }
+    
+    b2Vec2 pos = b2Body_GetPosition(bodyId);
+    b2Rot rot = b2Body_GetRotation(bodyId);
+    float angle = b2Rot_GetAngle(rot);
+    
+    // Get shape IDs for this body
+    // Box2D 3.x requires iterating through shape IDs
+    // We'll use b2Body_GetShapes to get all shapes
+    int shapeCount = b2Body_GetShapeCount(bodyId);
+    if (shapeCount == 0) {
+        return;
+    }
+    
+    // The static table body holds every wall and arc segment
+    b2ShapeId shapeIds[shapeCount];
+    int actualCount = b2Body_GetShapes(bodyId, shapeIds, shapeCount);
+    
+    for (int i = 0; i < actualCount; i++) {
+        b2ShapeId shapeId = shapeIds[i];
+        if (B2_IS_NULL(shapeId)) {
+            continue;
+        }
+        
+        b2ShapeType shapeType = b2Shape_GetType(shapeId);
+        
+        if (shapeType == b2_circleShape) {
+            b2Circle circle = b2Shape_GetCircle(shapeId);
+            Vec2 debugPos = {pos.x + circle.center.x, pos.y + circle.center.y};
+            ChipmunkDebugDrawCircle(debugPos, angle, circle.radius, outlineColor, fillColor);
+        } else if (shapeType == b2_segmentShape || shapeType == b2_chainSegmentShape) {
+            b2Segment segment = shapeType == b2_segmentShape ? b2Shape_GetSegment(shapeId)
+                                                             : b2Shape_GetChainSegment(shapeId).segment;
+            // Transform segment points to world space
+            float cosA = cosf(angle);
+            float sinA = sinf(angle);
+            Vec2 p1 = {
+                pos.x + (segment.point1.x * cosA - segment.point1.y * sinA),
+                pos.y + (segment.point1.x * sinA + segment.point1.y * cosA)
+            };
+            Vec2 p2 = {
+                pos.x + (segment.point2.x * cosA - segment.point2.y * sinA),
+                pos.y + (segment.point2.x * sinA + segment.point2.y * cosA)
+            };
+            ChipmunkDebugDrawSegment(p1, p2, outlineColor);
+        } else if (shapeType == b2_polygonShape) {
+            b2Polygon polygon = b2Shape_GetPolygon(shapeId);
+            Vec2 verts[B2_MAX_POLYGON_VERTICES];
+            float cosA = cosf(angle);
+            float sinA = sinf(angle);
+            for (int v = 0; v < polygon.count; v++) {
+                verts[v].x = pos.x + (polygon.vertices[v].x * cosA - polygon.vertices[v].y * sinA);
+                verts[v].y = pos.y + (polygon.vertices[v].x * sinA + polygon.vertices[v].y * cosA);
+            }
+            ChipmunkDebugDrawPolygon(polygon.count, verts, 0.5f, outlineColor, fillColor);
+        }
+    }
+}
+
+/*
+ * physics_debug_draw
+ *  - Iterates through all bodies and shapes in the Box2D world and draws them
+ *    using the debug draw API defined in physicsDebugDraw.h
+ *  - This provides a visual representation of the physics simulation for debugging
+ */
+void physics_debug_draw(const GameStruct *game) {
+    if (B2_IS_NULL(game->world)) {
+        return;
+    }
+    
+    const PhysicsDebugState *debugState = physics_get_debug_state(game);
+
+    // Define colors for different shape types
+    DebugColor wallColor = {0.6f, 0.6f, 0.6f, 1.0f};      // Light gray
+    DebugColor bumperColor = {1.0f, 0.4f, 0.4f, 1.0f};    // Red
+    DebugColor paddleColor = {0.4f, 1.0f, 0.4f, 1.0f};    // Green
+    DebugColor ballColor = {0.4f, 0.4f, 1.0f, 1.0f};      // Blue
+    DebugColor fillColor = {0.2f, 0.2f, 0.2f, 0.3f};      // Semi-transparent fill
+    
+    // Draw static body (walls and static geometry)
+    if (B2_IS_NON_NULL(debugState->staticBody)) {
+        debug_draw_body(debugState->staticBody, wallColor, fillColor);
+    }
+    
+    // Draw bumpers
+    for (int i = 0; i < debugState->numBumpers; i++) {
+        if (B2_IS_NON_NULL(debugState->bumpers[i].body)) {
+            debug_draw_body(debugState->bumpers[i].body, bumperColor, fillColor);
+        }
+    }
+    
+    // Draw flippers
+    if (debugState->leftFlipper != NULL) {
+        b2BodyId leftFlipperBody = *debugState->leftFlipper;
+        if (B2_IS_NON_NULL(leftFlipperBody)) {
+            debug_draw_body(leftFlipperBody, paddleColor, fillColor);
+        }
+    }
+    if (debugState->rightFlipper != NULL) {
+        b2BodyId rightFlipperBody = *debugState->rightFlipper;
+        if (B2_IS_NON_NULL(rightFlipperBody)) {
+            debug_draw_body(rightFlipperBody, paddleColor, fillColor);
+        }
+    }
+    
+    // Draw all active balls
+    for (int k = 0; k < game->numBalls; k++) {
+        const Ball *ball = &game->balls[game->activeBalls[k]];
+        if (B2_IS_NON_NULL(ball->body)) {
+            debug_draw_body(ball->body, ballColor, fillColor);
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #ifndef HEADER_PHYSICS_DEBUG_DRAW
 #define HEADER_PHYSICS_DEBUG_DRAW
 
+#include "gameStruct.h"
+
 // Minimal debug draw interface used with Box2D-based physics.
 // These functions are currently implemented as no-ops in physicsDebugDraw.c
 // so they won't break the build while we are focused on Box2D migration.
@@ -32,4 +34,7 @@ void ChipmunkDebugDrawDot(float size, Vec2 pos, DebugColor fillColor);
 
 DebugColor ChipmunkDebugGetColorForShape(void *shape, void *data);
 
+// Draw physics debug visualization (walls, bodies, shapes)
+void physics_debug_draw(const GameStruct *game);
+
 #endif
@@ -0,0 +1,141 @@
+/*
+ * physicsProfile.c - Per-tick physics profile ring (see physicsProfile.h)
+ */
+
+#include "physicsProfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct PhysicsProfilerObject {
+    PhysicsProfileSample samples[PHYSICS_PROFILE_CAPACITY];
+    long count;                     // ticks finished so far; the ring holds the last CAPACITY
+    PhysicsProfileSample current;   // tick in progress
+};
+
+PhysicsProfiler *PhysicsProfiler_Create(void) {
+    PhysicsProfiler *profiler = calloc(1, sizeof(PhysicsProfiler));
+    if (profiler == NULL) {
+        printf("PhysicsProfiler_Create: out of memory\n");
+    }
+    return profiler;
+}
+
+void PhysicsProfiler_Destroy(PhysicsProfiler *profiler) {
+    free(profiler);
+}
+
+void PhysicsProfiler_BeginTick(PhysicsProfiler *profiler) {
+    memset(&profiler->current, 0, sizeof(profiler->current));
+    profiler->current.tick = profiler->count;
+}
+
+void PhysicsProfiler_AddStep(PhysicsProfiler *profiler, b2WorldId world) {
+    PhysicsProfileSample *sample = &profiler->current;
+    b2Profile profile = b2World_GetProfile(world);
+    b2Counters counters = b2World_GetCounters(world);
+
+    sample->steps++;
+    sample->stepMs += profile.step;
+    sample->pairsMs += profile.pairs;
+    sample->collideMs += profile.collide;
+    sample->solveMs += profile.solve;
+    sample->continuousMs += profile.bullets;
+    sample->bodies = counters.bodyCount;
+    sample->shapes = counters.shapeCount;
+    sample->contacts = counters.contactCount;
+    sample->islands = counters.islandCount;
+}
+
+void PhysicsProfiler_EndTick(PhysicsProfiler *profiler, int numBalls, float tickMs) {
+    PhysicsProfileSample *sample = &profiler->current;
+    sample->balls = numBalls;
+    sample->tickMs = tickMs;
+    profiler->samples[profiler->count % PHYSICS_PROFILE_CAPACITY] = *sample;
+    profiler->count++;
+}
+
+int PhysicsProfiler_GetLatest(const PhysicsProfiler *profiler, PhysicsProfileSample *out) {
+    if (profiler->count == 0) {
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+    *out = profiler->samples[(profiler->count - 1) % PHYSICS_PROFILE_CAPACITY];
+    return 1;
+}
+
+#define PROFILE_MAX(field) if (s->field > out->field) { out->field = s->field; }
+
+void PhysicsProfiler_GetPeak(const PhysicsProfiler *profiler, int ticks, PhysicsProfileSample *out) {
+    memset(out, 0, sizeof(*out));
+    if (ticks > profiler->count) {
+        ticks = (int)profiler->count;
+    }
+    if (ticks > PHYSICS_PROFILE_CAPACITY) {
+        ticks = PHYSICS_PROFILE_CAPACITY;
+    }
+    for (long t = profiler->count - ticks; t < profiler->count; t++) {
+        const PhysicsProfileSample *s = &profiler->samples[t % PHYSICS_PROFILE_CAPACITY];
+        PROFILE_MAX(steps);
+        PROFILE_MAX(balls);
+        PROFILE_MAX(tickMs);
+        PROFILE_MAX(stepMs);
+        PROFILE_MAX(pairsMs);
+        PROFILE_MAX(collideMs);
+        PROFILE_MAX(solveMs);
+        PROFILE_MAX(continuousMs);
+        PROFILE_MAX(bodies);
+        PROFILE_MAX(shapes);
+        PROFILE_MAX(contacts);
+        PROFILE_MAX(islands);
+    }
+    out->tick = profiler->count - 1;
+}
+
+static int path_is_json(const char *path) {
+    size_t length = strlen(path);
+    return length >= 5 && strcmp(path + length - 5, ".json") == 0;
+}
+
+int PhysicsProfiler_Write(const PhysicsProfiler *profiler, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("PhysicsProfiler_Write: cannot open %s\n", path);
+        return -1;
+    }
+
+    int json = path_is_json(path);
+    long first = profiler->count > PHYSICS_PROFILE_CAPACITY ? profiler->count - PHYSICS_PROFILE_CAPACITY : 0;
+    if (json) {
+        fprintf(file, "[\n");
+    } else {
+        fprintf(file, "tick,steps,balls,tick_ms,step_ms,pairs_ms,collide_ms,solve_ms,continuous_ms,"
+                      "bodies,shapes,contacts,islands\n");
+    }
+    for (long t = first; t < profiler->count; t++) {
+        const PhysicsProfileSample *s = &profiler->samples[t % PHYSICS_PROFILE_CAPACITY];
+        if (json) {
+            fprintf(file, "  {\"tick\": %ld, \"steps\": %d, \"balls\": %d, \"tick_ms\": %.4f, "
+                          "\"step_ms\": %.4f, \"pairs_ms\": %.4f, \"collide_ms\": %.4f, "
+                          "\"solve_ms\": %.4f, \"continuous_ms\": %.4f, \"bodies\": %d, "
+                          "\"shapes\": %d, \"contacts\": %d, \"islands\": %d}%s\n",
+                    s->tick, s->steps, s->balls, s->tickMs, s->stepMs, s->pairsMs, s->collideMs,
+                    s->solveMs, s->continuousMs, s->bodies, s->shapes, s->contacts, s->islands,
+                    t + 1 < profiler->count ? "," : "");
+        } else {
+            fprintf(file, "%ld,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d\n",
+                    s->tick, s->steps, s->balls, s->tickMs, s->stepMs, s->pairsMs, s->collideMs,
+                    s->solveMs, s->continuousMs, s->bodies, s->shapes, s->contacts, s->islands);
+        }
+    }
+    if (json) {
+        fprintf(file, "]\n");
+    }
+
+    if (fclose(file) != 0) {
+        printf("PhysicsProfiler_Write: write to %s failed\n", path);
+        return -1;
+    }
+    printf("Wrote %ld profile samples to %s\n", profiler->count - first, path);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef PHYSICS_PROFILE_H
+#define PHYSICS_PROFILE_H
+
+#include <box2d/box2d.h>
+
+/*
+ * physicsProfile.h - Per-tick physics profile ring
+ *
+ * Every game tick the runner (simThread.c, simMain.c) brackets its work with
+ * PhysicsProfiler_BeginTick / PhysicsProfiler_EndTick, and physics_step adds
+ * Box2D's b2Profile and b2Counters after each b2World_Step. A sample therefore
+ * splits the tick into Box2D's own phases and everything else (game rules,
+ * event handling, ball bookkeeping), which is what tells a collide spike from
+ * a solve spike from our own loops.
+ *
+ * The ring keeps the last PHYSICS_PROFILE_CAPACITY ticks; PhysicsProfiler_Write
+ * dumps them oldest first as CSV, or JSON when the path ends in ".json".
+ */
+
+// Five minutes at 60 ticks per second
+#define PHYSICS_PROFILE_CAPACITY 18000
+
+typedef struct {
+    long tick;              // ticks since the profiler was created
+    int steps;              // b2World_Step calls in the tick
+    int balls;              // active balls at the end of the tick
+    // Milliseconds, summed over the tick's steps
+    float tickMs;           // the whole tick: game logic plus physics (from the runner)
+    float stepMs;           // b2World_Step
+    float pairsMs;          // broadphase pair finding
+    float collideMs;        // narrowphase contact updates
+    float solveMs;          // constraint solver, integration and islands
+    float continuousMs;     // continuous collision for bullets
+    // Box2D counters after the tick's last step
+    int bodies;
+    int shapes;             // one broadphase proxy per shape
+    int contacts;
+    int islands;
+} PhysicsProfileSample;
+
+typedef struct PhysicsProfilerObject PhysicsProfiler;
+
+PhysicsProfiler *PhysicsProfiler_Create(void);
+void PhysicsProfiler_Destroy(PhysicsProfiler *profiler);
+
+void PhysicsProfiler_BeginTick(PhysicsProfiler *profiler);
+
+// Called by physics_step after b2World_Step
+void PhysicsProfiler_AddStep(PhysicsProfiler *profiler, b2WorldId world);
+
+// tickMs is the time the runner spent on the tick, leaving out any sleeps between steps
+void PhysicsProfiler_EndTick(PhysicsProfiler *profiler, int numBalls, float tickMs);
+
+// Most recent finished tick. Returns 0 if there is none yet.
+int PhysicsProfiler_GetLatest(const PhysicsProfiler *profiler, PhysicsProfileSample *out);
+
+// Per-field maximum over the last `ticks` finished ticks (tick is the latest one's)
+void PhysicsProfiler_GetPeak(const PhysicsProfiler *profiler, int ticks, PhysicsProfileSample *out);
+
+// Dump the ring. Returns 0 on success, -1 (after printing why) on failure.
+int PhysicsProfiler_Write(const PhysicsProfiler *profiler, const char *path);
+
+#endif // PHYSICS_PROFILE_H
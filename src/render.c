@@ -1,5 +1,8 @@
 #include "render.h"
 #include "constants.h"
+#include "physicsDebugDraw.h"
+#include "rlgl.h"
+#include "textRun.h"
 #include <math.h>
 #include <sys/time.h>
 
@@ -13,39 +16,105 @@ static long long millis() {
     return milliseconds;
 }
 
-void Render_Gameplay(const GameStruct *game, const Resources *res,
-                     const Bumper *bumpers, int numBumpers,
-                     b2BodyId leftFlipperBody, b2BodyId rightFlipperBody,
-                     float shaderSeconds, float iceOverlayAlpha,
-                     int debugDrawEnabled, long long elapsedTimeStart) {
-    
-    const float ballSize = 5.0f;
-    const float bumperSize = 10.0f;
-    const float smallBumperSize = 4.0f;
-    const int maxBalls = 256;
-    
-    ClearBackground((Color){40,1,42,255});
+// The launch prompt's text (see textRun.h)
+static TextRun ballTextRun;
+static TextRun launchPromptRun;
+
+// Trail sample ii (1 = oldest .. BALL_TRAIL_LENGTH = newest) is drawn at
+// ballSize * trailScale[ii - 1], so the trail tapers toward its tail
+static float trailScale[BALL_TRAIL_LENGTH];
+static int trailScaleReady = 0;
+
+// Atlas texture coordinates of a sprite: u0, v0, u1, v1
+static void render_sprite_uv(const Resources *res, int sprite, float uv[4]) {
+    Rectangle source = res->sprites[sprite];
+    uv[0] = source.x / res->spriteAtlas.width;
+    uv[1] = source.y / res->spriteAtlas.height;
+    uv[2] = (source.x + source.width) / res->spriteAtlas.width;
+    uv[3] = (source.y + source.height) / res->spriteAtlas.height;
+}
 
-    // Draw powerup status under game background
-    float powerupProportion = game->powerupScoreDisplay / 5000.0f;
-    if (powerupProportion > 1.0f){ powerupProportion = 1.0f; }
-    float powerupFullY = 64.0f;
-    float powerupEmptyY = 104.4f;
-    float powerupHeight = (powerupEmptyY - powerupFullY) * 2;
-    float powerupY = powerupFullY - (powerupProportion * powerupHeight / 2.0f);
-    BeginShaderMode(res->swirlShader);
-    DrawTexturePro(res->waterTex,(Rectangle){0,0,res->waterTex.width,res->waterTex.height},(Rectangle){30 * worldToScreen,powerupY* worldToScreen,powerupHeight* worldToScreen,powerupHeight* worldToScreen},(Vector2){0,0},0,WHITE);
-    EndShaderMode();
+// One quad centred on (x, y) with half-extent `half`, in screen pixels, added
+// to the current rlgl batch inside rlBegin(RL_QUADS). Same corners and
+// texture coordinates as DrawTexturePro with the sprite's atlas rect as source.
+static void render_batch_quad(float x, float y, float half, const float uv[4]) {
+    rlTexCoord2f(uv[0], uv[1]);
+    rlVertex2f(x - half, y - half);
+    rlTexCoord2f(uv[0], uv[3]);
+    rlVertex2f(x - half, y + half);
+    rlTexCoord2f(uv[2], uv[3]);
+    rlVertex2f(x + half, y + half);
+    rlTexCoord2f(uv[2], uv[1]);
+    rlVertex2f(x + half, y - half);
+}
 
-    DrawTexturePro(res->bgTex,(Rectangle){0,0,res->bgTex.width,res->bgTex.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
+static Color render_ball_color(const GameStruct *game, const Ball *ball) {
+    if (game->slowMotion == 1) { return WHITE; }
+    if (ball->type == 1) { return BLUE; }
+    return (Color){255,183,0,255};
+}
+
+/*
+ * render_trails_and_balls
+ *  - Writes every trail sample of every active ball, then every ball, straight
+ *    into rlgl's vertex batch: one quad each, colour set once per ball. Both
+ *    sprites are in the atlas, so with it bound once that is a single draw for
+ *    all trails and balls (more only when a batch fills up, e.g. the
+ *    2048-quad GLES2 batch on the Pi with many balls in play), instead of a
+ *    DrawTexturePro call per quad.
+ */
+static void render_trails_and_balls(const GameStruct *game, const Resources *res, float alpha) {
+    const Ball *balls = game->balls;
+    const BallTrails *trails = &game->trails;
+
+    if (!trailScaleReady) {
+        for (int ii = 1; ii <= BALL_TRAIL_LENGTH; ii++) {
+            trailScale[ii - 1] = sqrtf(ii / (float)BALL_TRAIL_LENGTH);
+        }
+        trailScaleReady = 1;
+    }
 
-    if (game->redPowerupOverlay > 0.0f){
-        DrawTexturePro(res->redPowerupOverlay,(Rectangle){0,0,res->bgTex.width,res->bgTex.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,(Color){255,255,255,40.0*game->redPowerupOverlay});
+    float trailUV[4];
+    float ballUV[4];
+    render_sprite_uv(res, SPRITE_TRAIL, trailUV);
+    render_sprite_uv(res, SPRITE_BALL, ballUV);
+
+    rlSetTexture(res->spriteAtlas.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int k = 0; k < game->numBalls; k++) {
+        int i = game->activeBalls[k];
+        const float *trailX = &trails->x[i * BALL_TRAIL_LENGTH];
+        const float *trailY = &trails->y[i * BALL_TRAIL_LENGTH];
+        Color color = render_ball_color(game, &balls[i]);
+        rlCheckRenderBatchLimit(4 * BALL_TRAIL_LENGTH);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        // Oldest sample first, so newer ones draw on top
+        int index = trails->head[i];
+        for (int ii = 0; ii < BALL_TRAIL_LENGTH; ii++) {
+            float half = ballSize * trailScale[ii] * worldToScreen * 0.5f;
+            render_batch_quad(trailX[index] * worldToScreen, trailY[index] * worldToScreen, half, trailUV);
+            if (++index == BALL_TRAIL_LENGTH) { index = 0; }
+        }
     }
 
-    // render bumpers which belong behind balls.
+    const float ballHalf = ballSize * worldToScreen * 0.5f;
+    for (int k = 0; k < game->numBalls; k++) {
+        int i = game->activeBalls[k];
+        b2Vec2 pos = b2Lerp(balls[i].previousPosition, balls[i].position, alpha);
+        Color color = render_ball_color(game, &balls[i]);
+        rlCheckRenderBatchLimit(4);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        render_batch_quad(pos.x * worldToScreen, pos.y * worldToScreen, ballHalf, ballUV);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+// Lane targets (type 2 and 3 bumpers), which belong behind the balls
+static void render_lane_targets(const Resources *res, const Bumper *bumpers, int numBumpers) {
     for (int i = 0; i < numBumpers; i++){
-        b2Vec2 pos = b2Body_GetPosition(bumpers[i].body);
+        b2Vec2 pos = bumpers[i].position;
         if (bumpers[i].type == 2 || bumpers[i].type == 3){
             float width = 8.0f;
             float height = 2.0f;
@@ -60,48 +129,122 @@ void Render_Gameplay(const GameStruct *game, const Resources *res,
                     bumperColor = BLUE;
                 }
             }
-            DrawTexturePro(res->bumper3,(Rectangle){0,0,res->bumper3.width,res->bumper3.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},bumpers[i].angle,bumperColor);
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_BUMPER3],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},bumpers[i].angle,bumperColor);
         }
     }
+}
 
-    // Render ball trails
-    Ball *balls = game->balls;
-    for (int i = 0; i < maxBalls; i++){
-        if (balls[i].active == 1){
-            for (int ii = 1; ii <= 16; ii++){
-                int index = (balls[i].trailStartIndex + ii - 1);
-                if (index >= 16){ index -= 16; }
-                float trailSize = ballSize * sqrt(ii/16.0f);
-                Color ballColor = (Color){255,183,0,255};
-                if (balls[i].type == 1){ ballColor = BLUE; }
-                if (game->slowMotion == 1){ ballColor = WHITE; }
-                DrawTexturePro(res->trailTex,(Rectangle){0,0,res->trailTex.width,res->trailTex.height},(Rectangle){balls[i].locationHistoryX[index] * worldToScreen,balls[i].locationHistoryY[index] * worldToScreen,trailSize * worldToScreen,trailSize * worldToScreen},(Vector2){(trailSize / 2.0) * worldToScreen,(trailSize / 2.0) * worldToScreen},0,ballColor);
-
-            }
+static unsigned int render_lane_target_bits(const Bumper *bumpers, int numBumpers) {
+    unsigned int bits = 0;
+    for (int i = 0; i < numBumpers; i++){
+        if ((bumpers[i].type == 2 || bumpers[i].type == 3) && bumpers[i].enabled){
+            bits |= 1u << i;
         }
     }
+    return bits;
+}
+
+void Render_InitStaticLayer(RenderStaticLayer *layer) {
+    layer->target = LoadRenderTexture(screenWidth, screenHeight);
+    SetTextureFilter(layer->target.texture, TEXTURE_FILTER_POINT);
+    layer->laneTargets = 0;
+    layer->baked = 0;
+}
+
+void Render_UnloadStaticLayer(RenderStaticLayer *layer) {
+    UnloadRenderTexture(layer->target);
+    layer->baked = 0;
+}
+
+void Render_UpdateStaticLayer(RenderStaticLayer *layer, const Resources *res,
+                              const Bumper *bumpers, int numBumpers) {
+    // One bit per bumper; a table with more bumpers is always drawn live
+    if (numBumpers > 32 || !IsRenderTextureValid(layer->target)){
+        layer->baked = 0;
+        return;
+    }
+    unsigned int laneTargets = render_lane_target_bits(bumpers, numBumpers);
+    if (layer->baked && laneTargets == layer->laneTargets){
+        return;
+    }
+
+    // Colour blended as usual but alpha accumulated, so the texture holds
+    // premultiplied colour and coverage for BLEND_ALPHA_PREMULTIPLY
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    DrawTexturePro(res->bgTex,(Rectangle){0,0,res->bgTex.width,res->bgTex.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
+    render_lane_targets(res, bumpers, numBumpers);
+    EndBlendMode();
+    EndTextureMode();
+
+    layer->laneTargets = laneTargets;
+    layer->baked = 1;
+}
+
+// Angle between two physics states along the shorter way round (b2Rot angles wrap at +-pi)
+static float lerp_angle(float from, float to, float alpha) {
+    float delta = to - from;
+    if (delta > PI) { delta -= 2.0f * PI; }
+    if (delta < -PI) { delta += 2.0f * PI; }
+    return from + delta * alpha;
+}
+
+void Render_Gameplay(const GameStruct *game, const Resources *res,
+                     const Bumper *bumpers, int numBumpers,
+                     const RenderStaticLayer *staticLayer,
+                     float shaderSeconds, float iceOverlayAlpha,
+                     int debugDrawEnabled, long long elapsedTimeStart,
+                     float alpha) {
+    
+    const float bumperSize = 10.0f;
+    const float smallBumperSize = 4.0f;
+    
+    ClearBackground((Color){40,1,42,255});
+
+    // Draw powerup status under game background
+    float powerupProportion = game->powerupScoreDisplay / 5000.0f;
+    if (powerupProportion > 1.0f){ powerupProportion = 1.0f; }
+    float powerupFullY = 64.0f;
+    float powerupEmptyY = 104.4f;
+    float powerupHeight = (powerupEmptyY - powerupFullY) * 2;
+    float powerupY = powerupFullY - (powerupProportion * powerupHeight / 2.0f);
+    BeginShaderMode(res->swirlShader);
+    DrawTexturePro(res->waterTex,(Rectangle){0,0,res->waterTex.width,res->waterTex.height},(Rectangle){30 * worldToScreen,powerupY* worldToScreen,powerupHeight* worldToScreen,powerupHeight* worldToScreen},(Vector2){0,0},0,WHITE);
+    EndShaderMode();
 
-    //render balls
-    for (int i = 0; i < maxBalls; i++){
-        if (balls[i].active == 1){
-            b2Vec2 pos = b2Body_GetPosition(balls[i].body);
-            Color ballColor = (Color){255,183,0,255};
-            if (balls[i].type == 1){ ballColor = BLUE; }
-            if (game->slowMotion == 1){ ballColor = WHITE; }
-            DrawTexturePro(res->ballTex,(Rectangle){0,0,res->ballTex.width,res->ballTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,ballSize * worldToScreen,ballSize * worldToScreen},(Vector2){(ballSize / 2.0) * worldToScreen,(ballSize / 2.0) * worldToScreen},0,ballColor);
+    // The red powerup overlay goes between the background and the lane
+    // targets, so while it shows the layer is drawn live
+    if (staticLayer != NULL && staticLayer->baked && game->redPowerupOverlay <= 0.0f){
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(staticLayer->target.texture,(Rectangle){0,0,screenWidth,-screenHeight},(Vector2){0,0},WHITE);
+        EndBlendMode();
+    } else {
+        DrawTexturePro(res->bgTex,(Rectangle){0,0,res->bgTex.width,res->bgTex.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
+
+        if (game->redPowerupOverlay > 0.0f){
+            DrawTexturePro(res->redPowerupOverlay,(Rectangle){0,0,res->bgTex.width,res->bgTex.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,(Color){255,255,255,40.0*game->redPowerupOverlay});
         }
+
+        render_lane_targets(res, bumpers, numBumpers);
     }
 
+    // Trails, then balls (see render_trails_and_balls). Everything from here
+    // to the flippers below is an atlas sprite, so raylib draws it all in one
+    // batch.
+    render_trails_and_balls(game, res, alpha);
+
     // Render bumpers which belong in front of balls
     for (int i = 0; i < numBumpers; i++){
-        b2Vec2 pos = b2Body_GetPosition(bumpers[i].body);
+        b2Vec2 pos = bumpers[i].position;
         if (bumpers[i].type == 0){
             float bounceScale = 0.2f;
             float width = bumperSize + cos(millis() / 20.0) * bumpers[i].bounceEffect * bounceScale;
             float height = bumperSize + sin(millis() / 20.0) * bumpers[i].bounceEffect * bounceScale;
             float shockSize = (bumperSize * bumpers[i].bounceEffect) * 0.15f;
-            DrawTexturePro(res->shockwaveTex,(Rectangle){0,0,res->shockwaveTex.width,res->shockwaveTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){shockSize/2 * worldToScreen,shockSize/2 * worldToScreen},0,WHITE);
-            DrawTexturePro(res->bumperTex,(Rectangle){0,0,res->bumperTex.width,res->bumperTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},0,WHITE);
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_SHOCKWAVE],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){shockSize/2 * worldToScreen,shockSize/2 * worldToScreen},0,WHITE);
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_BUMPER],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},0,WHITE);
         } else if (bumpers[i].type == 1){
             // Ice bumper (slow-mo powerup)
             float width = 6.0f;
@@ -123,20 +266,20 @@ void Render_Gameplay(const GameStruct *game, const Resources *res,
             }
             
             // Draw ice bumper with calculated alpha
-            DrawTexturePro(res->iceBumperTex,(Rectangle){0,0,res->iceBumperTex.width,res->iceBumperTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,bumperAlpha});
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_ICE_BUMPER],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,bumperAlpha});
             
             // Only draw visual effects when powerup is available or explosion is active
             if (game->slowMoPowerupAvailable == 1 || game->slowMoExplosionEffect > 0.0f) {
                 // Draw regular bounce effect
                 if (bumpers[i].bounceEffect > 0.0f) {
-                    DrawTexturePro(res->trailTex,(Rectangle){0,0,res->trailTex.width,res->trailTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){(shockSize / 2.0) * worldToScreen,(shockSize / 2.0) * worldToScreen},0,(Color){255,255,255,255 * shockPercent});
+                    DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_TRAIL],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){(shockSize / 2.0) * worldToScreen,(shockSize / 2.0) * worldToScreen},0,(Color){255,255,255,255 * shockPercent});
                 }
                 
                 // Draw explosion effect when triggered
                 if (game->slowMoExplosionEffect > 0.0f) {
                     float explosionSize = 25.0f * (1.0f - game->slowMoExplosionEffect);
                     int explosionAlpha = (int)(255 * game->slowMoExplosionEffect);
-                    DrawTexturePro(res->shockwaveTex,(Rectangle){0,0,res->shockwaveTex.width,res->shockwaveTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,explosionSize * worldToScreen,explosionSize * worldToScreen},(Vector2){(explosionSize / 2.0) * worldToScreen,(explosionSize / 2.0) * worldToScreen},0,(Color){255,255,255,explosionAlpha});
+                    DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_SHOCKWAVE],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,explosionSize * worldToScreen,explosionSize * worldToScreen},(Vector2){(explosionSize / 2.0) * worldToScreen,(explosionSize / 2.0) * worldToScreen},0,(Color){255,255,255,explosionAlpha});
                 }
             }
 
@@ -148,45 +291,45 @@ void Render_Gameplay(const GameStruct *game, const Resources *res,
             height *= bumpers[i].enabledSize;
             float shockSize = (smallBumperSize * bumpers[i].bounceEffect) * 0.15f;
             shockSize *= bumpers[i].enabledSize;
-            DrawTexturePro(res->shockwaveTex,(Rectangle){0,0,res->shockwaveTex.width,res->shockwaveTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){shockSize/2 * worldToScreen,shockSize/2 * worldToScreen},0,RED);
-            DrawTexturePro(res->bumperLightTex,(Rectangle){0,0,res->bumperTex.width,res->bumperTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},0,RED);
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_SHOCKWAVE],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,shockSize * worldToScreen,shockSize * worldToScreen},(Vector2){shockSize/2 * worldToScreen,shockSize/2 * worldToScreen},0,RED);
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_BUMPER_LIGHT],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},0,RED);
         }
     }
 
     //render lower bumpers
-    if (leftLowerBumperAnim > 0.0f){
-        float percent = 1.0f - leftLowerBumperAnim;
+    if (game->leftLowerBumperAnim > 0.0f){
+        float percent = 1.0f - game->leftLowerBumperAnim;
         float x = 10.0f;
         float y = 117.2f;
         float width = 8.0f+ (2.0f * percent);
         float height = 18.0f + (4.0f * percent);
         float angle = -24.0f + sin(shaderSeconds * 100.0f) * 10.0f;
-        DrawTexturePro(res->lowerBumperShock,(Rectangle){0,0,res->lowerBumperShock.width,res->lowerBumperShock.height},(Rectangle){x * worldToScreen,y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,255* (1.0f -percent)});
+        DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_LOWER_BUMPER_SHOCK],(Rectangle){x * worldToScreen,y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,255* (1.0f -percent)});
     }
-    if (rightLowerBumperAnim > 0.0f){
-        float percent = 1.0f - rightLowerBumperAnim;
+    if (game->rightLowerBumperAnim > 0.0f){
+        float percent = 1.0f - game->rightLowerBumperAnim;
         float x = 73.2f;
         float y = 117.2f;
         float width = 8.0f+ (2.0f * percent);
         float height = 18.0f + (4.0f * percent);
         float angle = 24.0f - sin(shaderSeconds * 100.0f) * 10.0f;
-        DrawTexturePro(res->lowerBumperShock,(Rectangle){0,0,res->lowerBumperShock.width,res->lowerBumperShock.height},(Rectangle){x * worldToScreen,y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,255* (1.0f -percent)});
+        DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_LOWER_BUMPER_SHOCK],(Rectangle){x * worldToScreen,y * worldToScreen,width * worldToScreen,height * worldToScreen},(Vector2){(width / 2.0) * worldToScreen,(height / 2.0) * worldToScreen},angle,(Color){255,255,255,255* (1.0f -percent)});
 
     }
 
     // Render left flipper
-    b2Vec2 pos = b2Body_GetPosition(leftFlipperBody);
-    float angle = b2Rot_GetAngle(b2Body_GetRotation(leftFlipperBody));
+    b2Vec2 pos = game->flipperPositions[0];
+    float angle = lerp_angle(game->previousFlipperAngles[0], game->flipperAngles[0], alpha);
     // The collision shape is offset by (-flipperHeight/2, -flipperHeight/2) in local space
     // So the texture origin (pivot) should be at (flipperHeight/2, flipperHeight/2) to match
-    DrawTexturePro(res->leftFlipperTex,(Rectangle){0,0,res->leftFlipperTex.width,res->leftFlipperTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,flipperWidth * worldToScreen,flipperHeight * worldToScreen},(Vector2){(flipperHeight / 2.0f) * worldToScreen,(flipperHeight / 2.0f) * worldToScreen},(angle * RAD_TO_DEG),WHITE);
+    DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_LEFT_FLIPPER],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,flipperWidth * worldToScreen,flipperHeight * worldToScreen},(Vector2){(flipperHeight / 2.0f) * worldToScreen,(flipperHeight / 2.0f) * worldToScreen},(angle * RAD_TO_DEG),WHITE);
 
     // Render right flipper
-    pos = b2Body_GetPosition(rightFlipperBody);
-    angle = b2Rot_GetAngle(b2Body_GetRotation(rightFlipperBody));
+    pos = game->flipperPositions[1];
+    angle = lerp_angle(game->previousFlipperAngles[1], game->flipperAngles[1], alpha);
     // The collision shape is offset by (-flipperHeight/2, -flipperHeight/2) in local space
     // So the texture origin (pivot) should be at (flipperHeight/2, flipperHeight/2) to match
-    DrawTexturePro(res->rightFlipperTex,(Rectangle){0,0,res->rightFlipperTex.width,res->rightFlipperTex.height},(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,flipperWidth * worldToScreen,flipperHeight * worldToScreen},(Vector2){(flipperHeight / 2.0f) * worldToScreen,(flipperHeight / 2.0f) * worldToScreen},(angle * RAD_TO_DEG),WHITE);
+    DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_RIGHT_FLIPPER],(Rectangle){pos.x * worldToScreen,pos.y * worldToScreen,flipperWidth * worldToScreen,flipperHeight * worldToScreen},(Vector2){(flipperHeight / 2.0f) * worldToScreen,(flipperHeight / 2.0f) * worldToScreen},(angle * RAD_TO_DEG),WHITE);
 
     // Render water powerup when active
     if (game->waterPowerupState > 0){
@@ -245,21 +388,13 @@ void Render_Gameplay(const GameStruct *game, const Resources *res,
         char ballText[32];
         snprintf(ballText, sizeof(ballText), "Ball %d / %d", currentBall, totalBalls);
 
-        DrawTextEx(
-            res->font1,
-            ballText,
-            (Vector2){
-                screenWidth/2 - MeasureTextEx(res->font1, ballText, 40.0, 1.0).x/2 - 10,
-                610
-            },
-            40,
-            1.0,
-            WHITE
-        );
-        DrawTextEx(res->font1, "Center Button to Launch!", (Vector2){screenWidth/2 - MeasureTextEx(res->font1,  "Center Button to Launch!", 20.0, 1.0).x/2  - 10,650}, 20, 1.0, WHITE);
+        float ballTextWidth = TextRun_Layout(&ballTextRun, res->font1, ballText, 40.0, 1.0).x;
+        TextRun_Draw(&ballTextRun, res->font1, (Vector2){screenWidth/2 - ballTextWidth/2 - 10, 610}, WHITE);
+        float promptWidth = TextRun_Layout(&launchPromptRun, res->font1, "Center Button to Launch!", 20.0, 1.0).x;
+        TextRun_Draw(&launchPromptRun, res->font1, (Vector2){screenWidth/2 - promptWidth/2 - 10,650}, WHITE);
 
         for (int i = 0; i < 8; i++){
-            DrawTexturePro(res->arrowRight,(Rectangle){0,0,res->arrowRight.width,res->arrowRight.height},(Rectangle){screenWidth - 9,(i * 20) + 625+ (5 * sin(((i*100)+millis()-elapsedTimeStart)/200.0f)),20,20},(Vector2){16,16},-90,(Color){0,0,0,100});
+            DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_ARROW_RIGHT],(Rectangle){screenWidth - 9,(i * 20) + 625+ (5 * sin(((i*100)+millis()-elapsedTimeStart)/200.0f)),20,20},(Vector2){16,16},-90,(Color){0,0,0,100});
         }
     }
 
@@ -278,3 +413,43 @@ void Render_Gameplay(const GameStruct *game, const Resources *res,
         physics_debug_draw(game);
     }
 }
+
+void Render_ProfileOverlay(const PhysicsProfileSample *latest, const PhysicsProfileSample *peak,
+                           float frameMs) {
+    const int x = 10;
+    const int lineHeight = 18;
+    int y = 34;
+
+    DrawRectangle(x - 4, y - 4, 330, 8 * lineHeight + 8, (Color){0, 0, 0, 160});
+    DrawText("ms           last    peak 1s", x, y, 16, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat("tick        %6.2f  %6.2f", latest->tickMs, peak->tickMs), x, y, 16, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat(" game      %6.2f", latest->tickMs - latest->stepMs), x, y, 16, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat(" b2 step   %6.2f  %6.2f", latest->stepMs, peak->stepMs), x, y, 16, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("  pairs %5.2f collide %5.2f", latest->pairsMs, latest->collideMs), x, y, 16, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("  solve %5.2f continuous %5.2f", latest->solveMs, latest->continuousMs), x, y, 16, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("render frame %6.2f", frameMs), x, y, 16, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat("balls %d bodies %d proxies %d contacts %d",
+                        latest->balls, latest->bodies, latest->shapes, latest->contacts), x, y, 16, YELLOW);
+}
+
+void Render_UpdateWaterTexture(const WaterSystem *ws, const Resources *res) {
+    unsigned char rippleData[RIPPLE_SAMPLES * 4];
+    for (int i = 0; i < RIPPLE_SAMPLES; i++) {
+        // Convert float height to grayscale byte (centered at 128)
+        int val = (int)(128.0f + ws->rippleHeight[i] * 50.0f);
+        if (val < 0) val = 0;
+        if (val > 255) val = 255;
+        rippleData[i * 4 + 0] = (unsigned char)val;
+        rippleData[i * 4 + 1] = (unsigned char)val;
+        rippleData[i * 4 + 2] = (unsigned char)val;
+        rippleData[i * 4 + 3] = 255;
+    }
+    UpdateTexture(res->rippleTexture, rippleData);
+}
@@ -10,13 +10,46 @@
 extern "C" {
 #endif
 
+// The static table layer: the background and the lane targets (type 2 and 3
+// bumpers), baked into a render texture with premultiplied alpha so the
+// powerup meter under the background still shows through. It is re-baked
+// only when a lane target is enabled or disabled.
+typedef struct {
+    RenderTexture2D target;
+    unsigned int laneTargets;   // enabled lane targets when baked, one bit per bumper
+    int baked;
+} RenderStaticLayer;
+
+void Render_InitStaticLayer(RenderStaticLayer *layer);
+void Render_UnloadStaticLayer(RenderStaticLayer *layer);
+
+// Re-bake the layer if the lane targets changed since it was baked. Call
+// outside any texture mode (raylib texture modes do not nest), before
+// Render_Gameplay.
+void Render_UpdateStaticLayer(RenderStaticLayer *layer, const Resources *res,
+                              const Bumper *bumpers, int numBumpers);
+
 // Draws the entire game world for an active gameplay state
 // Includes: background, bumpers, balls, flippers, effects
+// alpha (0..1) is how far the frame lies between the last two physics ticks;
+// balls and flippers are interpolated between those states.
+// Reads only game and bumpers (no Box2D calls), so it can draw a SimSnapshot
+// while the sim thread steps the world; debugDrawEnabled is the exception.
+// staticLayer (may be NULL) replaces drawing the background and lane targets.
 void Render_Gameplay(const GameStruct *game, const Resources *res, 
                      const Bumper *bumpers, int numBumpers,
-                     b2BodyId leftFlipperBody, b2BodyId rightFlipperBody,
+                     const RenderStaticLayer *staticLayer,
                      float shaderSeconds, float iceOverlayAlpha,
-                     int debugDrawEnabled, long long elapsedTimeStart);
+                     int debugDrawEnabled, long long elapsedTimeStart,
+                     float alpha);
+
+// TAB overlay under DrawFPS: the last game tick's physics profile, the peak over
+// the last second, and this thread's frame time (frameMs, vsync wait excluded)
+void Render_ProfileOverlay(const PhysicsProfileSample *latest, const PhysicsProfileSample *peak,
+                           float frameMs);
+
+// Uploads the current ripple heights of the water simulation to the ripple texture
+void Render_UpdateWaterTexture(const WaterSystem *ws, const Resources *res);
 
 #ifdef __cplusplus
 }
@@ -9,35 +9,50 @@
 
 #define RIPPLE_SAMPLES 25
 
+#define TEXTURE_DIR "Resources/Textures"
+
+// The atlas pinball_atlastool built, or one packed here if that is missing or
+// out of date (slower to start, same result)
+static void resources_load_sprite_atlas(Resources *res) {
+    const char *imagePath = TEXTURE_DIR "/" SPRITE_ATLAS_IMAGE;
+    const char *tablePath = TEXTURE_DIR "/" SPRITE_ATLAS_TABLE;
+
+    if (FileExists(imagePath) && FileExists(tablePath)) {
+        res->spriteAtlas = LoadTexture(imagePath);
+        if (IsTextureValid(res->spriteAtlas) &&
+            SpriteAtlas_ReadTable(tablePath, res->spriteAtlas.width, res->spriteAtlas.height, res->sprites) == 0) {
+            return;
+        }
+        UnloadTexture(res->spriteAtlas);
+    }
+
+    printf("Resources_Init: no usable %s, packing the sprites now (build the atlas target)\n", tablePath);
+    Image atlas;
+    if (SpriteAtlas_Pack(TEXTURE_DIR, &atlas, res->sprites) != 0) {
+        res->spriteAtlas = (Texture2D){0};
+        return;
+    }
+    res->spriteAtlas = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+}
+
 void Resources_Init(Resources *res) {
     // Load textures
     res->bgTex = LoadTexture("Resources/Textures/background2.png");
-    res->ballTex = LoadTexture("Resources/Textures/ball.png");
-    res->beachBallTex = LoadTexture("Resources/Textures/beachBall.png");
-    res->trailTex = LoadTexture("Resources/Textures/trail.png");
-    res->bumperTex = LoadTexture("Resources/Textures/bumper.png");
-    res->bumperLightTex = LoadTexture("Resources/Textures/bumperLight.png");
-    res->iceBumperTex = LoadTexture("Resources/Textures/iceBumper.png");
-    res->shockwaveTex = LoadTexture("Resources/Textures/shockwave.png");
-    res->debugTex = LoadTexture("Resources/Textures/debugSmall.png");
-    res->leftFlipperTex = LoadTexture("Resources/Textures/flipperL.png");
-    res->rightFlipperTex = LoadTexture("Resources/Textures/flipperR.png");
     res->bgMenu = LoadTexture("Resources/Textures/bgMenu.png");
     res->titleOverlay = LoadTexture("Resources/Textures/titleOverlay.png");
     res->menuOverlay1 = LoadTexture("Resources/Textures/menuOverlay1.png");
     res->gameOverOverlay1 = LoadTexture("Resources/Textures/gameOverOverlay1.png");
     res->gameOverOverlay2 = LoadTexture("Resources/Textures/gameOverOverlay2.png");
-    res->arrowRight = LoadTexture("Resources/Textures/arrowRight.png");
     res->menuControls = LoadTexture("Resources/Textures/menuControls.png");
     res->transitionTex = LoadTexture("Resources/Textures/transition.png");
     res->waterTex = LoadTexture("Resources/Textures/waterTex.png");
     res->waterOverlayTex = LoadTexture("Resources/Textures/waterOverlayTex.png");
-    res->particleTex = LoadTexture("Resources/Textures/particle.png");
     res->iceOverlay = LoadTexture("Resources/Textures/iceOverlay.png");
-    res->bumper3 = LoadTexture("Resources/Textures/bumper3.png");
-    res->lowerBumperShock = LoadTexture("Resources/Textures/lowerBumperShock.png");
     res->redPowerupOverlay = LoadTexture("Resources/Textures/redPowerupOverlay.png");
 
+    resources_load_sprite_atlas(res);
+
     // Load fonts
     res->font1 = LoadFontEx("Resources/Fonts/Avenir-Black.ttf", 80, 0, 0);
     res->font2 = LoadFontEx("Resources/Fonts/Avenir-Black.ttf", 120, 0, 0);
@@ -102,6 +117,14 @@ void Resources_Init(Resources *res) {
     SetShaderValue(res->waterShader, res->waterSpeedXLoc, speedXVec, SHADER_UNIFORM_VEC2);
     SetShaderValue(res->waterShader, res->waterSpeedYLoc, speedYVec, SHADER_UNIFORM_VEC2);
 
+    // Menu background: the rotation and offset on a canvas-sized quad (see UI_DrawMenu)
+    res->menuBgShader = LoadShader(0, TextFormat("Resources/Shaders/glsl%i/menuBackground.fs", GLSL_VERSION));
+    res->menuBgCenterLoc = GetShaderLocation(res->menuBgShader, "bgCenter");
+    res->menuBgSizeLoc = GetShaderLocation(res->menuBgShader, "bgSize");
+    res->menuBgRotationLoc = GetShaderLocation(res->menuBgShader, "bgRotation");
+
+    SetShaderValue(res->menuBgShader, GetShaderLocation(res->menuBgShader, "size"), &screenSize, SHADER_UNIFORM_VEC2);
+
     // Create ripple texture (25x1 R32F)
     Image rippleImage = GenImageColor(RIPPLE_SAMPLES, 1, (Color){0, 0, 0, 255});
     res->rippleTexture = LoadTextureFromImage(rippleImage);
@@ -113,32 +136,19 @@ void Resources_Init(Resources *res) {
 void Resources_Unload(Resources *res) {
     // Unload textures
     UnloadTexture(res->bgTex);
-    UnloadTexture(res->ballTex);
-    UnloadTexture(res->beachBallTex);
-    UnloadTexture(res->trailTex);
-    UnloadTexture(res->bumperTex);
-    UnloadTexture(res->bumperLightTex);
-    UnloadTexture(res->iceBumperTex);
-    UnloadTexture(res->shockwaveTex);
-    UnloadTexture(res->debugTex);
-    UnloadTexture(res->leftFlipperTex);
-    UnloadTexture(res->rightFlipperTex);
     UnloadTexture(res->bgMenu);
     UnloadTexture(res->titleOverlay);
     UnloadTexture(res->menuOverlay1);
     UnloadTexture(res->gameOverOverlay1);
     UnloadTexture(res->gameOverOverlay2);
-    UnloadTexture(res->arrowRight);
     UnloadTexture(res->menuControls);
     UnloadTexture(res->transitionTex);
     UnloadTexture(res->waterTex);
     UnloadTexture(res->waterOverlayTex);
-    UnloadTexture(res->particleTex);
     UnloadTexture(res->iceOverlay);
-    UnloadTexture(res->bumper3);
-    UnloadTexture(res->lowerBumperShock);
     UnloadTexture(res->redPowerupOverlay);
     UnloadTexture(res->rippleTexture);
+    UnloadTexture(res->spriteAtlas);
 
     // Unload fonts
     UnloadFont(res->font1);
@@ -148,4 +158,5 @@ void Resources_Unload(Resources *res) {
     UnloadShader(res->alphaTestShader);
     UnloadShader(res->swirlShader);
     UnloadShader(res->waterShader);
+    UnloadShader(res->menuBgShader);
 }
@@ -2,6 +2,7 @@
 #define RESOURCES_H
 
 #include "raylib.h"
+#include "spriteAtlas.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,33 +11,23 @@ extern "C" {
 typedef struct Resources {
     // Textures
     Texture2D bgTex;
-    Texture2D ballTex;
-    Texture2D beachBallTex;
-    Texture2D trailTex;
-    Texture2D bumperTex;
-    Texture2D bumperLightTex;
-    Texture2D iceBumperTex;
-    Texture2D shockwaveTex;
-    Texture2D debugTex;
-    Texture2D leftFlipperTex;
-    Texture2D rightFlipperTex;
     Texture2D bgMenu;
     Texture2D titleOverlay;
     Texture2D menuOverlay1;
     Texture2D gameOverOverlay1;
     Texture2D gameOverOverlay2;
-    Texture2D arrowRight;
     Texture2D menuControls;
     Texture2D transitionTex;
     Texture2D waterTex;
     Texture2D waterOverlayTex;
-    Texture2D particleTex;
     Texture2D iceOverlay;
-    Texture2D bumper3;
-    Texture2D lowerBumperShock;
     Texture2D redPowerupOverlay;
     Texture2D rippleTexture;
 
+    // Gameplay sprites: one atlas texture, and each sprite's source rect in it
+    Texture2D spriteAtlas;
+    Rectangle sprites[SPRITE_COUNT];
+
     // Fonts
     Font font1;
     Font font2;
@@ -45,6 +36,7 @@ typedef struct Resources {
     Shader alphaTestShader;
     Shader swirlShader;
     Shader waterShader;
+    Shader menuBgShader;
     
     // Shader locations for swirl shader
     int swirlSecondsLoc;
@@ -65,6 +57,11 @@ typedef struct Resources {
     int waterSpeedYLoc;
     int waterRippleTexLoc;
     int waterLevelLoc;
+
+    // Shader locations for the menu background shader
+    int menuBgCenterLoc;
+    int menuBgSizeLoc;
+    int menuBgRotationLoc;
 } Resources;
 
 // Initialize all resources (textures, shaders, fonts)
@@ -0,0 +1,225 @@
+/*
+ * rewindBuffer.c - The last seconds of play, for the instant replay (see rewindBuffer.h)
+ *
+ * Fixed point: positions in 1/128 world units, velocities in 1/32 units per
+ * second, angles in 1/8192 radians, fades (0..1) in 1/255. The table is about
+ * 85 x 175 units, so nothing on it clips.
+ */
+
+#include "rewindBuffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "constants.h"
+
+#define REWIND_POS_SCALE   128.0f
+#define REWIND_VEL_SCALE   32.0f
+#define REWIND_ANGLE_SCALE 8192.0f
+
+typedef struct {
+    int16_t x, y;
+    int16_t vx, vy;
+    uint8_t type;
+    uint8_t unused;
+} RewindBall;
+
+typedef struct {
+    uint32_t firstBall;         // position in the ball ring (not wrapped, see ballEnd)
+    uint16_t numBalls;
+    int16_t flipperAngles[2];
+    uint16_t waterHeight;       // 1/65535
+    int32_t score;
+    uint16_t powerupScoreDisplay;
+    uint8_t numLives;
+    uint8_t slowMotion;
+    uint8_t waterPowerupState;
+    uint8_t slowMoPowerupAvailable;
+    uint8_t leftLowerBumperAnim;
+    uint8_t rightLowerBumperAnim;
+    uint8_t redPowerupOverlay;
+    uint8_t bluePowerupOverlay;
+    uint8_t slowMoExplosionEffect;
+} RewindFrame;
+
+typedef struct {
+    RewindFrame *frames;
+    RewindBall *balls;
+    int firstFrame;             // oldest frame's slot
+    int numFrames;
+    uint32_t ballEnd;           // next ball record to write (not wrapped; the capacity
+                                // is a power of two, so this may overflow)
+} RewindRing;
+
+struct RewindBufferObject {
+    int frameCapacity;
+    int ballCapacity;
+    RewindRing live;
+    RewindRing clip;
+};
+
+static int16_t rewind_quantise(float value, float scale) {
+    float q = value * scale;
+    if (q > 32767.0f) { q = 32767.0f; }
+    if (q < -32767.0f) { q = -32767.0f; }
+    return (int16_t)(q < 0.0f ? q - 0.5f : q + 0.5f);
+}
+
+static uint8_t rewind_quantise_fade(float value) {
+    if (value <= 0.0f) { return 0; }
+    if (value >= 1.0f) { return 255; }
+    return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+static int rewind_ring_alloc(RewindRing *ring, int frameCapacity, int ballCapacity) {
+    ring->frames = calloc(frameCapacity, sizeof(RewindFrame));
+    ring->balls = calloc(ballCapacity, sizeof(RewindBall));
+    return ring->frames != NULL && ring->balls != NULL;
+}
+
+RewindBuffer *RewindBuffer_Create(int framesPerSecond) {
+    RewindBuffer *rewind = calloc(1, sizeof(RewindBuffer));
+    if (rewind == NULL) {
+        printf("RewindBuffer_Create: out of memory\n");
+        return NULL;
+    }
+    rewind->frameCapacity = framesPerSecond * REWIND_SECONDS;
+    // The largest power of two that fits the average, but at least one full frame
+    rewind->ballCapacity = 1;
+    while (rewind->ballCapacity * 2 <= rewind->frameCapacity * REWIND_BALLS_PER_FRAME ||
+           rewind->ballCapacity < maxBalls) {
+        rewind->ballCapacity *= 2;
+    }
+    if (!rewind_ring_alloc(&rewind->live, rewind->frameCapacity, rewind->ballCapacity) ||
+        !rewind_ring_alloc(&rewind->clip, rewind->frameCapacity, rewind->ballCapacity)) {
+        printf("RewindBuffer_Create: out of memory for %d frames\n", rewind->frameCapacity);
+        RewindBuffer_Destroy(rewind);
+        return NULL;
+    }
+    return rewind;
+}
+
+void RewindBuffer_Destroy(RewindBuffer *rewind) {
+    if (rewind == NULL) {
+        return;
+    }
+    free(rewind->live.frames);
+    free(rewind->live.balls);
+    free(rewind->clip.frames);
+    free(rewind->clip.balls);
+    free(rewind);
+}
+
+void RewindBuffer_Clear(RewindBuffer *rewind) {
+    rewind->live.firstFrame = 0;
+    rewind->live.numFrames = 0;
+}
+
+void RewindBuffer_Capture(RewindBuffer *rewind, const GameStruct *game) {
+    RewindRing *ring = &rewind->live;
+    int numBalls = game->numBalls < rewind->ballCapacity ? game->numBalls : rewind->ballCapacity;
+
+    // Drop the oldest frames until there is a frame slot and room for the balls
+    while (ring->numFrames > 0) {
+        const RewindFrame *oldest = &ring->frames[ring->firstFrame];
+        if (ring->numFrames < rewind->frameCapacity &&
+            ring->ballEnd + numBalls - oldest->firstBall <= (uint32_t)rewind->ballCapacity) {
+            break;
+        }
+        ring->firstFrame = (ring->firstFrame + 1) % rewind->frameCapacity;
+        ring->numFrames--;
+    }
+
+    RewindFrame *frame = &ring->frames[(ring->firstFrame + ring->numFrames) % rewind->frameCapacity];
+    ring->numFrames++;
+    frame->firstBall = ring->ballEnd;
+    frame->numBalls = (uint16_t)numBalls;
+    for (int k = 0; k < numBalls; k++) {
+        const Ball *ball = &game->balls[game->activeBalls[k]];
+        RewindBall *record = &ring->balls[(ring->ballEnd + k) % rewind->ballCapacity];
+        record->x = rewind_quantise(ball->position.x, REWIND_POS_SCALE);
+        record->y = rewind_quantise(ball->position.y, REWIND_POS_SCALE);
+        record->vx = rewind_quantise(ball->velocity.x, REWIND_VEL_SCALE);
+        record->vy = rewind_quantise(ball->velocity.y, REWIND_VEL_SCALE);
+        record->type = (uint8_t)ball->type;
+    }
+    ring->ballEnd += numBalls;
+
+    frame->flipperAngles[0] = rewind_quantise(game->flipperAngles[0], REWIND_ANGLE_SCALE);
+    frame->flipperAngles[1] = rewind_quantise(game->flipperAngles[1], REWIND_ANGLE_SCALE);
+    frame->waterHeight = game->waterHeight <= 0.0f ? 0 :
+                         game->waterHeight >= 1.0f ? 65535 : (uint16_t)(game->waterHeight * 65535.0f);
+    frame->score = (int32_t)game->gameScore;
+    frame->powerupScoreDisplay = game->powerupScoreDisplay > 65535 ? 65535 :
+                                 (uint16_t)(game->powerupScoreDisplay < 0 ? 0 : game->powerupScoreDisplay);
+    frame->numLives = (uint8_t)game->numLives;
+    frame->slowMotion = (uint8_t)game->slowMotion;
+    frame->waterPowerupState = (uint8_t)game->waterPowerupState;
+    frame->slowMoPowerupAvailable = (uint8_t)game->slowMoPowerupAvailable;
+    frame->leftLowerBumperAnim = rewind_quantise_fade(game->leftLowerBumperAnim);
+    frame->rightLowerBumperAnim = rewind_quantise_fade(game->rightLowerBumperAnim);
+    frame->redPowerupOverlay = rewind_quantise_fade(game->redPowerupOverlay);
+    frame->bluePowerupOverlay = rewind_quantise_fade(game->bluePowerupOverlay);
+    frame->slowMoExplosionEffect = rewind_quantise_fade(game->slowMoExplosionEffect);
+}
+
+int RewindBuffer_Freeze(RewindBuffer *rewind) {
+    RewindRing *live = &rewind->live;
+    RewindRing *clip = &rewind->clip;
+    memcpy(clip->frames, live->frames, rewind->frameCapacity * sizeof(RewindFrame));
+    memcpy(clip->balls, live->balls, rewind->ballCapacity * sizeof(RewindBall));
+    clip->firstFrame = live->firstFrame;
+    clip->numFrames = live->numFrames;
+    clip->ballEnd = live->ballEnd;
+    return clip->numFrames;
+}
+
+int RewindBuffer_GetClipFrames(const RewindBuffer *rewind) {
+    return rewind->clip.numFrames;
+}
+
+void RewindBuffer_DecodeClip(const RewindBuffer *rewind, int frameIndex, GameStruct *out) {
+    const RewindRing *clip = &rewind->clip;
+    if (frameIndex < 0 || frameIndex >= clip->numFrames) {
+        out->numBalls = 0;
+        return;
+    }
+    const RewindFrame *frame = &clip->frames[(clip->firstFrame + frameIndex) % rewind->frameCapacity];
+
+    // Played back at the capture rate, so there is nothing to interpolate
+    out->numBalls = frame->numBalls;
+    for (int k = 0; k < frame->numBalls; k++) {
+        const RewindBall *record = &clip->balls[(frame->firstBall + k) % rewind->ballCapacity];
+        Ball *ball = &out->balls[k];
+        ball->active = 1;
+        ball->type = record->type;
+        ball->position = (b2Vec2){ record->x / REWIND_POS_SCALE, record->y / REWIND_POS_SCALE };
+        ball->previousPosition = ball->position;
+        ball->velocity = (b2Vec2){ record->vx / REWIND_VEL_SCALE, record->vy / REWIND_VEL_SCALE };
+        out->activeBalls[k] = k;
+
+        // No trail history: every sample sits under the ball
+        for (int s = 0; s < BALL_TRAIL_LENGTH; s++) {
+            out->trails.x[k * BALL_TRAIL_LENGTH + s] = ball->position.x;
+            out->trails.y[k * BALL_TRAIL_LENGTH + s] = ball->position.y;
+        }
+        out->trails.head[k] = 0;
+    }
+
+    out->flipperAngles[0] = frame->flipperAngles[0] / REWIND_ANGLE_SCALE;
+    out->flipperAngles[1] = frame->flipperAngles[1] / REWIND_ANGLE_SCALE;
+    out->previousFlipperAngles[0] = out->flipperAngles[0];
+    out->previousFlipperAngles[1] = out->flipperAngles[1];
+    out->waterHeight = frame->waterHeight / 65535.0f;
+    out->gameScore = frame->score;
+    out->powerupScoreDisplay = frame->powerupScoreDisplay;
+    out->numLives = frame->numLives;
+    out->slowMotion = frame->slowMotion;
+    out->waterPowerupState = frame->waterPowerupState;
+    out->slowMoPowerupAvailable = frame->slowMoPowerupAvailable;
+    out->leftLowerBumperAnim = frame->leftLowerBumperAnim / 255.0f;
+    out->rightLowerBumperAnim = frame->rightLowerBumperAnim / 255.0f;
+    out->redPowerupOverlay = frame->redPowerupOverlay / 255.0f;
+    out->bluePowerupOverlay = frame->bluePowerupOverlay / 255.0f;
+    out->slowMoExplosionEffect = frame->slowMoExplosionEffect / 255.0f;
+}
@@ -0,0 +1,55 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include "gameStruct.h"
+
+/*
+ * rewindBuffer.h - The last seconds of play, for the instant replay
+ *
+ * While a game runs, the sim thread captures one frame per physics step: ball
+ * positions and velocities, flipper angles, score, lives and the powerup
+ * state the renderer shows. Frames are quantised to 16-bit fixed point and
+ * stored in two rings allocated up front, one of frame headers and one of
+ * ball records, so capturing never allocates. When a frame's balls do not
+ * fit, the oldest frames are dropped, so under a ball storm the window is
+ * shorter than REWIND_SECONDS.
+ *
+ * RewindBuffer_Freeze copies the live rings into the clip when a ball drains;
+ * the game-over and attract screens then play the clip back with
+ * RewindBuffer_DecodeClip while capture carries on. All calls belong to one
+ * thread (the sim thread).
+ *
+ * At 240 steps per second a buffer takes about 300 KB, live rings and clip.
+ * Trails and the ice overlay are not recorded.
+ */
+
+#define REWIND_SECONDS 10
+
+// Ball records per frame the rings are sized for, on average over the window
+// (rounded down to a power of two in total)
+#define REWIND_BALLS_PER_FRAME 4
+
+typedef struct RewindBufferObject RewindBuffer;
+
+// framesPerSecond is the capture rate (the sim thread's physics rate).
+// Returns NULL (after printing why) on failure.
+RewindBuffer *RewindBuffer_Create(int framesPerSecond);
+void RewindBuffer_Destroy(RewindBuffer *rewind);
+
+// Forget the captured frames (not the clip), e.g. when a game starts
+void RewindBuffer_Clear(RewindBuffer *rewind);
+
+// Record the state after a physics step
+void RewindBuffer_Capture(RewindBuffer *rewind, const GameStruct *game);
+
+// Make the captured frames the clip. Returns its length in frames (0 if none).
+int RewindBuffer_Freeze(RewindBuffer *rewind);
+
+int RewindBuffer_GetClipFrames(const RewindBuffer *rewind);
+
+// Write clip frame `frame` (0 = oldest) into out: the balls (out's own arrays,
+// from GameStruct_AllocBalls), flipper angles, score, lives and powerup state.
+// Everything else in out, e.g. flipperPositions, is left to the caller.
+void RewindBuffer_DecodeClip(const RewindBuffer *rewind, int frame, GameStruct *out);
+
+#endif // REWIND_BUFFER_H
@@ -0,0 +1,31 @@
+#include <stdlib.h>
+#include "scores.h"
+
+// High-score backend for headless builds (pinball_sim).
+// Mirrors the scores.h API without opening the sqlite database, so replays
+// can run score entry without touching Resources/scores.db.
+
+ScoreHelper *initScores(){
+    ScoreHelper *helper = calloc(1, sizeof(ScoreHelper));
+    return helper;
+}
+void shutdownScores(ScoreHelper *helper){
+    free(helper);
+}
+void submitScore(ScoreHelper *helper, char *name, int score){
+    (void)helper;
+    (void)name;
+    (void)score;
+}
+ScoreObject *getRankedScore(ScoreHelper *helper, int rank){
+    (void)helper;
+    (void)rank;
+    return NULL;
+}
+int sqlCallback(void *data, int argc, char **argv, char **columnNames){
+    (void)data;
+    (void)argc;
+    (void)argv;
+    (void)columnNames;
+    return 0;
+}
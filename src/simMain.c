@@ -0,0 +1,622 @@
+/*
+ * simMain.c - Headless simulation runner (pinball_sim)
+ *
+ * Steps the same fixed-tick game logic as the game (Game_Update, then the playfield
+ * and physics_step at --physics-hz) as fast as the CPU allows, with no window, audio device
+ * or serial port. Input comes from the scripted backend in inputManagerSim.c (or a
+ * recording, see inputRecord.h), sound from the silent backend in soundManagerNull.c
+ * and high scores go nowhere (scoresNull.c).
+ *
+ * Usage: pinball_sim [--seconds N] [--balls N] [--quality Q] [--mode M] [--workers N] [--physics-hz N] [--table FILE]
+ *                    [--replay FILE] [--profile FILE] [--hash FILE] [--scaling] [--batch N]
+ *                    [--storm [--water] [--slowmo] [--baseline FILE] [--write-baseline] [--tolerance PCT]]
+ *   --seconds N : simulated seconds to run (default 60)
+ *   --balls N   : extra balls spawned at start, like mouse-spawned balls (default 0)
+ *   --quality Q : physics quality preset: low, medium, high or adaptive (default adaptive)
+ *   --mode M    : game mode: classic or mega (mega multiball: balls collide; default classic)
+ *   --workers N : Box2D solver threads including the main thread (default 0 = one per CPU)
+ *   --physics-hz N: physics steps per second, a multiple of 60 (default 60, one per tick)
+ *   --table FILE: table geometry file (default: the built-in table)
+ *   --replay FILE: replay a recording from `pinball --record FILE` instead of the scripted
+ *                 input; runs until the recording ends at the recorded physics rate (--seconds,
+ *                 --balls, --quality, --mode and --physics-hz are ignored)
+ *   --profile FILE: write the per-tick physics profile (see physicsProfile.h) to FILE,
+ *                 CSV or, for a *.json name, JSON
+ *   --hash FILE : write a state hash after every physics step (see stateHash.h); compare
+ *                 two runs of the same --replay with pinball_hashdiff
+ *   --scaling   : compare 1 worker against --workers at 1/16/64/256 balls held on the table
+ *   --batch N   : run up to N (at most 127) independent tables at once, one thread and one Box2D worker
+ *                 each, and report simulated seconds per wall second at 1, 2, 4 ... N tables
+ *   --storm     : ball-storm benchmark (see stormBench.h): hold 16, 64, 128 and 256 balls
+ *                 and report p50/p99/max physics and game logic milliseconds per tick
+ *   --water, --slowmo: hold the water / slow-motion powerup on during --storm
+ *   --baseline FILE: compare --storm against FILE and exit with 2 on a regression;
+ *                 a FILE without this scenario gets it written instead
+ *   --write-baseline: with --baseline, replace the scenario's rows with this run
+ *   --tolerance PCT: allowed regression over the baseline in percent (default 20)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <box2d/box2d.h>
+#include "constants.h"
+#include "gameStruct.h"
+#include "inputManager.h"
+#include "soundManager.h"
+#include "physics.h"
+#include "game.h"
+#include "menu.h"
+#include "inputRecord.h"
+#include "powerups.h"
+#include "water.h"
+#include "util.h"
+#include "physicsProfile.h"
+#include "tableInstance.h"
+#include "stormBench.h"
+#include "stateHash.h"
+
+typedef struct {
+    float seconds;
+    int extraBalls;
+    int holdBalls;      // keep at least this many balls on the table (0 = off)
+    int workers;
+    int physicsRate;    // physics steps per second, a multiple of tickRate
+    PhysicsQuality quality;
+    GameMode mode;
+    const char *tablePath;
+    PhysicsProfiler *profiler;  // NULL unless --profile
+    StateHashWriter *stateHash; // NULL unless --hash
+} SimConfig;
+
+typedef struct {
+    long ticks;
+    double wallSeconds;
+    long gamesPlayed;
+    long peakBalls;
+    long long totalSubSteps;
+    long finalScore;
+    int workers;
+    PhysicsQuality quality;   // preset at the start of the run
+    GameMode mode;            // mode of the last game
+    float timeStep;
+    int failed;               // the table could not be created
+} SimResult;
+
+// Table instance for config: one table, Box2D threads from --workers
+static TableInstanceConfig sim_instance_config(const SimConfig *config) {
+    TableInstanceConfig instanceConfig = {
+        .tablePath = config->tablePath,
+        .physicsWorkers = config->workers,
+        .physicsRate = config->physicsRate,
+        .quality = config->quality,
+        .mode = config->mode,
+        .extraBalls = config->extraBalls,
+        .holdBalls = config->holdBalls,
+        .inputPhase = 0,
+        .profiler = config->profiler,
+        .stateHash = config->stateHash
+    };
+    return instanceConfig;
+}
+
+static SimResult sim_run(const SimConfig *config) {
+    SimResult result = {0};
+    const float timeStep = 1.0f / tickRate;
+    result.quality = config->quality;
+    result.timeStep = timeStep;
+
+    TableInstanceConfig instanceConfig = sim_instance_config(config);
+    TableInstance *instance = TableInstance_Create(&instanceConfig);
+    if (instance == NULL){
+        result.failed = 1;
+        return result;
+    }
+
+    // Skip the title/menu scenes and go straight to gameplay.
+    TableInstance_StartGame(instance);
+
+    result.ticks = (long)(config->seconds / timeStep);
+    result.workers = physics_get_worker_count(&instance->game);
+    long long startTime = nanos();
+
+    TableInstance_Step(instance, result.ticks);
+
+    result.wallSeconds = (nanos() - startTime) / 1e9;
+    if (result.wallSeconds <= 0.0){
+        result.wallSeconds = 1e-9;
+    }
+    result.gamesPlayed = instance->gamesPlayed;
+    result.peakBalls = instance->peakBalls;
+    result.totalSubSteps = instance->totalSubSteps;
+    result.finalScore = instance->game.gameScore;
+    result.mode = instance->game.currentMode;
+
+    TableInstance_Destroy(instance);
+    return result;
+}
+
+/*
+ * sim_replay
+ *  - Replays a recording made with `pinball --record FILE` from power-on:
+ *    title, menu, games and score entry, one recorded tick per fixed tick.
+ *  - The per-tick sequence must match the game tick in simThread.c, including
+ *    the recorded number of physics steps per tick and the key changes between
+ *    them.
+ */
+static SimResult sim_replay(const SimConfig *config, InputReplay *replay) {
+    SimResult result = {0};
+    const float timeStep = 1.0f / InputReplay_GetTickRate(replay);
+    const int stepsPerTick = InputReplay_GetPhysicsRate(replay) / InputReplay_GetTickRate(replay);
+
+    SimConfig replayConfig = *config;
+    replayConfig.physicsRate = InputReplay_GetPhysicsRate(replay);
+    replayConfig.quality = InputReplay_GetQuality(replay);
+    if (replayConfig.quality >= PHYSICS_QUALITY_COUNT){
+        replayConfig.quality = PHYSICS_QUALITY_ADAPTIVE;
+    }
+    replayConfig.mode = (GameMode)InputReplay_GetMode(replay);
+    if (replayConfig.mode >= MODE_COUNT){
+        replayConfig.mode = MODE_CLASSIC;
+    }
+    result.quality = replayConfig.quality;
+    result.timeStep = timeStep;
+    srand(InputReplay_GetSeed(replay));
+
+    TableInstanceConfig instanceConfig = sim_instance_config(&replayConfig);
+    TableInstance *instance = TableInstance_Create(&instanceConfig);
+    if (instance == NULL){
+        result.failed = 1;
+        return result;
+    }
+    GameStruct *game = &instance->game;
+    inputSimAttachReplay(instance->input, replay);
+
+    MenuPinball menuPinballs[32];
+    Menu_Init(game, menuPinballs, 32);
+    char nameString[6];
+    sprintf(nameString,"     ");
+
+    result.workers = physics_get_worker_count(game);
+    long long startTime = nanos();
+
+    for (;;){
+        inputUpdate(instance->input);
+        const InputTick *tick = inputSimReplayTick(instance->input);
+        if (tick == NULL){
+            break;
+        }
+        long long tickStart = nanos();
+        if (config->profiler != NULL){
+            PhysicsProfiler_BeginTick(config->profiler);
+        }
+        for (int i = 0; i < tick->numEvents; i++){
+            if (tick->events[i].type == INPUT_EVENT_QUALITY &&
+                tick->events[i].value < PHYSICS_QUALITY_COUNT){
+                physics_set_quality(game, tick->events[i].value);
+            }
+        }
+
+        int prevGameState = game->gameState;
+        updateSound(instance->sound, game);
+        Game_Update(game, instance->bumpers, instance->input, NULL, instance->sound, timeStep);
+        if (game->gameState == 0){
+            Menu_Update(game, menuPinballs, 32, instance->input, instance->sound);
+        }
+        float physicsDt = Game_BeginPlayfield(game, &instance->powerups, instance->input, instance->sound,
+                                              timeStep) / stepsPerTick;
+        for (int step = 0; step < stepsPerTick; step++){
+            if (step > 0){
+                inputSimReplayStep(instance->input, step);
+            }
+            if (physicsDt > 0.0f){
+                Game_StepPlayfieldPhysics(game, instance->leftFlipperBody, instance->rightFlipperBody,
+                                          instance->input, instance->sound, physicsDt);
+                result.totalSubSteps += physics_get_last_substeps(game);
+            }
+        }
+        if (physicsDt > 0.0f){
+            Game_EndPlayfield(game, instance->bumpers, &instance->powerups, instance->input, instance->sound);
+        }
+        for (int i = 0; i < tick->numEvents; i++){
+            if (tick->events[i].type == INPUT_EVENT_SPAWN){
+                physics_add_ball(game, tick->events[i].x, tick->events[i].y, 0, 0, 1);
+            }
+        }
+        if (game->gameState == 2){
+            Scoreboard_Update(game, instance->input, NULL, nameString);
+        }
+        Water_Step(&instance->water, result.ticks * timeStep);
+        if (config->profiler != NULL){
+            PhysicsProfiler_EndTick(config->profiler, game->numBalls, (nanos() - tickStart) / 1e6f);
+        }
+
+        result.ticks++;
+        if (game->numBalls > result.peakBalls){
+            result.peakBalls = game->numBalls;
+        }
+        if (game->gameState == 1 && prevGameState != 1){
+            result.gamesPlayed++;
+        }
+        if (game->gameState == 1){
+            result.finalScore = game->gameScore;
+        }
+    }
+
+    result.wallSeconds = (nanos() - startTime) / 1e9;
+    if (result.wallSeconds <= 0.0){
+        result.wallSeconds = 1e-9;
+    }
+    result.mode = game->currentMode;
+
+    TableInstance_Destroy(instance);
+    return result;
+}
+
+/*
+ * sim_report_scaling
+ *  - Runs the table with 1, 16, 64 and 256 balls held in play, once on a single
+ *    thread and once with the configured worker count, and prints the speedup.
+ */
+static void sim_report_scaling(const SimConfig *base){
+    static const int ballCounts[] = { 1, 16, 64, 256 };
+
+    printf("quality %s, %.0f simulated seconds per run\n",
+           physics_quality_name(base->quality), base->seconds);
+    printf("%6s  %16s  %16s  %8s\n", "balls", "1 worker tick/s", "N workers tick/s", "speedup");
+
+    for (size_t i = 0; i < sizeof(ballCounts) / sizeof(ballCounts[0]); i++){
+        SimConfig config = *base;
+        config.extraBalls = 0;
+        config.holdBalls = ballCounts[i];
+
+        config.workers = 1;
+        SimResult single = sim_run(&config);
+        config.workers = base->workers;
+        SimResult multi = sim_run(&config);
+        if (single.failed || multi.failed){
+            return;
+        }
+
+        double singleRate = single.ticks / single.wallSeconds;
+        double multiRate = multi.ticks / multi.wallSeconds;
+        printf("%6d  %16.1f  %10.1f (%2d)  %7.2fx\n",
+               ballCounts[i], singleRate, multiRate, multi.workers, multiRate / singleRate);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Batch runs                                                                */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    TableInstance *instance;
+    long ticks;
+    pthread_t thread;
+    int threadStarted;
+    // Results
+    long gamesPlayed;
+    long bestScore;
+    long peakBalls;
+} SimBatchJob;
+
+// Steps one table; sim_batch_run creates and destroys it on the main thread
+static void *sim_batch_thread(void *arg){
+    SimBatchJob *job = arg;
+    TableInstance_Step(job->instance, job->ticks);
+    job->gamesPlayed = job->instance->gamesPlayed;
+    job->bestScore = job->instance->bestScore;
+    job->peakBalls = job->instance->peakBalls;
+    return NULL;
+}
+
+// Runs `count` tables in parallel; returns the wall seconds until the last one
+// finished, or -1 if the tables could not be created
+static double sim_batch_run(const SimConfig *config, SimBatchJob *jobs, int count){
+    const float timeStep = 1.0f / tickRate;
+    int created = 0;
+    for (; created < count; created++){
+        TableInstanceConfig instanceConfig = sim_instance_config(config);
+        instanceConfig.physicsWorkers = 1;
+        instanceConfig.profiler = NULL;
+        instanceConfig.stateHash = NULL;
+        // Shift each table's scripted flipper pattern so the games differ
+        instanceConfig.inputPhase = created * 7;
+        jobs[created].instance = TableInstance_Create(&instanceConfig);
+        if (jobs[created].instance == NULL){
+            break;
+        }
+        TableInstance_StartGame(jobs[created].instance);
+        jobs[created].ticks = (long)(config->seconds / timeStep);
+    }
+
+    double wallSeconds = -1.0;
+    if (created == count){
+        long long startTime = nanos();
+        for (int i = 0; i < count; i++){
+            jobs[i].threadStarted = pthread_create(&jobs[i].thread, NULL, sim_batch_thread, &jobs[i]) == 0;
+            if (!jobs[i].threadStarted){
+                fprintf(stderr, "sim_batch_run: cannot start thread %d, running it inline\n", i);
+                sim_batch_thread(&jobs[i]);
+            }
+        }
+        for (int i = 0; i < count; i++){
+            if (jobs[i].threadStarted){
+                pthread_join(jobs[i].thread, NULL);
+            }
+        }
+        wallSeconds = (nanos() - startTime) / 1e9;
+        if (wallSeconds <= 0.0){
+            wallSeconds = 1e-9;
+        }
+    }
+
+    for (int i = 0; i < created; i++){
+        TableInstance_Destroy(jobs[i].instance);
+        jobs[i].instance = NULL;
+    }
+    return wallSeconds;
+}
+
+/*
+ * sim_report_batch
+ *  - Runs 1, 2, 4 ... maxTables independent tables at once and prints the
+ *    combined simulated seconds per wall second and how that scales, then the
+ *    results of each table in the largest run.
+ */
+static int sim_report_batch(const SimConfig *base, int maxTables){
+    SimBatchJob *jobs = calloc(maxTables, sizeof(SimBatchJob));
+    if (jobs == NULL){
+        fprintf(stderr, "sim_report_batch: out of memory\n");
+        return 1;
+    }
+
+    printf("quality %s, %.0f simulated seconds per table, %d extra balls\n",
+           physics_quality_name(base->quality), base->seconds, base->extraBalls);
+    printf("%6s  %10s  %14s  %14s  %10s\n", "tables", "wall s", "sim s/wall s", "per table", "scaling");
+
+    double singleRate = 0.0;
+    for (int count = 1; ; count = (count * 2 < maxTables) ? count * 2 : maxTables){
+        double wallSeconds = sim_batch_run(base, jobs, count);
+        if (wallSeconds < 0.0){
+            fprintf(stderr, "sim_report_batch: cannot create %d tables\n", count);
+            free(jobs);
+            return 1;
+        }
+        double rate = count * base->seconds / wallSeconds;
+        if (count == 1){
+            singleRate = rate;
+        }
+        printf("%6d  %10.2f  %14.1f  %14.1f  %9.2fx\n",
+               count, wallSeconds, rate, rate / count, rate / singleRate);
+        if (count == maxTables){
+            break;
+        }
+    }
+
+    printf("\n%6s  %8s  %10s  %10s\n", "table", "games", "best score", "peak balls");
+    for (int i = 0; i < maxTables; i++){
+        printf("%6d  %8ld  %10ld  %10ld\n", i, jobs[i].gamesPlayed, jobs[i].bestScore, jobs[i].peakBalls);
+    }
+    free(jobs);
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Ball-storm benchmark                                                      */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    int water;
+    int slowMotion;
+    const char *baselinePath;   // NULL = report only
+    int writeBaseline;
+    float tolerance;            // fraction, 0.2 = 20%
+} SimStormConfig;
+
+/*
+ * sim_storm
+ *  - Runs the ball-storm ramp on one table and checks it against the baseline.
+ *  - Returns the process exit code: 0, 1 on error or 2 on a regression.
+ */
+static int sim_storm(const SimConfig *config, const SimStormConfig *storm){
+    StormBenchConfig benchConfig = {
+        .runner = "sim",
+        .water = storm->water,
+        .slowMotion = storm->slowMotion,
+        .megaMultiball = config->mode == MODE_MEGA_MULTIBALL,
+        .settleTicks = 0,
+        .measureTicks = 0
+    };
+    StormBench *bench = StormBench_Create(&benchConfig);
+    PhysicsProfiler *profiler = PhysicsProfiler_Create();
+    if (bench == NULL || profiler == NULL){
+        StormBench_Destroy(bench);
+        PhysicsProfiler_Destroy(profiler);
+        return 1;
+    }
+
+    TableInstanceConfig instanceConfig = sim_instance_config(config);
+    instanceConfig.extraBalls = 0;
+    instanceConfig.holdBalls = 0;
+    instanceConfig.profiler = profiler;
+    instanceConfig.stateHash = NULL;
+    TableInstance *instance = TableInstance_Create(&instanceConfig);
+    if (instance == NULL){
+        StormBench_Destroy(bench);
+        PhysicsProfiler_Destroy(profiler);
+        return 1;
+    }
+    TableInstance_StartGame(instance);
+
+    while (StormBench_BeginTick(bench, &instance->game)){
+        TableInstance_Step(instance, 1);
+        PhysicsProfileSample sample;
+        PhysicsProfiler_GetLatest(profiler, &sample);
+        StormBench_EndTick(bench, &sample);
+    }
+    TableInstance_Destroy(instance);
+    PhysicsProfiler_Destroy(profiler);
+
+    int exitCode = StormBench_Finish(bench, storm->baselinePath, storm->writeBaseline, storm->tolerance);
+    StormBench_Destroy(bench);
+    return exitCode;
+}
+
+int main(int argc, char **argv){
+    SimConfig config = {
+        .seconds = 60.0f,
+        .extraBalls = 0,
+        .holdBalls = 0,
+        .workers = 0,
+        .physicsRate = tickRate,
+        .quality = PHYSICS_QUALITY_ADAPTIVE,
+        .mode = MODE_CLASSIC,
+        .tablePath = NULL,
+        .profiler = NULL,
+        .stateHash = NULL
+    };
+    SimStormConfig storm = {
+        .water = 0,
+        .slowMotion = 0,
+        .baselinePath = NULL,
+        .writeBaseline = 0,
+        .tolerance = 0.2f
+    };
+    int scaling = 0;
+    int stormBench = 0;
+    int batchTables = 0;
+    const char *replayPath = NULL;
+    const char *profilePath = NULL;
+    const char *hashPath = NULL;
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc){
+            config.seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--balls") == 0 && i + 1 < argc){
+            config.extraBalls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc){
+            config.workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--physics-hz") == 0 && i + 1 < argc){
+            config.physicsRate = atoi(argv[++i]);
+            if (config.physicsRate < tickRate || config.physicsRate % tickRate != 0){
+                fprintf(stderr, "--physics-hz must be a multiple of %d\n", tickRate);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc){
+            config.tablePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc){
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc){
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc){
+            hashPath = argv[++i];
+        } else if (strcmp(argv[i], "--scaling") == 0){
+            scaling = 1;
+        } else if (strcmp(argv[i], "--storm") == 0){
+            stormBench = 1;
+        } else if (strcmp(argv[i], "--water") == 0){
+            storm.water = 1;
+        } else if (strcmp(argv[i], "--slowmo") == 0){
+            storm.slowMotion = 1;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+            storm.baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0){
+            storm.writeBaseline = 1;
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc){
+            storm.tolerance = atof(argv[++i]) / 100.0f;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc){
+            batchTables = atoi(argv[++i]);
+            if (batchTables < 1 || batchTables > TABLE_INSTANCE_MAX){
+                fprintf(stderr, "--batch takes 1 to %d tables\n", TABLE_INSTANCE_MAX);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc){
+            const char *name = argv[++i];
+            if (strcmp(name, "classic") == 0){
+                config.mode = MODE_CLASSIC;
+            } else if (strcmp(name, "mega") == 0){
+                config.mode = MODE_MEGA_MULTIBALL;
+            } else {
+                fprintf(stderr, "unknown mode '%s' (classic, mega)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc){
+            const char *name = argv[++i];
+            config.quality = PHYSICS_QUALITY_COUNT;
+            for (int q = 0; q < PHYSICS_QUALITY_COUNT; q++){
+                if (strcmp(name, physics_quality_name(q)) == 0){
+                    config.quality = q;
+                }
+            }
+            if (config.quality == PHYSICS_QUALITY_COUNT){
+                fprintf(stderr, "unknown quality '%s' (low, medium, high, adaptive)\n", name);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--balls N] [--quality low|medium|high|adaptive]"
+                            " [--mode classic|mega]"
+                            " [--workers N] [--physics-hz N] [--table FILE] [--replay FILE] [--profile FILE] [--hash FILE] [--scaling] [--batch N]"
+                            " [--storm [--water] [--slowmo] [--baseline FILE] [--write-baseline] [--tolerance PCT]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (scaling){
+        sim_report_scaling(&config);
+        return 0;
+    }
+    if (batchTables > 0){
+        return sim_report_batch(&config, batchTables);
+    }
+    if (stormBench){
+        return sim_storm(&config, &storm);
+    }
+
+    if (profilePath != NULL){
+        config.profiler = PhysicsProfiler_Create();
+    }
+    if (hashPath != NULL){
+        config.stateHash = StateHashWriter_Create(hashPath);
+        if (config.stateHash == NULL){
+            return 1;
+        }
+    }
+
+    SimResult result;
+    if (replayPath != NULL){
+        InputReplay *replay = InputReplay_Open(replayPath);
+        if (replay == NULL){
+            return 1;
+        }
+        result = sim_replay(&config, replay);
+        InputReplay_Close(replay);
+    } else {
+        result = sim_run(&config);
+    }
+    StateHashWriter_Close(config.stateHash);
+    if (result.failed){
+        PhysicsProfiler_Destroy(config.profiler);
+        return 1;
+    }
+    const float timeStep = result.timeStep;
+
+    if (config.profiler != NULL){
+        PhysicsProfiler_Write(config.profiler, profilePath);
+        PhysicsProfiler_Destroy(config.profiler);
+    }
+
+    printf("quality        : %s\n", physics_quality_name(result.quality));
+    printf("mode           : %s\n", Game_GetModeName(result.mode));
+    printf("workers        : %d\n", result.workers);
+    printf("ticks          : %ld\n", result.ticks);
+    printf("simulated time : %.2f s\n", result.ticks * timeStep);
+    printf("wall time      : %.3f s\n", result.wallSeconds);
+    printf("ticks/second   : %.1f\n", result.ticks / result.wallSeconds);
+    printf("realtime factor: %.1fx\n", (result.ticks * timeStep) / result.wallSeconds);
+    printf("games played   : %ld\n", result.gamesPlayed);
+    printf("peak balls     : %ld\n", result.peakBalls);
+    printf("avg sub-steps  : %.2f\n", result.ticks > 0 ? (double)result.totalSubSteps / result.ticks : 0.0);
+    printf("final score    : %ld\n", result.finalScore);
+    return 0;
+}
@@ -0,0 +1,444 @@
+/*
+ * simThread.c - Game simulation on its own thread (see simThread.h)
+ *
+ * Steps are paced against absolute deadlines, start + n / physicsRate seconds
+ * on the monotonic clock, so the rate carries no rounding drift. A step that
+ * falls more than SIM_MAX_LAG_STEPS behind restarts the schedule from now
+ * instead of running a burst of catch-up steps.
+ *
+ * Triple buffer: the sim thread fills buffers[writeIndex], then swaps it with
+ * the shared middle index and marks it fresh; the render thread swaps its
+ * readIndex with the middle one only when it is fresh. Neither side ever
+ * waits on the other, and the reader always gets the newest complete state.
+ */
+
+#include "simThread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "constants.h"
+#include "physics.h"
+#include "game.h"
+#include "menu.h"
+#include "util.h"
+
+#define NANOS_PER_SECOND 1000000000LL
+
+// Steps the thread may fall behind its schedule before it stops catching up
+#define SIM_MAX_LAG_STEPS 16
+
+// Queued UI commands per game tick; more are dropped
+#define SIM_MAX_COMMANDS 16
+
+#define SNAPSHOT_INDEX_MASK 0x3
+#define SNAPSHOT_FRESH      0x4
+
+typedef struct {
+    int numSpawns;
+    float spawnX[SIM_MAX_COMMANDS];
+    float spawnY[SIM_MAX_COMMANDS];
+    int quality;        // -1 if unchanged
+    int keyState;       // latest inputSampleDevices levels (kept across ticks)
+    int keysPressed;    // keys that went down since the last game tick
+} SimCommands;
+
+struct SimThreadObject {
+    SimThreadConfig config;
+    pthread_t thread;
+    int stopRequested;          // atomic
+
+    // World lock, held by the sim thread for each physics step
+    pthread_mutex_t worldMutex;
+
+    // UI commands, swapped out by the sim thread once per game tick
+    pthread_mutex_t commandMutex;
+    SimCommands commands;
+
+    SimSnapshot buffers[3];
+    int writeIndex;             // sim thread only
+    int readIndex;              // render thread only
+    int middle;                 // atomic: buffer index | SNAPSHOT_FRESH
+
+    // Sim thread only, refreshed every game tick and copied into each snapshot
+    PhysicsProfileSample profile;
+    PhysicsProfileSample profilePeak;
+    int stormFinished;
+    int replayFrame;            // clip frame being played, up to replayFrames + physicsRate (the hold)
+    int replayFrames;           // frames in the rewind clip, 0 until the first drain
+};
+
+/* -------------------------------------------------------------------------- */
+/*  Snapshots                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static void sim_snapshot_alloc(SimThread *sim, SimSnapshot *snap) {
+    memset(snap, 0, sizeof(*snap));
+    GameStruct_AllocBalls(&snap->game);
+    GameStruct_AllocBalls(&snap->replay);
+    snap->bumpers = calloc(numBumpers, sizeof(Bumper));
+    snap->menuPinballs = calloc(sim->config.numMenuPinballs, sizeof(MenuPinball));
+}
+
+static void sim_snapshot_free(SimSnapshot *snap) {
+    GameStruct_FreeBalls(&snap->game);
+    GameStruct_FreeBalls(&snap->replay);
+    free(snap->bumpers);
+    free(snap->menuPinballs);
+}
+
+static void sim_snapshot_copy(SimThread *sim, SimSnapshot *snap) {
+    const SimThreadConfig *config = &sim->config;
+    const GameStruct *game = config->game;
+
+    // The struct copy would take the live arrays; keep the snapshot's own
+    Ball *balls = snap->game.balls;
+    int *activeBalls = snap->game.activeBalls;
+    BallTrails trails = snap->game.trails;
+    snap->game = *game;
+    snap->game.balls = balls;
+    snap->game.activeBalls = activeBalls;
+    snap->game.trails = trails;
+    snap->game.bumpers = snap->bumpers;
+    snap->game.water = &snap->water;
+
+    memcpy(activeBalls, game->activeBalls, game->numBalls * sizeof(int));
+    for (int k = 0; k < game->numBalls; k++) {
+        int i = game->activeBalls[k];
+        int row = i * BALL_TRAIL_LENGTH;
+        balls[i] = game->balls[i];
+        memcpy(&trails.x[row], &game->trails.x[row], BALL_TRAIL_LENGTH * sizeof(float));
+        memcpy(&trails.y[row], &game->trails.y[row], BALL_TRAIL_LENGTH * sizeof(float));
+        trails.head[i] = game->trails.head[i];
+    }
+
+    memcpy(snap->bumpers, config->bumpers, numBumpers * sizeof(Bumper));
+    memcpy(snap->menuPinballs, config->menuPinballs, config->numMenuPinballs * sizeof(MenuPinball));
+    memcpy(snap->nameString, config->nameString, sizeof(snap->nameString));
+    snap->water = *config->water;
+    snap->powerups = *config->powerups;
+    snap->quality = physics_get_quality(game);
+    snap->profile = sim->profile;
+    snap->profilePeak = sim->profilePeak;
+    snap->stormStage = sim->config.storm != NULL ? StormBench_GetStage(sim->config.storm) : -1;
+    snap->stormFinished = sim->stormFinished;
+    snap->replayFrames = 0;
+    if (config->rewind != NULL && sim->replayFrames > 0 && game->gameState != 1) {
+        int frame = sim->replayFrame < sim->replayFrames ? sim->replayFrame : sim->replayFrames - 1;
+        RewindBuffer_DecodeClip(config->rewind, frame, &snap->replay);
+        snap->replay.flipperPositions[0] = game->flipperPositions[0];
+        snap->replay.flipperPositions[1] = game->flipperPositions[1];
+        snap->replay.bumpers = snap->bumpers;
+        snap->replay.water = &snap->water;
+        snap->replayFrame = frame;
+        snap->replayFrames = sim->replayFrames;
+    }
+    snap->publishNanos = nanos();
+}
+
+static void sim_publish(SimThread *sim) {
+    sim_snapshot_copy(sim, &sim->buffers[sim->writeIndex]);
+    int previous = __atomic_exchange_n(&sim->middle, sim->writeIndex | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    sim->writeIndex = previous & SNAPSHOT_INDEX_MASK;
+}
+
+const SimSnapshot *SimThread_AcquireSnapshot(SimThread *sim) {
+    if (__atomic_load_n(&sim->middle, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH) {
+        int previous = __atomic_exchange_n(&sim->middle, sim->readIndex, __ATOMIC_ACQ_REL);
+        sim->readIndex = previous & SNAPSHOT_INDEX_MASK;
+    }
+    return &sim->buffers[sim->readIndex];
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Commands                                                                  */
+/* -------------------------------------------------------------------------- */
+
+void SimThread_QueueSpawn(SimThread *sim, float x, float y) {
+    pthread_mutex_lock(&sim->commandMutex);
+    SimCommands *commands = &sim->commands;
+    if (commands->numSpawns < SIM_MAX_COMMANDS) {
+        commands->spawnX[commands->numSpawns] = x;
+        commands->spawnY[commands->numSpawns] = y;
+        commands->numSpawns++;
+    }
+    pthread_mutex_unlock(&sim->commandMutex);
+}
+
+void SimThread_QueueQuality(SimThread *sim, int quality) {
+    pthread_mutex_lock(&sim->commandMutex);
+    sim->commands.quality = quality;
+    pthread_mutex_unlock(&sim->commandMutex);
+}
+
+void SimThread_QueueKeys(SimThread *sim, int keyState, int pressed) {
+    pthread_mutex_lock(&sim->commandMutex);
+    sim->commands.keyState = keyState;
+    sim->commands.keysPressed |= pressed;
+    pthread_mutex_unlock(&sim->commandMutex);
+}
+
+static void sim_take_commands(SimThread *sim, SimCommands *out) {
+    pthread_mutex_lock(&sim->commandMutex);
+    *out = sim->commands;
+    sim->commands.numSpawns = 0;
+    sim->commands.quality = -1;
+    sim->commands.keysPressed = 0;
+    pthread_mutex_unlock(&sim->commandMutex);
+}
+
+// Give the input backend the newest key levels before a physics step. Keys
+// pressed since the tick head count as pressed, and held, for the whole tick,
+// so a tap shorter than a frame still reaches the game and the recording.
+static void sim_feed_keys(SimThread *sim, InputManager *input, const SimCommands *commands) {
+    pthread_mutex_lock(&sim->commandMutex);
+    int keyState = sim->commands.keyState;
+    pthread_mutex_unlock(&sim->commandMutex);
+    inputFeedDevices(input, keyState | commands->keysPressed, commands->keysPressed);
+}
+
+void SimThread_LockWorld(SimThread *sim) {
+    pthread_mutex_lock(&sim->worldMutex);
+}
+
+void SimThread_UnlockWorld(SimThread *sim) {
+    pthread_mutex_unlock(&sim->worldMutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Thread                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static void sim_sleep_until(long long deadline) {
+    long long remaining = deadline - nanos();
+    if (remaining > 0) {
+        struct timespec ts;
+        ts.tv_sec = remaining / NANOS_PER_SECOND;
+        ts.tv_nsec = remaining % NANOS_PER_SECOND;
+        nanosleep(&ts, NULL);
+    }
+}
+
+// Tell the Pico about menu / gameplay / game over so it can switch button LED patterns
+static void sim_notify_game_state(InputManager *input, int gameState) {
+    switch (gameState) {
+        case 0:
+            inputSetGameState(input, STATE_MENU);
+            break;
+        case 1:
+            inputSetGameState(input, STATE_GAME);
+            break;
+        case 2:
+            inputSetGameState(input, STATE_GAME_OVER);
+            break;
+        default:
+            break;
+    }
+}
+
+static void *sim_thread_main(void *arg) {
+    SimThread *sim = arg;
+    const SimThreadConfig *config = &sim->config;
+    GameStruct *game = config->game;
+    InputManager *input = config->input;
+    SoundManager *sound = config->sound;
+    InputRecorder *recorder = config->recorder;
+    PhysicsProfiler *profiler = config->profiler;
+    StormBench *storm = profiler != NULL ? config->storm : NULL;
+    RewindBuffer *rewind = config->rewind;
+
+    const int stepsPerTick = config->physicsRate / tickRate;
+    const float timeStep = 1.0f / tickRate;
+    const long long lagLimit = SIM_MAX_LAG_STEPS * NANOS_PER_SECOND / config->physicsRate;
+
+    long long scheduleStart = nanos();
+    long long scheduleStep = 0;
+    long gameTicks = 0;
+    int subStep = 0;
+    float physicsDt = 0.0f;
+    int keyState = 0;               // at the head of this game tick, as recorded
+    int stepKeys = 0;               // at the current physics step
+    int lastGameState = game->gameState;
+    SimCommands commands = {0};
+    long long tickWorkNanos = 0;    // this tick's time outside sim_sleep_until
+
+    while (!__atomic_load_n(&sim->stopRequested, __ATOMIC_ACQUIRE)) {
+        long long deadline = scheduleStart + scheduleStep * NANOS_PER_SECOND / config->physicsRate;
+        sim_sleep_until(deadline);
+        long long now = nanos();
+        if (now - deadline > lagLimit) {
+            printf("[SIM] fell %.1f steps behind, skipping ahead\n",
+                   (now - deadline) * (double)config->physicsRate / NANOS_PER_SECOND);
+            scheduleStart = now;
+            scheduleStep = 0;
+        }
+        scheduleStep++;
+        long long stepStart = nanos();
+
+        pthread_mutex_lock(&sim->worldMutex);
+        if (subStep == 0) {
+            sim_take_commands(sim, &commands);
+        }
+        sim_feed_keys(sim, input, &commands);
+        inputUpdate(input);
+        int keys = (inputLeft(input) ? 1 : 0) | (inputCenter(input) ? 2 : 0) | (inputRight(input) ? 4 : 0);
+        if (subStep == 0) {
+            keyState = keys;
+        } else if (keys != stepKeys && recorder != NULL) {
+            InputRecorder_AddKeys(recorder, subStep, keys);
+        }
+        stepKeys = keys;
+
+        if (subStep == 0) {
+            // Game tick head (sim_replay runs the same sequence)
+            if (profiler != NULL) {
+                PhysicsProfiler_BeginTick(profiler);
+            }
+            tickWorkNanos = 0;
+            if (commands.quality >= 0) {
+                physics_set_quality(game, commands.quality);
+                if (recorder != NULL) {
+                    InputRecorder_AddQuality(recorder, commands.quality);
+                }
+            }
+            if (storm != NULL && game->gameState == 1 && !sim->stormFinished) {
+                sim->stormFinished = !StormBench_BeginTick(storm, game);
+            }
+            updateSound(sound, game);
+            Game_Update(game, config->bumpers, input, config->scores, sound, timeStep);
+            if (game->gameState == 0) {
+                Menu_Update(game, config->menuPinballs, config->numMenuPinballs, input, sound);
+            }
+            physicsDt = Game_BeginPlayfield(game, config->powerups, input, sound, timeStep) / stepsPerTick;
+        }
+
+        if (physicsDt > 0.0f) {
+            Game_StepPlayfieldPhysics(game, config->leftFlipperBody, config->rightFlipperBody,
+                                      input, sound, physicsDt);
+        }
+        if (rewind != NULL) {
+            if (game->gameState == 1) {
+                RewindBuffer_Capture(rewind, game);
+            } else if (sim->replayFrames > 0) {
+                sim->replayFrame = (sim->replayFrame + 1) % (sim->replayFrames + config->physicsRate);
+            }
+        }
+
+        if (subStep == stepsPerTick - 1) {
+            // Game tick tail
+            if (physicsDt > 0.0f) {
+                int ballsBefore = game->numBalls;
+                Game_EndPlayfield(game, config->bumpers, config->powerups, input, sound);
+                if (rewind != NULL && ballsBefore > 0 && game->numBalls == 0) {
+                    // The last ball drained: this is the clip the next screens play
+                    sim->replayFrames = RewindBuffer_Freeze(rewind);
+                    sim->replayFrame = 0;
+                }
+            }
+            if (game->gameState == 1) {
+                for (int i = 0; i < commands.numSpawns; i++) {
+                    physics_add_ball(game, commands.spawnX[i], commands.spawnY[i], 0, 0, 1);
+                    if (recorder != NULL) {
+                        InputRecorder_AddSpawn(recorder, commands.spawnX[i], commands.spawnY[i]);
+                    }
+                }
+            }
+            if (game->gameState == 2) {
+                Scoreboard_Update(game, input, config->scores, config->nameString);
+            }
+            if (recorder != NULL) {
+                InputRecorder_EndTick(recorder, keyState);
+            }
+            Water_Step(config->water, gameTicks * timeStep);
+            gameTicks++;
+            if (profiler != NULL) {
+                tickWorkNanos += nanos() - stepStart;
+                PhysicsProfiler_EndTick(profiler, game->numBalls, tickWorkNanos / 1e6f);
+                PhysicsProfiler_GetLatest(profiler, &sim->profile);
+                PhysicsProfiler_GetPeak(profiler, tickRate, &sim->profilePeak);
+                if (storm != NULL && !sim->stormFinished) {
+                    StormBench_EndTick(storm, &sim->profile);
+                }
+            }
+
+            if (game->gameState != lastGameState) {
+                sim_notify_game_state(input, game->gameState);
+                if (rewind != NULL && game->gameState == 1) {
+                    RewindBuffer_Clear(rewind);
+                }
+                if (lastGameState == 1) {
+                    sim->replayFrame = 0;
+                }
+                lastGameState = game->gameState;
+            }
+        }
+        pthread_mutex_unlock(&sim->worldMutex);
+
+        sim_publish(sim);
+        if (subStep != stepsPerTick - 1) {
+            tickWorkNanos += nanos() - stepStart;
+        }
+        subStep = (subStep + 1) % stepsPerTick;
+    }
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Lifecycle                                                                 */
+/* -------------------------------------------------------------------------- */
+
+SimThread *SimThread_Start(const SimThreadConfig *config) {
+    if (config->physicsRate < SIM_THREAD_MIN_RATE || config->physicsRate > SIM_THREAD_MAX_RATE ||
+        config->physicsRate % tickRate != 0) {
+        printf("SimThread_Start: physics rate %d is not a multiple of %d in [%d, %d]\n",
+               config->physicsRate, tickRate, SIM_THREAD_MIN_RATE, SIM_THREAD_MAX_RATE);
+        return NULL;
+    }
+
+    SimThread *sim = calloc(1, sizeof(SimThread));
+    sim->config = *config;
+    sim->commands.quality = -1;
+    pthread_mutex_init(&sim->worldMutex, NULL);
+    pthread_mutex_init(&sim->commandMutex, NULL);
+    for (int i = 0; i < 3; i++) {
+        sim_snapshot_alloc(sim, &sim->buffers[i]);
+    }
+
+    // Publish the initial state so the first AcquireSnapshot has something to draw
+    sim->writeIndex = 0;
+    sim->middle = 1;
+    sim->readIndex = 2;
+    sim_publish(sim);
+    SimThread_AcquireSnapshot(sim);
+
+    if (pthread_create(&sim->thread, NULL, sim_thread_main, sim) != 0) {
+        printf("SimThread_Start: cannot create thread\n");
+        for (int i = 0; i < 3; i++) {
+            sim_snapshot_free(&sim->buffers[i]);
+        }
+        pthread_mutex_destroy(&sim->worldMutex);
+        pthread_mutex_destroy(&sim->commandMutex);
+        free(sim);
+        return NULL;
+    }
+    return sim;
+}
+
+void SimThread_Stop(SimThread *sim) {
+    if (sim == NULL) {
+        return;
+    }
+    __atomic_store_n(&sim->stopRequested, 1, __ATOMIC_RELEASE);
+    pthread_join(sim->thread, NULL);
+    for (int i = 0; i < 3; i++) {
+        sim_snapshot_free(&sim->buffers[i]);
+    }
+    pthread_mutex_destroy(&sim->worldMutex);
+    pthread_mutex_destroy(&sim->commandMutex);
+    free(sim);
+}
+
+int SimThread_GetPhysicsRate(const SimThread *sim) {
+    return sim->config.physicsRate;
+}
@@ -0,0 +1,119 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "gameStruct.h"
+#include "inputManager.h"
+#include "soundManager.h"
+#include "scores.h"
+#include "powerups.h"
+#include "water.h"
+#include "inputRecord.h"
+#include "physicsProfile.h"
+#include "stormBench.h"
+#include "rewindBuffer.h"
+
+/*
+ * simThread.h - Game simulation on its own thread
+ *
+ * The sim thread owns the GameStruct, the Box2D world, input and sound while
+ * it runs; it also submits scores, which the menu reads on the render thread.
+ * It steps physics at physicsRate ticks per second and the game logic
+ * (Game_Update, menu, playfield rules, scoreboard) at tickRate, polling input
+ * before every physics step, so flipper response follows the physics rate
+ * instead of the display refresh.
+ *
+ * After every physics step the thread publishes a SimSnapshot through a
+ * lock-free triple buffer. The render thread draws the latest snapshot and
+ * never reads the live GameStruct or the world; UI input that changes the
+ * simulation (mouse spawns, quality changes) is queued with SimThread_Queue*,
+ * and so are the desktop keyboard and gamepad, which raylib only lets the
+ * render thread read.
+ *
+ * With a RewindBuffer the thread captures every physics step of play, freezes
+ * the clip when the last ball drains and, outside gameplay, steps through the
+ * clip (holding the last frame for a second) and decodes the current frame
+ * into each snapshot.
+ *
+ * Per game tick the thread runs the sequence pinball_sim --replay repeats;
+ * keep sim_replay in simMain.c in sync.
+ */
+
+// Accepted physicsRate range; it must also be a multiple of tickRate
+#define SIM_THREAD_MIN_RATE 60
+#define SIM_THREAD_MAX_RATE 960
+
+typedef struct {
+    GameStruct *game;
+    Bumper *bumpers;
+    b2BodyId *leftFlipperBody;
+    b2BodyId *rightFlipperBody;
+    PowerupSystem *powerups;
+    MenuPinball *menuPinballs;
+    int numMenuPinballs;
+    InputManager *input;
+    ScoreHelper *scores;
+    SoundManager *sound;
+    WaterSystem *water;
+    char *nameString;           // 6 bytes, edited by Scoreboard_Update
+    InputRecorder *recorder;    // NULL when not recording
+    PhysicsProfiler *profiler;  // NULL to skip profiling; also give it to physics_set_profiler
+    StormBench *storm;          // ball-storm benchmark to drive (needs the profiler), or NULL
+    RewindBuffer *rewind;       // instant replay, created for physicsRate frames per second, or NULL
+    int physicsRate;            // physics steps per second, a multiple of tickRate
+} SimThreadConfig;
+
+// One published state. game is a copy whose balls, activeBalls, trails,
+// bumpers and water point into the snapshot; only the active balls and their
+// trail rows are copied.
+typedef struct {
+    GameStruct game;
+    Bumper *bumpers;
+    WaterSystem water;
+    PowerupSystem powerups;
+    MenuPinball *menuPinballs;
+    char nameString[6];
+    int quality;                // PhysicsQuality in effect
+    PhysicsProfileSample profile;       // last finished game tick (zero without a profiler)
+    PhysicsProfileSample profilePeak;   // per-field maximum over the last second
+    int stormStage;             // StormBench_GetStage, -1 without a benchmark
+    int stormFinished;          // the benchmark ramp is over
+    // Instant replay of the last drain, played on the game-over and attract
+    // screens: replay holds the balls, flippers and powerup state of the
+    // current clip frame (and shares bumpers and water with game). Only
+    // meaningful while replayFrames > 0, which is never during gameplay.
+    GameStruct replay;
+    int replayFrame;
+    int replayFrames;
+    long long publishNanos;     // nanos() at publication; the render interpolates from here
+} SimSnapshot;
+
+typedef struct SimThreadObject SimThread;
+
+// Start simulating. Returns NULL (after printing why) if the thread cannot start.
+SimThread *SimThread_Start(const SimThreadConfig *config);
+
+// Stop the thread and free the snapshots. The config's objects are the caller's again.
+void SimThread_Stop(SimThread *sim);
+
+int SimThread_GetPhysicsRate(const SimThread *sim);
+
+// Latest published snapshot. It stays valid and unchanged until the next call;
+// call from one thread only.
+const SimSnapshot *SimThread_AcquireSnapshot(SimThread *sim);
+
+// Spawn a ball at the end of the next game tick (ignored outside gameplay)
+void SimThread_QueueSpawn(SimThread *sim, float x, float y);
+
+// Switch the physics quality preset before the next game tick
+void SimThread_QueueQuality(SimThread *sim, int quality);
+
+// This frame's inputSampleDevices result. Levels apply from the next physics
+// step, presses from the next game tick; presses between two ticks add up.
+void SimThread_QueueKeys(SimThread *sim, int keyState, int pressed);
+
+// Hold off the sim thread between physics steps, e.g. while physics_debug_draw
+// walks the world.
+void SimThread_LockWorld(SimThread *sim);
+void SimThread_UnlockWorld(SimThread *sim);
+
+#endif // SIM_THREAD_H
@@ -5,6 +5,24 @@
 #include <math.h>
 #include "soundManager.h"
 
+struct SoundManagerObject {
+    Music menuMusic;
+    Music gameMusic;
+    Sound* redPowerup;
+    Sound* bluePowerup;
+    Sound* slowdown;
+    Sound* speedup;
+    Sound* upperBouncer;
+    Sound* click;
+    Sound* bounce1;
+    Sound* bounce2;
+    Sound *flipper;
+    Sound *waterSplash;
+    Sound launch;
+    Sound water;
+    float gameMusicVolume;
+};
+
 // Forward declaration for older raylib versions that use IsMusicStreamPlaying()
 bool IsMusicStreamPlaying(Music music);
 
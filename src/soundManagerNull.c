@@ -0,0 +1,34 @@
+#include <stdlib.h>
+#include "soundManager.h"
+
+// Silent sound backend for headless builds (pinball_sim).
+// Mirrors the soundManager.h API without opening an audio device.
+
+struct SoundManagerObject {
+    float gameMusicVolume;
+};
+
+SoundManager *initSound(){
+    SoundManager *sound = malloc(sizeof(SoundManager));
+    sound->gameMusicVolume = 1.0f;
+    return sound;
+}
+void updateSound(SoundManager *sound, GameStruct *game){
+    (void)sound;
+    (void)game;
+}
+void playBounce(SoundManager *sound){ (void)sound; }
+void playBounce2(SoundManager *sound){ (void)sound; }
+void playClick(SoundManager *sound){ (void)sound; }
+void playSlowdownSound(SoundManager *sound){ (void)sound; }
+void playSpeedupSound(SoundManager *sound){ (void)sound; }
+void playRedPowerupSound(SoundManager *sound){ (void)sound; }
+void playBluePowerupSound(SoundManager *sound){ (void)sound; }
+void playUpperBouncerSound(SoundManager *sound){ (void)sound; }
+void playLaunch(SoundManager *sound){ (void)sound; }
+void playFlipper(SoundManager *sound){ (void)sound; }
+void playWater(SoundManager *sound){ (void)sound; }
+void playWaterSplash(SoundManager *sound){ (void)sound; }
+void shutdownSound(SoundManager *sound){
+    free(sound);
+}
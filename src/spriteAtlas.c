@@ -0,0 +1,182 @@
+/*
+ * spriteAtlas.c - The gameplay sprites packed into one texture (see spriteAtlas.h)
+ *
+ * Sprites are packed tallest first into shelves across a fixed-width atlas.
+ * Each sprite is surrounded by ATLAS_PADDING copies of its edge pixels, so
+ * filtering at a sprite's border never picks up its neighbour.
+ */
+
+#include "spriteAtlas.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ATLAS_WIDTH   1024
+#define ATLAS_PADDING 2
+
+static const char *spriteNames[SPRITE_COUNT] = {
+    "ball",
+    "beachBall",
+    "trail",
+    "bumper",
+    "bumperLight",
+    "iceBumper",
+    "bumper3",
+    "lowerBumperShock",
+    "shockwave",
+    "particle",
+    "flipperL",
+    "flipperR",
+    "arrowRight",
+    "debugSmall"
+};
+
+const char *SpriteAtlas_GetName(int sprite) {
+    return sprite >= 0 && sprite < SPRITE_COUNT ? spriteNames[sprite] : "unknown";
+}
+
+// Copy sprite (RGBA) to (x, y) in atlas, repeating its edge pixels into the padding
+static void atlas_blit(Image *atlas, const Image *sprite, int x, int y) {
+    unsigned char *dst = atlas->data;
+    const unsigned char *src = sprite->data;
+    int w = sprite->width;
+    int h = sprite->height;
+
+    for (int row = -ATLAS_PADDING; row < h + ATLAS_PADDING; row++) {
+        int sourceRow = row < 0 ? 0 : (row >= h ? h - 1 : row);
+        const unsigned char *in = src + (size_t)sourceRow * w * 4;
+        unsigned char *out = dst + ((size_t)(y + row) * atlas->width + x - ATLAS_PADDING) * 4;
+        for (int i = 0; i < ATLAS_PADDING; i++) {
+            memcpy(out, in, 4);
+            out += 4;
+        }
+        memcpy(out, in, (size_t)w * 4);
+        out += (size_t)w * 4;
+        for (int i = 0; i < ATLAS_PADDING; i++) {
+            memcpy(out, in + (size_t)(w - 1) * 4, 4);
+            out += 4;
+        }
+    }
+}
+
+int SpriteAtlas_Pack(const char *textureDir, Image *atlas, Rectangle rects[SPRITE_COUNT]) {
+    Image images[SPRITE_COUNT] = {0};
+    int order[SPRITE_COUNT];
+    int result = -1;
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        const char *path = TextFormat("%s/%s.png", textureDir, spriteNames[i]);
+        images[i] = LoadImage(path);
+        if (images[i].data == NULL) {
+            printf("SpriteAtlas_Pack: cannot load %s\n", path);
+            goto done;
+        }
+        if (images[i].width + 2 * ATLAS_PADDING > ATLAS_WIDTH) {
+            printf("SpriteAtlas_Pack: %s is wider than the %d pixel atlas\n", path, ATLAS_WIDTH);
+            goto done;
+        }
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+
+    // Tallest first (stable, so the same sprites always pack the same way)
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        int k = i;
+        while (k > 0 && images[order[k - 1]].height < images[i].height) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (int k = 0; k < SPRITE_COUNT; k++) {
+        const Image *image = &images[order[k]];
+        int cellWidth = image->width + 2 * ATLAS_PADDING;
+        int cellHeight = image->height + 2 * ATLAS_PADDING;
+        if (x + cellWidth > ATLAS_WIDTH) {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        rects[order[k]] = (Rectangle){ x + ATLAS_PADDING, y + ATLAS_PADDING, image->width, image->height };
+        x += cellWidth;
+        if (cellHeight > shelfHeight) {
+            shelfHeight = cellHeight;
+        }
+    }
+
+    int atlasHeight = 1;
+    while (atlasHeight < y + shelfHeight) {
+        atlasHeight *= 2;
+    }
+    *atlas = GenImageColor(ATLAS_WIDTH, atlasHeight, BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        atlas_blit(atlas, &images[i], (int)rects[i].x, (int)rects[i].y);
+    }
+    result = 0;
+
+done:
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        if (images[i].data != NULL) {
+            UnloadImage(images[i]);
+        }
+    }
+    return result;
+}
+
+int SpriteAtlas_WriteTable(const char *path, int width, int height, const Rectangle rects[SPRITE_COUNT]) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("SpriteAtlas_WriteTable: cannot open %s\n", path);
+        return -1;
+    }
+    fprintf(file, "atlas %d %d\n", width, height);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        fprintf(file, "%s %d %d %d %d\n", spriteNames[i],
+                (int)rects[i].x, (int)rects[i].y, (int)rects[i].width, (int)rects[i].height);
+    }
+    if (fclose(file) != 0) {
+        printf("SpriteAtlas_WriteTable: write to %s failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+int SpriteAtlas_ReadTable(const char *path, int width, int height, Rectangle rects[SPRITE_COUNT]) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        printf("SpriteAtlas_ReadTable: cannot open %s\n", path);
+        return -1;
+    }
+    int tableWidth = 0;
+    int tableHeight = 0;
+    if (fscanf(file, " atlas %d %d", &tableWidth, &tableHeight) != 2 ||
+        tableWidth != width || tableHeight != height) {
+        printf("SpriteAtlas_ReadTable: %s is not the table for a %d x %d atlas\n", path, width, height);
+        fclose(file);
+        return -1;
+    }
+
+    int found[SPRITE_COUNT] = {0};
+    char name[64];
+    int x, y, w, h;
+    while (fscanf(file, " %63s %d %d %d %d", name, &x, &y, &w, &h) == 5) {
+        for (int i = 0; i < SPRITE_COUNT; i++) {
+            if (strcmp(name, spriteNames[i]) == 0 &&
+                x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= width && y + h <= height) {
+                rects[i] = (Rectangle){ x, y, w, h };
+                found[i] = 1;
+            }
+        }
+    }
+    fclose(file);
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        if (!found[i]) {
+            printf("SpriteAtlas_ReadTable: %s has no rect for %s\n", path, spriteNames[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include "raylib.h"
+
+/*
+ * spriteAtlas.h - The gameplay sprites packed into one texture
+ *
+ * Every sprite Render_Gameplay and the menus draw (balls, trails, bumpers,
+ * shockwaves, flippers, arrows) lives in one atlas image, so consecutive
+ * sprite draws share a texture and raylib keeps them in one batch. Full-screen
+ * images (backgrounds, overlays, the water textures) stay separate textures.
+ *
+ * pinball_atlastool packs the PNGs in Resources/Textures into
+ * SPRITE_ATLAS_IMAGE plus SPRITE_ATLAS_TABLE, a text rect table:
+ *
+ *   atlas WIDTH HEIGHT
+ *   NAME X Y WIDTH HEIGHT        (one line per sprite, in pixels)
+ *
+ * Resources_Init loads both, and packs the atlas itself when they are missing
+ * or do not list every sprite.
+ */
+
+#define SPRITE_ATLAS_IMAGE "sprites.png"
+#define SPRITE_ATLAS_TABLE "sprites.atlas"
+
+typedef enum {
+    SPRITE_BALL = 0,
+    SPRITE_BEACH_BALL,
+    SPRITE_TRAIL,
+    SPRITE_BUMPER,
+    SPRITE_BUMPER_LIGHT,
+    SPRITE_ICE_BUMPER,
+    SPRITE_BUMPER3,
+    SPRITE_LOWER_BUMPER_SHOCK,
+    SPRITE_SHOCKWAVE,
+    SPRITE_PARTICLE,
+    SPRITE_LEFT_FLIPPER,
+    SPRITE_RIGHT_FLIPPER,
+    SPRITE_ARROW_RIGHT,
+    SPRITE_DEBUG,
+    SPRITE_COUNT
+} SpriteId;
+
+// Source file name without ".png", e.g. "flipperL"; also the name in the table
+const char *SpriteAtlas_GetName(int sprite);
+
+// Pack the sprite PNGs in textureDir into *atlas (RGBA, power-of-two height)
+// and their rects. Returns 0 on success, -1 (after printing why) on failure.
+int SpriteAtlas_Pack(const char *textureDir, Image *atlas, Rectangle rects[SPRITE_COUNT]);
+
+// Write / read the rect table. ReadTable fails (-1) unless the table lists
+// every sprite for an atlas of the given size.
+int SpriteAtlas_WriteTable(const char *path, int width, int height, const Rectangle rects[SPRITE_COUNT]);
+int SpriteAtlas_ReadTable(const char *path, int width, int height, Rectangle rects[SPRITE_COUNT]);
+
+#endif // SPRITE_ATLAS_H
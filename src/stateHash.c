@@ -0,0 +1,238 @@
+/*
+ * stateHash.c - Per-step simulation state hashes (see stateHash.h)
+ */
+
+#include "stateHash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+
+static const char hashMagic[4] = { 'P', 'B', 'S', 'H' };
+
+#define HASH_HEADER_SIZE 12
+#define FNV_OFFSET       2166136261u
+#define FNV_PRIME        16777619u
+
+static const char *fieldNames[STATE_HASH_FIELDS] = {
+    "ball positions",
+    "ball velocities",
+    "ball state",
+    "flippers",
+    "score",
+    "game",
+    "powerups",
+    "bumpers"
+};
+
+struct StateHashWriterObject {
+    FILE *file;
+    uint32_t step;
+};
+
+struct StateHashReaderObject {
+    FILE *file;
+    int fieldCount;
+};
+
+const char *StateHash_GetFieldName(int field) {
+    return field >= 0 && field < STATE_HASH_FIELDS ? fieldNames[field] : "unknown";
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Hashing                                                                   */
+/* -------------------------------------------------------------------------- */
+
+// Values are hashed as their little-endian bytes, so both ends of a
+// comparison hash the same byte sequence whatever the host order.
+static uint32_t hash_u32(uint32_t hash, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ (value & 0xff)) * FNV_PRIME;
+        value >>= 8;
+    }
+    return hash;
+}
+
+static uint32_t hash_int(uint32_t hash, long value) {
+    return hash_u32(hash, (uint32_t)value);
+}
+
+// The exact bits: -0.0 and 0.0 differ, as any rounding difference should
+static uint32_t hash_float(uint32_t hash, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return hash_u32(hash, bits);
+}
+
+void StateHash_Compute(const GameStruct *game, uint32_t fields[STATE_HASH_FIELDS]) {
+    uint32_t positions = hash_int(FNV_OFFSET, game->numBalls);
+    uint32_t velocities = FNV_OFFSET;
+    uint32_t ballState = FNV_OFFSET;
+    for (int k = 0; k < game->numBalls; k++) {
+        int i = game->activeBalls[k];
+        const Ball *ball = &game->balls[i];
+        positions = hash_int(positions, i);
+        positions = hash_float(positions, ball->position.x);
+        positions = hash_float(positions, ball->position.y);
+        // Ball.velocity is the step's displacement over dt, already implied by
+        // the positions; the body's own velocity is what carries into the next step
+        b2Vec2 linearVelocity = b2Body_GetLinearVelocity(ball->body);
+        velocities = hash_float(velocities, linearVelocity.x);
+        velocities = hash_float(velocities, linearVelocity.y);
+        velocities = hash_float(velocities, b2Body_GetAngularVelocity(ball->body));
+        ballState = hash_int(ballState, ball->type);
+        ballState = hash_int(ballState, ball->killCounter);
+        ballState = hash_int(ballState, ball->asleep);
+        ballState = hash_int(ballState, ball->flipperContacts);
+        ballState = hash_int(ballState, ball->underwaterState);
+    }
+    fields[STATE_HASH_BALL_POSITIONS] = positions;
+    fields[STATE_HASH_BALL_VELOCITIES] = velocities;
+    fields[STATE_HASH_BALL_STATE] = ballState;
+
+    uint32_t hash = hash_float(FNV_OFFSET, game->flipperAngles[0]);
+    fields[STATE_HASH_FLIPPERS] = hash_float(hash, game->flipperAngles[1]);
+
+    hash = hash_int(FNV_OFFSET, game->gameScore);
+    fields[STATE_HASH_SCORE] = hash_int(hash, game->powerupScore);
+
+    hash = hash_int(FNV_OFFSET, game->gameState);
+    hash = hash_int(hash, game->numLives);
+    hash = hash_int(hash, game->currentMode);
+    fields[STATE_HASH_GAME] = hash_int(hash, game->transitionState);
+
+    hash = hash_float(FNV_OFFSET, game->waterHeight);
+    hash = hash_float(hash, game->waterHeightTarget);
+    hash = hash_float(hash, game->waterHeightTimer);
+    hash = hash_int(hash, game->waterPowerupState);
+    hash = hash_int(hash, game->bumperPowerupState);
+    hash = hash_int(hash, game->ballPowerupState);
+    hash = hash_int(hash, game->slowMotion);
+    hash = hash_int(hash, game->slowMotionCounter);
+    hash = hash_float(hash, game->slowMotionFactor);
+    hash = hash_int(hash, game->slowMoPowerupAvailable);
+    hash = hash_float(hash, game->slowMoCooldownTimer);
+    fields[STATE_HASH_POWERUPS] = hash_int(hash, game->slowMoCooldownBaselineLives);
+
+    hash = FNV_OFFSET;
+    for (int i = 0; game->bumpers != NULL && i < numBumpers; i++) {
+        hash = hash_int(hash, game->bumpers[i].enabled);
+        hash = hash_float(hash, game->bumpers[i].bounceEffect);
+        hash = hash_float(hash, game->bumpers[i].enabledSize);
+    }
+    fields[STATE_HASH_BUMPERS] = hash;
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Writing                                                                   */
+/* -------------------------------------------------------------------------- */
+
+static void put_u32(uint8_t *p, uint32_t value) {
+    p[0] = value & 0xff;
+    p[1] = (value >> 8) & 0xff;
+    p[2] = (value >> 16) & 0xff;
+    p[3] = value >> 24;
+}
+
+StateHashWriter *StateHashWriter_Create(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("StateHashWriter_Create: cannot open %s\n", path);
+        return NULL;
+    }
+    StateHashWriter *writer = calloc(1, sizeof(StateHashWriter));
+    writer->file = file;
+
+    uint8_t header[HASH_HEADER_SIZE] = {0};
+    memcpy(header, hashMagic, sizeof(hashMagic));
+    header[4] = STATE_HASH_VERSION & 0xff;
+    header[5] = STATE_HASH_VERSION >> 8;
+    header[6] = STATE_HASH_FIELDS & 0xff;
+    header[7] = STATE_HASH_FIELDS >> 8;
+    fwrite(header, 1, sizeof(header), file);
+    return writer;
+}
+
+void StateHashWriter_Add(StateHashWriter *writer, const GameStruct *game) {
+    uint32_t fields[STATE_HASH_FIELDS];
+    StateHash_Compute(game, fields);
+
+    uint8_t record[4 + 4 * STATE_HASH_FIELDS];
+    put_u32(record, writer->step++);
+    for (int f = 0; f < STATE_HASH_FIELDS; f++) {
+        put_u32(record + 4 + 4 * f, fields[f]);
+    }
+    fwrite(record, 1, sizeof(record), writer->file);
+}
+
+void StateHashWriter_Close(StateHashWriter *writer) {
+    if (writer == NULL) {
+        return;
+    }
+    if (fclose(writer->file) != 0) {
+        printf("StateHashWriter_Close: write failed\n");
+    }
+    free(writer);
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Reading                                                                   */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+StateHashReader *StateHashReader_Open(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("StateHashReader_Open: cannot open %s\n", path);
+        return NULL;
+    }
+    uint8_t header[HASH_HEADER_SIZE];
+    int version = 0;
+    int fieldCount = 0;
+    if (fread(header, 1, sizeof(header), file) == sizeof(header)) {
+        version = header[4] | (header[5] << 8);
+        fieldCount = header[6] | (header[7] << 8);
+    }
+    if (memcmp(header, hashMagic, sizeof(hashMagic)) != 0 || version != STATE_HASH_VERSION || fieldCount == 0) {
+        printf("StateHashReader_Open: %s is not a version %d hash stream\n", path, STATE_HASH_VERSION);
+        fclose(file);
+        return NULL;
+    }
+    StateHashReader *reader = calloc(1, sizeof(StateHashReader));
+    reader->file = file;
+    reader->fieldCount = fieldCount;
+    return reader;
+}
+
+int StateHashReader_GetFieldCount(const StateHashReader *reader) {
+    return reader->fieldCount;
+}
+
+int StateHashReader_Next(StateHashReader *reader, StateHashRecord *out) {
+    uint8_t bytes[4];
+    if (fread(bytes, 1, 4, reader->file) != 4) {
+        return 0;
+    }
+    out->step = get_u32(bytes);
+    memset(out->fields, 0, sizeof(out->fields));
+    for (int f = 0; f < reader->fieldCount; f++) {
+        if (fread(bytes, 1, 4, reader->file) != 4) {
+            return 0;   // truncated record
+        }
+        if (f < STATE_HASH_FIELDS) {
+            out->fields[f] = get_u32(bytes);
+        }
+    }
+    return 1;
+}
+
+void StateHashReader_Close(StateHashReader *reader) {
+    if (reader == NULL) {
+        return;
+    }
+    fclose(reader->file);
+    free(reader);
+}
@@ -0,0 +1,77 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include <stdint.h>
+#include "gameStruct.h"
+
+/*
+ * stateHash.h - Per-step simulation state hashes, for determinism checks
+ *
+ * With a StateHashWriter attached (physics_set_state_hash), every physics_step
+ * hashes the simulation state it leaves behind and appends one record to a
+ * stream. The state is split into fields so that a divergence can be traced
+ * to balls, flippers, score or powerups; each field is a 32-bit FNV-1a over
+ * the exact bits of its values. Replaying the same recording on two machines
+ * (pinball_sim --replay REC --hash FILE) and comparing the streams with
+ * pinball_hashdiff shows the first step and fields where they part.
+ *
+ * Hashing is a few hundred bytes per step and each record 4 + 4 * fields
+ * bytes, buffered, so it can stay on for soak runs.
+ *
+ * File format (little-endian):
+ *
+ *   header : char magic[4] = "PBSH", u16 version, u16 field count, u32 reserved
+ *   records: u32 step (physics_step calls since the writer was attached),
+ *            then one u32 hash per field, in StateHashField order
+ */
+
+#define STATE_HASH_VERSION 2
+
+typedef enum {
+    STATE_HASH_BALL_POSITIONS = 0,  // active list order, slots and positions
+    STATE_HASH_BALL_VELOCITIES,     // Box2D linear and angular velocity of each ball body
+    STATE_HASH_BALL_STATE,          // type, stuck timer, sleep, flipper contacts, underwater
+    STATE_HASH_FLIPPERS,            // flipper angles
+    STATE_HASH_SCORE,               // game and powerup score
+    STATE_HASH_GAME,                // game state, lives, mode, transition
+    STATE_HASH_POWERUPS,            // water, slow motion and the powerup states and timers
+    STATE_HASH_BUMPERS,             // enabled, bounce and size animation
+    STATE_HASH_FIELDS
+} StateHashField;
+
+typedef struct {
+    uint32_t step;
+    uint32_t fields[STATE_HASH_FIELDS];
+} StateHashRecord;
+
+typedef struct StateHashWriterObject StateHashWriter;
+typedef struct StateHashReaderObject StateHashReader;
+
+// e.g. "ball positions"
+const char *StateHash_GetFieldName(int field);
+
+// Hash the state physics_step leaves in game (reads the ball bodies' velocities
+// from game->world, so only while no other thread steps it)
+void StateHash_Compute(const GameStruct *game, uint32_t fields[STATE_HASH_FIELDS]);
+
+// Start a stream. Returns NULL (after printing why) if the file cannot be created.
+StateHashWriter *StateHashWriter_Create(const char *path);
+
+// Append the record for the step just taken (called by physics_step)
+void StateHashWriter_Add(StateHashWriter *writer, const GameStruct *game);
+
+// Flush and close. Safe to call with NULL.
+void StateHashWriter_Close(StateHashWriter *writer);
+
+// Open a stream. Returns NULL (after printing why) if it cannot be read.
+StateHashReader *StateHashReader_Open(const char *path);
+
+// Fields per record in the file (streams from other builds may differ)
+int StateHashReader_GetFieldCount(const StateHashReader *reader);
+
+// Next record; fields past STATE_HASH_FIELDS are skipped. Returns 0 at the end.
+int StateHashReader_Next(StateHashReader *reader, StateHashRecord *out);
+
+void StateHashReader_Close(StateHashReader *reader);
+
+#endif // STATE_HASH_H
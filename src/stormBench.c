@@ -0,0 +1,347 @@
+/*
+ * stormBench.c - Ball-storm stress benchmark (see stormBench.h)
+ */
+
+#include "stormBench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "constants.h"
+#include "physics.h"
+
+// Balls spawned per tick while ramping, so a stage change is not one huge spike
+#define STORM_SPAWNS_PER_TICK 8
+
+// Absolute slack on top of the relative tolerance; timer noise on sub-0.1 ms values
+#define STORM_SLACK_MS 0.05f
+
+#define STORM_LINE_LENGTH 256
+
+static const int stageBalls[STORM_BENCH_STAGES] = { 16, 64, 128, 256 };
+static const char *metricNames[STORM_METRIC_COUNT] = { "physics", "logic", "render" };
+
+struct StormBenchObject {
+    StormBenchConfig config;
+    char scenario[64];
+    long tick;              // game ticks since the start of the ramp
+    int spawned;
+    int capacity;           // samples per stage and metric
+    float *samples[STORM_BENCH_STAGES][STORM_METRIC_COUNT];
+    int counts[STORM_BENCH_STAGES][STORM_METRIC_COUNT];
+};
+
+StormBench *StormBench_Create(const StormBenchConfig *config) {
+    StormBench *bench = calloc(1, sizeof(StormBench));
+    if (bench == NULL) {
+        printf("StormBench_Create: out of memory\n");
+        return NULL;
+    }
+    bench->config = *config;
+    if (bench->config.settleTicks <= 0) {
+        bench->config.settleTicks = tickRate;
+    }
+    if (bench->config.measureTicks <= 0) {
+        bench->config.measureTicks = 10 * tickRate;
+    }
+    snprintf(bench->scenario, sizeof(bench->scenario), "%s/storm%s%s%s", config->runner,
+             config->megaMultiball ? "+mega" : "", config->water ? "+water" : "",
+             config->slowMotion ? "+slowmo" : "");
+
+    // Room for a display refreshing up to twice as often as the game ticks
+    bench->capacity = 2 * bench->config.measureTicks;
+    for (int s = 0; s < STORM_BENCH_STAGES; s++) {
+        for (int m = 0; m < STORM_METRIC_COUNT; m++) {
+            bench->samples[s][m] = malloc(bench->capacity * sizeof(float));
+            if (bench->samples[s][m] == NULL) {
+                printf("StormBench_Create: out of memory\n");
+                StormBench_Destroy(bench);
+                return NULL;
+            }
+        }
+    }
+    return bench;
+}
+
+void StormBench_Destroy(StormBench *bench) {
+    if (bench == NULL) {
+        return;
+    }
+    for (int s = 0; s < STORM_BENCH_STAGES; s++) {
+        for (int m = 0; m < STORM_METRIC_COUNT; m++) {
+            free(bench->samples[s][m]);
+        }
+    }
+    free(bench);
+}
+
+const char *StormBench_GetScenario(const StormBench *bench) {
+    return bench->scenario;
+}
+
+int StormBench_GetStageBalls(int stage) {
+    return stageBalls[stage];
+}
+
+static int storm_stage_of_tick(const StormBench *bench, long tick, int *measuring) {
+    long stageTicks = bench->config.settleTicks + bench->config.measureTicks;
+    *measuring = (tick % stageTicks) >= bench->config.settleTicks;
+    return (int)(tick / stageTicks);
+}
+
+int StormBench_GetStage(const StormBench *bench) {
+    int measuring;
+    int stage = storm_stage_of_tick(bench, bench->tick, &measuring);
+    return (stage < STORM_BENCH_STAGES && measuring) ? stage : -1;
+}
+
+int StormBench_BeginTick(StormBench *bench, GameStruct *game) {
+    int measuring;
+    int stage = storm_stage_of_tick(bench, bench->tick, &measuring);
+    if (stage >= STORM_BENCH_STAGES) {
+        return 0;
+    }
+
+    // Spawn grid across the upper playfield, as with mouse-spawned balls
+    int target = stageBalls[stage] < maxBalls ? stageBalls[stage] : maxBalls;
+    for (int i = 0; i < STORM_SPAWNS_PER_TICK && game->numBalls < target; i++) {
+        int n = bench->spawned++;
+        physics_add_ball(game, 10.0f + (n % 16) * 4.5f, 20.0f + ((n / 16) % 8) * 4.5f, 0, 0, 1);
+    }
+
+    // Same state the powerups set (game.c, physics.c), held for the whole ramp
+    if (bench->config.water) {
+        game->waterHeightTarget = 0.5f;
+        game->waterHeightTimer = 400.0f;
+        game->waterPowerupState = 1;
+    }
+    if (bench->config.slowMotion) {
+        game->slowMotion = 1;
+        game->slowMotionCounter = 1200;
+    }
+    return 1;
+}
+
+static void storm_add_sample(StormBench *bench, int stage, StormMetric metric, float ms) {
+    int *count = &bench->counts[stage][metric];
+    if (*count < bench->capacity) {
+        bench->samples[stage][metric][(*count)++] = ms;
+    }
+}
+
+void StormBench_EndTick(StormBench *bench, const PhysicsProfileSample *sample) {
+    int stage = StormBench_GetStage(bench);
+    if (stage >= 0) {
+        float logicMs = sample->tickMs - sample->stepMs;
+        storm_add_sample(bench, stage, STORM_METRIC_PHYSICS, sample->stepMs);
+        storm_add_sample(bench, stage, STORM_METRIC_LOGIC, logicMs > 0.0f ? logicMs : 0.0f);
+    }
+    bench->tick++;
+}
+
+void StormBench_AddFrame(StormBench *bench, int stage, float frameMs) {
+    if (stage >= 0 && stage < STORM_BENCH_STAGES) {
+        storm_add_sample(bench, stage, STORM_METRIC_RENDER, frameMs);
+    }
+}
+
+static int storm_compare_floats(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static float storm_percentile(const float *sorted, int count, float p) {
+    int rank = (int)ceilf(p * count);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+void StormBench_GetStats(const StormBench *bench, int stage, StormMetric metric, StormStats *out) {
+    memset(out, 0, sizeof(*out));
+    int count = bench->counts[stage][metric];
+    if (count == 0) {
+        return;
+    }
+    float *sorted = malloc(count * sizeof(float));
+    if (sorted == NULL) {
+        return;
+    }
+    memcpy(sorted, bench->samples[stage][metric], count * sizeof(float));
+    qsort(sorted, count, sizeof(float), storm_compare_floats);
+    out->count = count;
+    out->p50 = storm_percentile(sorted, count, 0.50f);
+    out->p99 = storm_percentile(sorted, count, 0.99f);
+    out->max = sorted[count - 1];
+    free(sorted);
+}
+
+void StormBench_Report(const StormBench *bench) {
+    printf("%s, %d ticks per stage after %d settling\n",
+           bench->scenario, bench->config.measureTicks, bench->config.settleTicks);
+    printf("%6s  %-8s  %8s  %9s  %9s  %9s\n", "balls", "metric", "samples", "p50 ms", "p99 ms", "max ms");
+    for (int s = 0; s < STORM_BENCH_STAGES; s++) {
+        for (int m = 0; m < STORM_METRIC_COUNT; m++) {
+            StormStats stats;
+            StormBench_GetStats(bench, s, m, &stats);
+            if (stats.count == 0) {
+                continue;
+            }
+            printf("%6d  %-8s  %8d  %9.3f  %9.3f  %9.3f\n",
+                   stageBalls[s], metricNames[m], stats.count, stats.p50, stats.p99, stats.max);
+        }
+    }
+}
+
+// Parses "scenario balls metric p50 p99 max"; returns 0 for comments and malformed lines
+static int storm_parse_row(const char *line, char *scenario, int *stage, int *metric, float values[3]) {
+    char metricName[32];
+    int balls;
+    if (line[0] == '#' ||
+        sscanf(line, "%63s %d %31s %f %f %f", scenario, &balls, metricName,
+               &values[0], &values[1], &values[2]) != 6) {
+        return 0;
+    }
+    *stage = -1;
+    *metric = -1;
+    for (int s = 0; s < STORM_BENCH_STAGES; s++) {
+        if (stageBalls[s] == balls) {
+            *stage = s;
+        }
+    }
+    for (int m = 0; m < STORM_METRIC_COUNT; m++) {
+        if (strcmp(metricName, metricNames[m]) == 0) {
+            *metric = m;
+        }
+    }
+    return *stage >= 0 && *metric >= 0;
+}
+
+int StormBench_CheckBaseline(const StormBench *bench, const char *path, float tolerance) {
+    static const char *percentileNames[3] = { "p50", "p99", "max" };
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    int rows = 0;
+    int regressions = 0;
+    char line[STORM_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char scenario[64];
+        int stage, metric;
+        float baseline[3];
+        if (!storm_parse_row(line, scenario, &stage, &metric, baseline) ||
+            strcmp(scenario, bench->scenario) != 0) {
+            continue;
+        }
+        StormStats stats;
+        StormBench_GetStats(bench, stage, metric, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+        rows++;
+        float current[3] = { stats.p50, stats.p99, stats.max };
+        for (int i = 0; i < 3; i++) {
+            // A single worst tick is noisier than a percentile: twice the tolerance
+            float allowed = i == 2 ? 2.0f * tolerance : tolerance;
+            float limit = baseline[i] * (1.0f + allowed) + STORM_SLACK_MS;
+            if (current[i] > limit) {
+                printf("REGRESSION %s %d balls %s %s: %.3f ms > %.3f ms (baseline %.3f ms)\n",
+                       bench->scenario, stageBalls[stage], metricNames[metric], percentileNames[i],
+                       current[i], limit, baseline[i]);
+                regressions++;
+            }
+        }
+    }
+    fclose(file);
+    return rows > 0 ? regressions : -1;
+}
+
+int StormBench_WriteBaseline(const StormBench *bench, const char *path) {
+    // Keep the other scenarios' rows (and the comments)
+    char **kept = NULL;
+    int numKept = 0;
+    FILE *file = fopen(path, "r");
+    if (file != NULL) {
+        char line[STORM_LINE_LENGTH];
+        while (fgets(line, sizeof(line), file) != NULL) {
+            char scenario[64];
+            if (sscanf(line, "%63s", scenario) == 1 && strcmp(scenario, bench->scenario) == 0) {
+                continue;
+            }
+            char **grown = realloc(kept, (numKept + 1) * sizeof(char *));
+            if (grown == NULL) {
+                break;
+            }
+            kept = grown;
+            kept[numKept] = malloc(strlen(line) + 1);
+            if (kept[numKept] == NULL) {
+                break;
+            }
+            strcpy(kept[numKept++], line);
+        }
+        fclose(file);
+    }
+
+    file = fopen(path, "w");
+    if (file == NULL) {
+        printf("StormBench_WriteBaseline: cannot open %s\n", path);
+        for (int i = 0; i < numKept; i++) {
+            free(kept[i]);
+        }
+        free(kept);
+        return -1;
+    }
+    if (numKept == 0) {
+        fprintf(file, "# scenario balls metric p50_ms p99_ms max_ms\n");
+    }
+    for (int i = 0; i < numKept; i++) {
+        fputs(kept[i], file);
+        free(kept[i]);
+    }
+    free(kept);
+    for (int s = 0; s < STORM_BENCH_STAGES; s++) {
+        for (int m = 0; m < STORM_METRIC_COUNT; m++) {
+            StormStats stats;
+            StormBench_GetStats(bench, s, m, &stats);
+            if (stats.count > 0) {
+                fprintf(file, "%s %d %s %.4f %.4f %.4f\n", bench->scenario, stageBalls[s],
+                        metricNames[m], stats.p50, stats.p99, stats.max);
+            }
+        }
+    }
+
+    if (fclose(file) != 0) {
+        printf("StormBench_WriteBaseline: write to %s failed\n", path);
+        return -1;
+    }
+    printf("Wrote %s baseline to %s\n", bench->scenario, path);
+    return 0;
+}
+
+int StormBench_Finish(const StormBench *bench, const char *baselinePath, int writeBaseline, float tolerance) {
+    StormBench_Report(bench);
+    if (baselinePath == NULL) {
+        return 0;
+    }
+    int regressions = -1;
+    if (!writeBaseline) {
+        regressions = StormBench_CheckBaseline(bench, baselinePath, tolerance);
+        if (regressions < 0) {
+            printf("no %s rows in %s yet, recording this run\n", bench->scenario, baselinePath);
+        }
+    }
+    if (regressions < 0) {
+        return StormBench_WriteBaseline(bench, baselinePath) == 0 ? 0 : 1;
+    }
+    if (regressions > 0) {
+        printf("%d regression(s) against %s\n", regressions, baselinePath);
+        return 2;
+    }
+    printf("within %.0f%% of %s\n", tolerance * 100.0f, baselinePath);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#ifndef STORM_BENCH_H
+#define STORM_BENCH_H
+
+#include "gameStruct.h"
+#include "physicsProfile.h"
+
+/*
+ * stormBench.h - Ball-storm stress benchmark
+ *
+ * Scripted version of clicking balls onto the table: the ramp holds 16, 64,
+ * 128 and then 256 balls in play (topping up drained ones), optionally with
+ * the water powerup held up and slow motion held on. Each stage settles for
+ * settleTicks and is then measured for measureTicks. Per stage it records
+ * p50 / p99 / max milliseconds for
+ *   physics - b2World_Step (PhysicsProfileSample.stepMs)
+ *   logic   - the rest of the game tick (tickMs - stepMs)
+ *   render  - render thread work per frame, up to EndDrawing (game only)
+ *
+ * The runner (pinball_sim --storm, or pinball --storm with rendering) starts
+ * a game, then each tick calls StormBench_BeginTick before the game tick and
+ * StormBench_EndTick with the tick's profile sample. BeginTick, EndTick and
+ * GetStage belong to the thread that steps the game; AddFrame to the render
+ * thread. Results are compared against a baseline file, one row per
+ * scenario / stage / metric:
+ *
+ *   # scenario balls metric p50_ms p99_ms max_ms
+ *   sim/storm+water 64 physics 0.4120 0.8010 1.2330
+ */
+
+#define STORM_BENCH_STAGES 4
+
+typedef enum {
+    STORM_METRIC_PHYSICS = 0,
+    STORM_METRIC_LOGIC,
+    STORM_METRIC_RENDER,
+    STORM_METRIC_COUNT
+} StormMetric;
+
+typedef struct {
+    const char *runner;     // "sim" or "game"; scenarios from different runners never compare
+    int water;              // hold the water powerup up
+    int slowMotion;         // hold slow motion on
+    int megaMultiball;      // the runner started the game in MODE_MEGA_MULTIBALL
+    int settleTicks;        // per stage, not measured (0 = 1 second)
+    int measureTicks;       // per stage (0 = 10 seconds)
+} StormBenchConfig;
+
+typedef struct {
+    int count;
+    float p50;
+    float p99;
+    float max;
+} StormStats;
+
+typedef struct StormBenchObject StormBench;
+
+// Returns NULL (after printing why) on failure
+StormBench *StormBench_Create(const StormBenchConfig *config);
+void StormBench_Destroy(StormBench *bench);
+
+// e.g. "sim/storm+mega+water+slowmo"
+const char *StormBench_GetScenario(const StormBench *bench);
+
+// Balls held in play by a stage
+int StormBench_GetStageBalls(int stage);
+
+// Before a game tick (gameplay must already be running): tops the balls up to
+// the stage's count and holds the powerups. Returns 0 once the ramp is over.
+int StormBench_BeginTick(StormBench *bench, GameStruct *game);
+
+// After the game tick, with its profile sample
+void StormBench_EndTick(StormBench *bench, const PhysicsProfileSample *sample);
+
+// Stage being measured, or -1 while settling and after the ramp
+int StormBench_GetStage(const StormBench *bench);
+
+// A rendered frame of a snapshot taken during `stage` (ignored if stage < 0)
+void StormBench_AddFrame(StormBench *bench, int stage, float frameMs);
+
+void StormBench_GetStats(const StormBench *bench, int stage, StormMetric metric, StormStats *out);
+
+// Print the p50 / p99 / max table
+void StormBench_Report(const StormBench *bench);
+
+// Compare against the scenario's rows in a baseline file. A value regresses
+// when it exceeds the baseline by more than `tolerance` (0.2 = 20%; twice that
+// for max) plus a small absolute slack. Returns the number of regressions (each printed), or
+// -1 if the file has no rows for this scenario or cannot be read.
+int StormBench_CheckBaseline(const StormBench *bench, const char *path, float tolerance);
+
+// Replace the scenario's rows in the baseline file, keeping other scenarios.
+// Returns 0 on success, -1 (after printing why) on failure.
+int StormBench_WriteBaseline(const StormBench *bench, const char *path);
+
+// Report, then check against (or, when the file has no rows for the scenario
+// or writeBaseline is set, record) the baseline. Returns the exit code for the
+// runner: 0, 1 on error or 2 on a regression. baselinePath NULL = report only.
+int StormBench_Finish(const StormBench *bench, const char *baselinePath, int writeBaseline, float tolerance);
+
+#endif // STORM_BENCH_H
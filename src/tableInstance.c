@@ -0,0 +1,136 @@
+/*
+ * tableInstance.c - One self-contained table for headless simulation (see tableInstance.h)
+ *
+ * The per-tick sequence is the sim thread's: Game_Update, then the playfield
+ * (Game_BeginPlayfield, one Game_StepPlayfieldPhysics per physics step,
+ * Game_EndPlayfield), then the water.
+ */
+
+#include "tableInstance.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+#include "game.h"
+#include "util.h"
+
+TableInstance *TableInstance_Create(const TableInstanceConfig *config) {
+    TableInstance *instance = calloc(1, sizeof(TableInstance));
+    if (instance == NULL) {
+        printf("TableInstance_Create: out of memory\n");
+        return NULL;
+    }
+    instance->config = *config;
+
+    GameStruct *game = &instance->game;
+    game->physicsWorkers = config->physicsWorkers;
+    game->tablePath = config->tablePath;
+
+    instance->sound = initSound();
+    game->sound = instance->sound;
+
+    Water_Init(&instance->water);
+    game->water = &instance->water;
+
+    if (physics_init(game, &instance->bumpers, &instance->leftFlipperBody, &instance->rightFlipperBody) != 0) {
+        shutdownSound(instance->sound);
+        free(instance);
+        return NULL;
+    }
+
+    GameStruct_AllocBalls(game);
+    physics_set_quality(game, config->quality);
+    physics_set_profiler(game, config->profiler);
+    physics_set_state_hash(game, config->stateHash);
+
+    instance->input = inputInit();
+    instance->input->tick = config->inputPhase;
+    game->input = instance->input;
+
+    Game_Init(game, instance->bumpers);
+    game->pendingMode = config->mode;
+    physics_flippers_init(game, instance->leftFlipperBody, instance->rightFlipperBody);
+    Powerups_Init(game, &instance->powerups);
+    return instance;
+}
+
+// Spawn position for the Nth extra ball: a grid across the upper playfield
+static void table_spawn_ball(TableInstance *instance) {
+    int n = instance->spawned++;
+    physics_add_ball(&instance->game, 10.0f + (n % 16) * 4.5f, 20.0f + ((n / 16) % 8) * 4.5f, 0, 0, 1);
+}
+
+void TableInstance_StartGame(TableInstance *instance) {
+    GameStruct *game = &instance->game;
+    Game_StartGame(game, instance->bumpers);
+    game->transitionState = 0;
+    instance->gamesPlayed++;
+    for (int i = 0; i < instance->config.extraBalls; i++) {
+        table_spawn_ball(instance);
+    }
+    if (game->numBalls > instance->peakBalls) {
+        instance->peakBalls = game->numBalls;
+    }
+}
+
+void TableInstance_Step(TableInstance *instance, long ticks) {
+    GameStruct *game = &instance->game;
+    PhysicsProfiler *profiler = instance->config.profiler;
+    const float timeStep = 1.0f / tickRate;
+    const int stepsPerTick = instance->config.physicsRate > 0 ? instance->config.physicsRate / tickRate : 1;
+
+    for (long i = 0; i < ticks; i++) {
+        long long tickStart = nanos();
+        if (profiler != NULL) {
+            PhysicsProfiler_BeginTick(profiler);
+        }
+        while (game->numBalls < instance->config.holdBalls && game->numBalls < maxBalls) {
+            table_spawn_ball(instance);
+        }
+
+        inputUpdate(instance->input);
+        Game_Update(game, instance->bumpers, instance->input, NULL, instance->sound, timeStep);
+        float physicsDt = Game_BeginPlayfield(game, &instance->powerups, instance->input, instance->sound,
+                                              timeStep) / stepsPerTick;
+        if (physicsDt > 0.0f) {
+            for (int step = 0; step < stepsPerTick; step++) {
+                Game_StepPlayfieldPhysics(game, instance->leftFlipperBody, instance->rightFlipperBody,
+                                          instance->input, instance->sound, physicsDt);
+                instance->totalSubSteps += physics_get_last_substeps(game);
+            }
+            Game_EndPlayfield(game, instance->bumpers, &instance->powerups, instance->input, instance->sound);
+        }
+        Water_Step(&instance->water, instance->ticks * timeStep);
+        instance->ticks++;
+        if (profiler != NULL) {
+            PhysicsProfiler_EndTick(profiler, game->numBalls, (nanos() - tickStart) / 1e6f);
+        }
+
+        if (game->numBalls > instance->peakBalls) {
+            instance->peakBalls = game->numBalls;
+        }
+        if (game->gameScore > instance->bestScore) {
+            instance->bestScore = game->gameScore;
+        }
+
+        // Out of lives: start the next game instead of entering score entry.
+        if (game->gameState == 2 || game->transitionTarget == TRANSITION_GAME_OVER) {
+            Game_StartGame(game, instance->bumpers);
+            game->transitionState = 0;
+            game->transitionTarget = TRANSITION_TO_GAME;
+            instance->gamesPlayed++;
+        }
+    }
+}
+
+void TableInstance_Destroy(TableInstance *instance) {
+    if (instance == NULL) {
+        return;
+    }
+    physics_shutdown(&instance->game);
+    inputShutdown(instance->input);
+    shutdownSound(instance->sound);
+    GameStruct_FreeBalls(&instance->game);
+    free(instance->bumpers);
+    free(instance);
+}
@@ -0,0 +1,77 @@
+#ifndef TABLE_INSTANCE_H
+#define TABLE_INSTANCE_H
+
+#include "gameStruct.h"
+#include "inputManager.h"
+#include "soundManager.h"
+#include "physics.h"
+#include "powerups.h"
+#include "water.h"
+
+/*
+ * tableInstance.h - One self-contained table for headless simulation
+ *
+ * An instance owns a GameStruct with its Box2D world and physics state, the
+ * scripted input backend, silent sound, water and powerups. Instances share
+ * nothing, so independent tables can be stepped on separate threads, one
+ * instance per thread. Create and destroy every instance from the same thread
+ * (Box2D claims and frees world slots without a lock), and keep at most
+ * TABLE_INSTANCE_MAX alive at once.
+ * pinball_sim uses one instance for a normal run or a replay and many for
+ * --batch.
+ *
+ * Built with the headless backends (inputManagerSim.c, soundManagerNull.c),
+ * so it is part of pinball_sim rather than pinball_core.
+ */
+
+// Box2D's B2_MAX_WORLDS (128) is not in its public headers; stay below it
+#define TABLE_INSTANCE_MAX 127
+
+typedef struct {
+    const char *tablePath;      // NULL = built-in table
+    int physicsWorkers;         // Box2D threads for this instance (0 = one per CPU)
+    int physicsRate;            // physics steps per second, a multiple of tickRate (0 = tickRate)
+    PhysicsQuality quality;
+    GameMode mode;              // mode every game starts in
+    int extraBalls;             // balls spawned when the game starts, like mouse spawns
+    int holdBalls;              // keep at least this many balls on the table (0 = off)
+    int inputPhase;             // ticks to advance the scripted input pattern, so instances differ
+    PhysicsProfiler *profiler;  // NULL to skip profiling
+    StateHashWriter *stateHash; // NULL to skip state hashing
+} TableInstanceConfig;
+
+typedef struct {
+    GameStruct game;
+    SoundManager *sound;
+    WaterSystem water;
+    Bumper *bumpers;
+    b2BodyId *leftFlipperBody;
+    b2BodyId *rightFlipperBody;
+    InputManager *input;
+    PowerupSystem powerups;
+    TableInstanceConfig config;
+
+    // Totals since TableInstance_Create
+    long ticks;
+    long gamesPlayed;
+    long peakBalls;
+    long long totalSubSteps;
+    long bestScore;
+    int spawned;
+} TableInstance;
+
+// Build the world and game state (title scene, as at power-on).
+// Returns NULL (after printing why) on failure.
+TableInstance *TableInstance_Create(const TableInstanceConfig *config);
+
+// Skip the title and menu, start a game and spawn config.extraBalls
+void TableInstance_StartGame(TableInstance *instance);
+
+// Run `ticks` fixed game ticks with the scripted input, physicsRate / tickRate
+// physics steps each, as the game's sim thread does. A finished game starts
+// the next one instead of entering score entry.
+void TableInstance_Step(TableInstance *instance, long ticks);
+
+void TableInstance_Destroy(TableInstance *instance);
+
+#endif // TABLE_INSTANCE_H
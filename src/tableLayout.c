@@ -0,0 +1,493 @@
+/*
+ * tableLayout.c - Table geometry: built-in table and table file reader/writer
+ *
+ * See tableLayout.h for the file format. Files are read in one piece and parsed
+ * from memory; every read is bounds-checked so a truncated or corrupt file is
+ * rejected rather than half-loaded.
+ */
+
+#include "tableLayout.h"
+#include "constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char tableMagic[4] = { 'P', 'B', 'T', 'L' };
+
+// Record sizes written by this version (see tableLayout.h)
+#define MATERIAL_RECORD_SIZE 8
+#define SEGMENT_RECORD_SIZE  20
+#define ARC_RECORD_SIZE      28
+#define BUMPER_RECORD_SIZE   24
+#define FLIPPER_RECORD_SIZE  8
+
+/* -------------------------------------------------------------------------- */
+/*  Built-in table                                                            */
+/* -------------------------------------------------------------------------- */
+
+// Material indices used by the built-in table
+enum {
+    MATERIAL_WALL,
+    MATERIAL_SLING,
+    MATERIAL_GUARD,
+    MATERIAL_ONE_WAY,
+    MATERIAL_BUMPER,
+    MATERIAL_LANE_TARGET,
+    MATERIAL_COUNT
+};
+
+/*
+ * table_add_arc
+ *  - Arc in the old writeCircleWallSegment convention: degStart/degEnd before
+ *    the -90 degree offset, numSegments + 1 points spaced range / (numSegments + 1)
+ *    apart (so the arc stops one step short of degEnd).
+ */
+static void table_add_arc(TableLayout *layout, int numSegments, float degStart, float degEnd,
+                          float centerX, float centerY, float radius, TableArcSide side) {
+    TableArc *arc = &layout->arcs[layout->numArcs++];
+    float range = degEnd > degStart ? degEnd - degStart : degStart - degEnd;
+    arc->centerX = centerX;
+    arc->centerY = centerY;
+    arc->radius = radius;
+    arc->startDeg = degStart - 90.0f;
+    arc->stepDeg = range / (numSegments + 1);
+    arc->segments = (uint16_t)numSegments;
+    arc->material = MATERIAL_WALL;
+    arc->side = (uint16_t)side;
+}
+
+void TableLayout_BuildDefault(TableLayout *layout) {
+    memset(layout, 0, sizeof(*layout));
+
+    static const TableMaterial materials[MATERIAL_COUNT] = {
+        [MATERIAL_WALL]        = { 0.5f, 0.5f },
+        [MATERIAL_SLING]       = { 0.0f, 1.2f },
+        [MATERIAL_GUARD]       = { 0.0f, 0.9f },
+        [MATERIAL_ONE_WAY]     = { 0.0f, 0.5f },
+        [MATERIAL_BUMPER]      = { 0.6f, 1.8f },  // Box2D default friction, bumperBounciness
+        [MATERIAL_LANE_TARGET] = { 0.6f, 0.0f }
+    };
+    layout->materials = malloc(sizeof(materials));
+    memcpy(layout->materials, materials, sizeof(materials));
+    layout->numMaterials = MATERIAL_COUNT;
+
+    // Each entry is a segment: { x1, y1, x2, y2 } in world coordinates.
+    float walls[][4] = {
+        {0,0,worldWidth,0},
+        {0,0,0,worldHeight},
+        {worldWidth,0,worldWidth,worldHeight},
+        {worldWidth - 6,56,worldWidth - 6,worldHeight},
+        {worldWidth - 7,56,worldWidth - 7,worldHeight},
+        {worldWidth-6,56,worldWidth-7,56},
+        {0,128,19,142},
+        {worldWidth - 7,128,worldWidth - 26,142},
+        {0,2.1,worldWidth,2.1},
+        {40.4,1.6,41.2,4.0},
+        {41.2,4.0,65.2,1.6},
+        {69.2,16.4,60.4,43.2},
+        {60.4,43.2,68.8,55.6},
+        {74.8,63.6,83.2,76.0},
+        {84.0,56.7,84.0,37.2},
+        {70.8,18.4,68,26.8},
+        {74.8,37.6,68.8,55.6},
+        {82.0,39.2,74.8,63.6},
+        {67.400002,146.400009,83.200005,134.199997},
+        {16.400000,146.199997,0.600000,134.600006},
+        // Additional static segments
+        {7.800000,38.200001,7.8,49.200001},
+        {16.000000,38.400002,16.000000,53.799999},
+        {16.000000,53.799999,8.600000,68.800003}
+    };
+    const int numWalls = sizeof(walls) / sizeof(walls[0]);
+
+    // Walls, 2 slingshots, 2 slingshot guards, one-way door
+    layout->segments = malloc((numWalls + 5) * sizeof(TableSegment));
+    for (int i = 0; i < numWalls; i++) {
+        layout->segments[layout->numSegments++] = (TableSegment){
+            walls[i][0], walls[i][1], walls[i][2], walls[i][3], TABLE_SEGMENT_WALL, MATERIAL_WALL
+        };
+    }
+    TableSegment *s = &layout->segments[layout->numSegments];
+    s[0] = (TableSegment){ 14.800000, 125.200005, 7.600000, 109.200005, TABLE_SEGMENT_LEFT_SLING, MATERIAL_SLING };
+    s[1] = (TableSegment){ 75.599998, 108.800003, 69.200005, 125.200005, TABLE_SEGMENT_RIGHT_SLING, MATERIAL_SLING };
+    s[2] = (TableSegment){ 7.200000, 111.200005, 12.800000, 124.400002, TABLE_SEGMENT_WALL, MATERIAL_GUARD };
+    s[3] = (TableSegment){ 71.200005, 124.800003, 76.000000, 110.800003, TABLE_SEGMENT_WALL, MATERIAL_GUARD };
+    s[4] = (TableSegment){ 69.6, 16.6, 73.4, 4.6, TABLE_SEGMENT_ONE_WAY, MATERIAL_ONE_WAY };
+    layout->numSegments += 5;
+
+    // Top corners (ball inside), then the upper-right lane rails around (64.75, 35.6):
+    // the lane runs between the 10.15 and 17.5 rails, the 19.5 rail faces the shooter lane.
+    layout->arcs = malloc(5 * sizeof(TableArc));
+    table_add_arc(layout, 20, 0, 90, worldWidth-28.5, 30.75, 28.75, TABLE_ARC_SOLID_INSIDE);
+    table_add_arc(layout, 20, 270, 360, 28.5, 30.75, 28.75, TABLE_ARC_SOLID_INSIDE);
+    table_add_arc(layout, 10, 20, 110, 64.75, 35.6, 10.15, TABLE_ARC_SOLID_OUTSIDE);
+    table_add_arc(layout, 10, 20, 110, 64.75, 35.6, 17.50, TABLE_ARC_SOLID_INSIDE);
+    table_add_arc(layout, 10, 13, 110, 64.75, 35.6, 19.50, TABLE_ARC_SOLID_OUTSIDE);
+
+    // Bumpers in game index order: standard (0-2), slow motion (3),
+    // lane targets (4-9), water powerup (10-13).
+    static const TableBumper bumpers[] = {
+        { 24.9, 19.9, 5.0f, 0, BUMPER_TYPE_STANDARD, MATERIAL_BUMPER, TABLE_BUMPER_ENABLED },
+        { 46.6, 17.8, 5.0f, 0, BUMPER_TYPE_STANDARD, MATERIAL_BUMPER, TABLE_BUMPER_ENABLED },
+        { 38.0, 36.4, 5.0f, 0, BUMPER_TYPE_STANDARD, MATERIAL_BUMPER, TABLE_BUMPER_ENABLED },
+        { 72.200005, 23.400000, 2.0f, 0, BUMPER_TYPE_SLOW_MOTION, MATERIAL_BUMPER,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 63.34, 50.88, 2.0f, 90.0 + 145.2, BUMPER_TYPE_LANE_TARGET_A, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 77.38, 70.96, 2.0f, 90.0 + 145.2, BUMPER_TYPE_LANE_TARGET_A, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 15.1, 62.04, 2.0f, 90.0 + 25.7, BUMPER_TYPE_LANE_TARGET_A, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 18.9, 45.3, 2.0f, 90.0, BUMPER_TYPE_LANE_TARGET_B, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 61.02, 35.36, 2.0f, 90.0 - 162.0, BUMPER_TYPE_LANE_TARGET_B, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 65.02, 23.02, 2.0f, 90.0 - 162.0, BUMPER_TYPE_LANE_TARGET_B, MATERIAL_LANE_TARGET,
+          TABLE_BUMPER_SENSOR | TABLE_BUMPER_ENABLED },
+        { 12.2, 81.8, 2.0f, 0, BUMPER_TYPE_WATER_POWERUP, MATERIAL_BUMPER, 0 },
+        { 23.8, 91.2, 2.0f, 0, BUMPER_TYPE_WATER_POWERUP, MATERIAL_BUMPER, 0 },
+        { 61.2, 91.2, 2.0f, 0, BUMPER_TYPE_WATER_POWERUP, MATERIAL_BUMPER, 0 },
+        { 72.599998, 81.8, 2.0f, 0, BUMPER_TYPE_WATER_POWERUP, MATERIAL_BUMPER, 0 }
+    };
+    layout->bumpers = malloc(sizeof(bumpers));
+    memcpy(layout->bumpers, bumpers, sizeof(bumpers));
+    layout->numBumpers = sizeof(bumpers) / sizeof(bumpers[0]);
+
+    // Flipper bodies rotate about the center of the flipper's square end
+    layout->leftFlipper = (TableFlipperPivot){ 17.2 + flipperHeight / 2.0f, 142.8 + flipperHeight / 2.0f };
+    layout->rightFlipper = (TableFlipperPivot){ 61.4 + flipperHeight / 2.0f, 142.8 + flipperHeight / 2.0f };
+}
+
+void TableLayout_Free(TableLayout *layout) {
+    free(layout->materials);
+    free(layout->segments);
+    free(layout->arcs);
+    free(layout->bumpers);
+    memset(layout, 0, sizeof(*layout));
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Reading                                                                   */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    int error;   // set once any read runs past the end
+} TableReader;
+
+static const uint8_t *reader_take(TableReader *r, size_t n) {
+    if (r->error || r->size - r->pos < n) {
+        r->error = 1;
+        return NULL;
+    }
+    const uint8_t *p = r->data + r->pos;
+    r->pos += n;
+    return p;
+}
+
+static uint16_t read_u16(TableReader *r) {
+    const uint8_t *p = reader_take(r, 2);
+    return p ? (uint16_t)(p[0] | (p[1] << 8)) : 0;
+}
+
+static uint32_t read_u32(TableReader *r) {
+    const uint8_t *p = reader_take(r, 4);
+    return p ? (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24) : 0;
+}
+
+static float read_f32(TableReader *r) {
+    uint32_t bits = read_u32(r);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*
+ * table_parse
+ *  - Parses a table image into layout. Returns NULL on success or a short
+ *    description of the first problem found.
+ */
+static const char *table_parse(TableLayout *layout, const uint8_t *data, size_t size) {
+    TableReader r = { data, size, 0, 0 };
+
+    const uint8_t *magic = reader_take(&r, 4);
+    if (magic == NULL || memcmp(magic, tableMagic, 4) != 0) {
+        return "not a table file";
+    }
+    uint16_t version = read_u16(&r);
+    if (version == 0 || version > TABLE_LAYOUT_VERSION) {
+        return "unsupported version";
+    }
+    int sectionCount = read_u16(&r);
+    int numFlippers = 0;
+
+    for (int section = 0; section < sectionCount; section++) {
+        uint16_t id = read_u16(&r);
+        uint16_t recordSize = read_u16(&r);
+        uint32_t count = read_u32(&r);
+        if (r.error) {
+            return "truncated section header";
+        }
+        if (recordSize != 0 && count > (r.size - r.pos) / recordSize) {
+            return "truncated section";
+        }
+        size_t sectionEnd = r.pos + (size_t)recordSize * count;
+
+        size_t minSize = 0;
+        switch (id) {
+            case TABLE_SECTION_MATERIALS: minSize = MATERIAL_RECORD_SIZE; break;
+            case TABLE_SECTION_SEGMENTS:  minSize = SEGMENT_RECORD_SIZE; break;
+            case TABLE_SECTION_ARCS:      minSize = ARC_RECORD_SIZE; break;
+            case TABLE_SECTION_BUMPERS:   minSize = BUMPER_RECORD_SIZE; break;
+            case TABLE_SECTION_FLIPPERS:  minSize = FLIPPER_RECORD_SIZE; break;
+            default:
+                r.pos = sectionEnd;  // unknown section, skip it
+                continue;
+        }
+        if (recordSize < minSize) {
+            return "record size too small";
+        }
+
+        int duplicate = 0;
+        switch (id) {
+            case TABLE_SECTION_MATERIALS: duplicate = layout->materials != NULL; break;
+            case TABLE_SECTION_SEGMENTS:  duplicate = layout->segments != NULL; break;
+            case TABLE_SECTION_ARCS:      duplicate = layout->arcs != NULL; break;
+            case TABLE_SECTION_BUMPERS:   duplicate = layout->bumpers != NULL; break;
+            default:                      duplicate = numFlippers > 0; break;
+        }
+        if (duplicate) {
+            return "duplicate section";
+        }
+
+        // count + 1 so an empty section still marks itself as seen
+        switch (id) {
+            case TABLE_SECTION_MATERIALS: layout->materials = calloc(count + 1, sizeof(TableMaterial)); break;
+            case TABLE_SECTION_SEGMENTS:  layout->segments = calloc(count + 1, sizeof(TableSegment)); break;
+            case TABLE_SECTION_ARCS:      layout->arcs = calloc(count + 1, sizeof(TableArc)); break;
+            case TABLE_SECTION_BUMPERS:   layout->bumpers = calloc(count + 1, sizeof(TableBumper)); break;
+        }
+        if ((id == TABLE_SECTION_MATERIALS && layout->materials == NULL) ||
+            (id == TABLE_SECTION_SEGMENTS && layout->segments == NULL) ||
+            (id == TABLE_SECTION_ARCS && layout->arcs == NULL) ||
+            (id == TABLE_SECTION_BUMPERS && layout->bumpers == NULL)) {
+            return "out of memory";
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            size_t recordStart = r.pos;
+            switch (id) {
+                case TABLE_SECTION_MATERIALS: {
+                    TableMaterial *m = &layout->materials[layout->numMaterials++];
+                    m->friction = read_f32(&r);
+                    m->restitution = read_f32(&r);
+                    break;
+                }
+                case TABLE_SECTION_SEGMENTS: {
+                    TableSegment *s = &layout->segments[layout->numSegments++];
+                    s->x1 = read_f32(&r);
+                    s->y1 = read_f32(&r);
+                    s->x2 = read_f32(&r);
+                    s->y2 = read_f32(&r);
+                    s->kind = read_u16(&r);
+                    s->material = read_u16(&r);
+                    break;
+                }
+                case TABLE_SECTION_ARCS: {
+                    TableArc *a = &layout->arcs[layout->numArcs++];
+                    a->centerX = read_f32(&r);
+                    a->centerY = read_f32(&r);
+                    a->radius = read_f32(&r);
+                    a->startDeg = read_f32(&r);
+                    a->stepDeg = read_f32(&r);
+                    a->segments = read_u16(&r);
+                    a->material = read_u16(&r);
+                    a->side = read_u16(&r);
+                    break;
+                }
+                case TABLE_SECTION_BUMPERS: {
+                    TableBumper *b = &layout->bumpers[layout->numBumpers++];
+                    b->x = read_f32(&r);
+                    b->y = read_f32(&r);
+                    b->radius = read_f32(&r);
+                    b->angle = read_f32(&r);
+                    b->type = read_u16(&r);
+                    b->material = read_u16(&r);
+                    b->flags = read_u16(&r);
+                    break;
+                }
+                case TABLE_SECTION_FLIPPERS: {
+                    TableFlipperPivot pivot;
+                    pivot.x = read_f32(&r);
+                    pivot.y = read_f32(&r);
+                    if (numFlippers == 0) {
+                        layout->leftFlipper = pivot;
+                    } else if (numFlippers == 1) {
+                        layout->rightFlipper = pivot;
+                    }
+                    numFlippers++;
+                    break;
+                }
+            }
+            // Skip fields appended by newer versions
+            r.pos = recordStart + recordSize;
+        }
+        if (r.error) {
+            return "truncated record";
+        }
+    }
+
+    if (layout->numMaterials == 0) {
+        return "no materials";
+    }
+    if (numFlippers < 2) {
+        return "missing flipper pivots";
+    }
+    for (int i = 0; i < layout->numSegments; i++) {
+        if (layout->segments[i].kind > TABLE_SEGMENT_ONE_WAY ||
+            layout->segments[i].material >= layout->numMaterials) {
+            return "bad segment";
+        }
+    }
+    for (int i = 0; i < layout->numArcs; i++) {
+        if (layout->arcs[i].segments > TABLE_ARC_MAX_SEGMENTS ||
+            layout->arcs[i].side > TABLE_ARC_SOLID_BOTH ||
+            layout->arcs[i].material >= layout->numMaterials) {
+            return "bad arc";
+        }
+    }
+    for (int i = 0; i < layout->numBumpers; i++) {
+        if (layout->bumpers[i].type > BUMPER_TYPE_WATER_POWERUP ||
+            layout->bumpers[i].material >= layout->numMaterials) {
+            return "bad bumper";
+        }
+    }
+    return NULL;
+}
+
+int TableLayout_Load(TableLayout *layout, const char *path) {
+    memset(layout, 0, sizeof(*layout));
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("TableLayout_Load: cannot open %s\n", path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *data = size > 0 ? malloc(size) : NULL;
+    if (data == NULL || fread(data, 1, size, file) != (size_t)size) {
+        printf("TableLayout_Load: cannot read %s\n", path);
+        free(data);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+
+    const char *error = table_parse(layout, data, (size_t)size);
+    free(data);
+    if (error != NULL) {
+        printf("TableLayout_Load: %s: %s\n", path, error);
+        TableLayout_Free(layout);
+        return -1;
+    }
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*  Writing                                                                   */
+/* -------------------------------------------------------------------------- */
+
+static void write_u16(FILE *file, uint16_t value) {
+    uint8_t b[2] = { value & 0xff, value >> 8 };
+    fwrite(b, 1, sizeof(b), file);
+}
+
+static void write_u32(FILE *file, uint32_t value) {
+    uint8_t b[4] = { value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, value >> 24 };
+    fwrite(b, 1, sizeof(b), file);
+}
+
+static void write_f32(FILE *file, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_u32(file, bits);
+}
+
+static void write_section_header(FILE *file, TableSectionId id, int recordSize, int count) {
+    write_u16(file, (uint16_t)id);
+    write_u16(file, (uint16_t)recordSize);
+    write_u32(file, (uint32_t)count);
+}
+
+int TableLayout_Save(const TableLayout *layout, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("TableLayout_Save: cannot open %s\n", path);
+        return -1;
+    }
+
+    fwrite(tableMagic, 1, sizeof(tableMagic), file);
+    write_u16(file, TABLE_LAYOUT_VERSION);
+    write_u16(file, 5);
+
+    write_section_header(file, TABLE_SECTION_MATERIALS, MATERIAL_RECORD_SIZE, layout->numMaterials);
+    for (int i = 0; i < layout->numMaterials; i++) {
+        write_f32(file, layout->materials[i].friction);
+        write_f32(file, layout->materials[i].restitution);
+    }
+
+    write_section_header(file, TABLE_SECTION_SEGMENTS, SEGMENT_RECORD_SIZE, layout->numSegments);
+    for (int i = 0; i < layout->numSegments; i++) {
+        const TableSegment *s = &layout->segments[i];
+        write_f32(file, s->x1);
+        write_f32(file, s->y1);
+        write_f32(file, s->x2);
+        write_f32(file, s->y2);
+        write_u16(file, s->kind);
+        write_u16(file, s->material);
+    }
+
+    write_section_header(file, TABLE_SECTION_ARCS, ARC_RECORD_SIZE, layout->numArcs);
+    for (int i = 0; i < layout->numArcs; i++) {
+        const TableArc *a = &layout->arcs[i];
+        write_f32(file, a->centerX);
+        write_f32(file, a->centerY);
+        write_f32(file, a->radius);
+        write_f32(file, a->startDeg);
+        write_f32(file, a->stepDeg);
+        write_u16(file, a->segments);
+        write_u16(file, a->material);
+        write_u16(file, a->side);
+        write_u16(file, 0);
+    }
+
+    write_section_header(file, TABLE_SECTION_BUMPERS, BUMPER_RECORD_SIZE, layout->numBumpers);
+    for (int i = 0; i < layout->numBumpers; i++) {
+        const TableBumper *b = &layout->bumpers[i];
+        write_f32(file, b->x);
+        write_f32(file, b->y);
+        write_f32(file, b->radius);
+        write_f32(file, b->angle);
+        write_u16(file, b->type);
+        write_u16(file, b->material);
+        write_u16(file, b->flags);
+        write_u16(file, 0);
+    }
+
+    write_section_header(file, TABLE_SECTION_FLIPPERS, FLIPPER_RECORD_SIZE, 2);
+    write_f32(file, layout->leftFlipper.x);
+    write_f32(file, layout->leftFlipper.y);
+    write_f32(file, layout->rightFlipper.x);
+    write_f32(file, layout->rightFlipper.y);
+
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        printf("TableLayout_Save: write to %s failed\n", path);
+        return -1;
+    }
+    return 0;
+}
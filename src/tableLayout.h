@@ -0,0 +1,133 @@
+#ifndef TABLE_LAYOUT_H
+#define TABLE_LAYOUT_H
+
+#include <stdint.h>
+
+/*
+ * tableLayout.h - Table geometry (walls, arcs, bumpers, flipper pivots, materials)
+ *
+ * physics_init builds the Box2D world from a TableLayout, which is either read
+ * from a table file (TableLayout_Load) or filled with the built-in table
+ * (TableLayout_BuildDefault). No Box2D or raylib dependency.
+ *
+ * Table file format (all values little-endian, floats are IEEE-754 binary32):
+ *
+ *   header   : char magic[4] = "PBTL", u16 version, u16 sectionCount
+ *   section  : u16 id, u16 recordSize, u32 recordCount, then recordCount records
+ *
+ *   TABLE_SECTION_MATERIALS (8 bytes)  : f32 friction, f32 restitution
+ *   TABLE_SECTION_SEGMENTS  (20 bytes) : f32 x1, y1, x2, y2, u16 kind, u16 material
+ *   TABLE_SECTION_ARCS      (28 bytes) : f32 centerX, centerY, radius, startDeg, stepDeg,
+ *                                        u16 segments, u16 material, u16 side, u16 reserved
+ *   TABLE_SECTION_BUMPERS   (24 bytes) : f32 x, y, radius, angle,
+ *                                        u16 type, u16 material, u16 flags, u16 reserved
+ *   TABLE_SECTION_FLIPPERS  (8 bytes)  : f32 pivotX, pivotY (left flipper, then right)
+ *
+ * Unknown sections are skipped, and records longer than this version's layout
+ * are read up to the known fields, so newer tools can append data.
+ */
+
+#define TABLE_LAYOUT_VERSION 1
+
+// Upper bound on arc subdivision, keeps chain point buffers on the stack
+#define TABLE_ARC_MAX_SEGMENTS 64
+
+typedef enum {
+    TABLE_SECTION_MATERIALS = 1,
+    TABLE_SECTION_SEGMENTS  = 2,
+    TABLE_SECTION_ARCS      = 3,
+    TABLE_SECTION_BUMPERS   = 4,
+    TABLE_SECTION_FLIPPERS  = 5
+} TableSectionId;
+
+/*
+ * BumperType:
+ *  - Encodes gameplay semantics for bumpers so we avoid magic numbers.
+ *  - Stored in table files; values must stay in sync with any rendering/UI code
+ *    that branches on bumper->type.
+ */
+typedef enum {
+    BUMPER_TYPE_STANDARD      = 0,  // Upper playfield round bumpers (score + powerup meter)
+    BUMPER_TYPE_SLOW_MOTION   = 1,  // Special bumper that triggers slow motion + big score
+    BUMPER_TYPE_LANE_TARGET_A = 2,  // Lane/target bumpers, group A
+    BUMPER_TYPE_LANE_TARGET_B = 3,  // Lane/target bumpers, group B
+    BUMPER_TYPE_WATER_POWERUP = 4   // Small bumpers that enable water powerup
+} BumperType;
+
+// What a static segment does when the ball hits it
+typedef enum {
+    TABLE_SEGMENT_WALL       = 0,
+    TABLE_SEGMENT_LEFT_SLING = 1,
+    TABLE_SEGMENT_RIGHT_SLING = 2,
+    TABLE_SEGMENT_ONE_WAY    = 3
+} TableSegmentKind;
+
+// Which side of an arc the ball collides with (arcs are one-sided chains)
+typedef enum {
+    TABLE_ARC_SOLID_INSIDE  = 0,  // ball rolls along the inside (toward the center)
+    TABLE_ARC_SOLID_OUTSIDE = 1,  // ball rolls along the outside
+    TABLE_ARC_SOLID_BOTH    = 2   // two-sided, costs twice the broadphase proxies
+} TableArcSide;
+
+// TableBumper.flags
+#define TABLE_BUMPER_SENSOR  0x0001  // reports hits but never bounces the ball
+#define TABLE_BUMPER_ENABLED 0x0002  // initial Bumper.enabled
+
+typedef struct {
+    float friction;
+    float restitution;
+} TableMaterial;
+
+typedef struct {
+    float x1, y1, x2, y2;
+    uint16_t kind;      // TableSegmentKind
+    uint16_t material;
+} TableSegment;
+
+// Points at startDeg + i * stepDeg for i = 0..segments (0 degrees = +x, y down)
+typedef struct {
+    float centerX, centerY, radius;
+    float startDeg, stepDeg;
+    uint16_t segments;
+    uint16_t material;
+    uint16_t side;      // TableArcSide
+} TableArc;
+
+typedef struct {
+    float x, y, radius;
+    float angle;        // lane target arrow direction in degrees, 0 otherwise
+    uint16_t type;      // BumperType
+    uint16_t material;
+    uint16_t flags;     // TABLE_BUMPER_*
+} TableBumper;
+
+typedef struct {
+    float x, y;         // flipper body position (the rotation point)
+} TableFlipperPivot;
+
+typedef struct {
+    TableMaterial *materials;
+    int numMaterials;
+    TableSegment *segments;
+    int numSegments;
+    TableArc *arcs;
+    int numArcs;
+    TableBumper *bumpers;  // order is the game's bumper index (see numBumpers)
+    int numBumpers;
+    TableFlipperPivot leftFlipper;
+    TableFlipperPivot rightFlipper;
+} TableLayout;
+
+// Fill layout with the built-in table. Free with TableLayout_Free.
+void TableLayout_BuildDefault(TableLayout *layout);
+
+// Read a table file. Returns 0 on success; on failure prints why, leaves
+// layout empty and returns -1.
+int TableLayout_Load(TableLayout *layout, const char *path);
+
+// Write layout as a table file. Returns 0 on success, -1 on failure.
+int TableLayout_Save(const TableLayout *layout, const char *path);
+
+void TableLayout_Free(TableLayout *layout);
+
+#endif // TABLE_LAYOUT_H
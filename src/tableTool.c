@@ -0,0 +1,72 @@
+/*
+ * tableTool.c - Table file utility (pinball_tabletool)
+ *
+ * Writes the built-in table to a table file, or prints what a table file
+ * contains. Resources/Tables/default.tbl is generated with:
+ *
+ *   pinball_tabletool --write resources/assets/Tables/default.tbl
+ *
+ * Usage: pinball_tabletool --write FILE | --dump FILE
+ *   --write FILE : save the built-in table (TableLayout_BuildDefault) to FILE
+ *   --dump FILE  : load FILE and list its materials, segments, arcs, bumpers and flippers
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "tableLayout.h"
+
+static void table_dump(const TableLayout *layout) {
+    static const char *segmentKinds[] = { "wall", "left-sling", "right-sling", "one-way" };
+    static const char *arcSides[] = { "inside", "outside", "both" };
+
+    printf("materials: %d\n", layout->numMaterials);
+    for (int i = 0; i < layout->numMaterials; i++) {
+        printf("  %2d friction %.2f restitution %.2f\n", i,
+               layout->materials[i].friction, layout->materials[i].restitution);
+    }
+    printf("segments: %d\n", layout->numSegments);
+    for (int i = 0; i < layout->numSegments; i++) {
+        const TableSegment *s = &layout->segments[i];
+        printf("  %2d (%.2f, %.2f) - (%.2f, %.2f) %s material %d\n", i,
+               s->x1, s->y1, s->x2, s->y2, segmentKinds[s->kind], s->material);
+    }
+    printf("arcs: %d\n", layout->numArcs);
+    for (int i = 0; i < layout->numArcs; i++) {
+        const TableArc *a = &layout->arcs[i];
+        printf("  %2d center (%.2f, %.2f) radius %.2f from %.2f deg, %d x %.3f deg, solid %s, material %d\n",
+               i, a->centerX, a->centerY, a->radius, a->startDeg, a->segments, a->stepDeg,
+               arcSides[a->side], a->material);
+    }
+    printf("bumpers: %d\n", layout->numBumpers);
+    for (int i = 0; i < layout->numBumpers; i++) {
+        const TableBumper *b = &layout->bumpers[i];
+        printf("  %2d (%.2f, %.2f) radius %.2f angle %.1f type %d material %d%s%s\n", i,
+               b->x, b->y, b->radius, b->angle, b->type, b->material,
+               (b->flags & TABLE_BUMPER_SENSOR) ? " sensor" : "",
+               (b->flags & TABLE_BUMPER_ENABLED) ? " enabled" : "");
+    }
+    printf("flippers: left (%.3f, %.3f) right (%.3f, %.3f)\n",
+           layout->leftFlipper.x, layout->leftFlipper.y,
+           layout->rightFlipper.x, layout->rightFlipper.y);
+}
+
+int main(int argc, char **argv){
+    if (argc == 3 && strcmp(argv[1], "--write") == 0){
+        TableLayout layout;
+        TableLayout_BuildDefault(&layout);
+        int result = TableLayout_Save(&layout, argv[2]);
+        TableLayout_Free(&layout);
+        return result == 0 ? 0 : 1;
+    }
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0){
+        TableLayout layout;
+        if (TableLayout_Load(&layout, argv[2]) != 0){
+            return 1;
+        }
+        table_dump(&layout);
+        TableLayout_Free(&layout);
+        return 0;
+    }
+    fprintf(stderr, "usage: %s --write FILE | --dump FILE\n", argv[0]);
+    return 1;
+}
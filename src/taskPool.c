@@ -0,0 +1,270 @@
+/*
+ * taskPool.c - Work-stealing thread pool (see taskPool.h)
+ *
+ * Each enqueued task splits its items into one contiguous slice per worker.
+ * A worker claims blocks of minRange items from its own slice with an atomic
+ * add on the slice cursor, then walks the other slices and steals from them
+ * the same way. Slices live on separate cache lines so workers that stay on
+ * their own slice never share a line.
+ *
+ * Tasks with unclaimed items sit in a small queue guarded by a mutex; idle
+ * threads sleep on a condition variable until a task is enqueued. The caller
+ * (worker 0) runs in TaskPool_FinishTask and then waits for the remaining
+ * in-flight blocks, so a task never depends on a pool thread waking up.
+ *
+ * Tasks live in a fixed slot array. If every slot is taken the task runs
+ * inline in TaskPool_EnqueueTask, which Box2D allows (NULL handle).
+ */
+
+#include "taskPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+// Box2D issues a few dozen tasks per step; all are finished before b2World_Step returns.
+#define TASK_POOL_MAX_TASKS 64
+#define TASK_POOL_CACHE_LINE 64
+
+typedef struct {
+    int next;   // first unclaimed item (atomic)
+    int end;    // one past the last item of this slice
+    char pad[TASK_POOL_CACHE_LINE - 2 * sizeof(int)];
+} TaskSlice;
+
+typedef struct {
+    TaskSlice slices[TASK_POOL_MAX_WORKERS];
+    TaskPoolFn *fn;
+    void *context;
+    int blockSize;
+    int sliceCount;
+    int pendingItems;   // items not yet completed (atomic)
+    int users;          // pool threads currently inside this task (atomic)
+    int inUse;          // slot allocated; only touched by the owning thread
+} PoolTask;
+
+typedef struct {
+    TaskPool *pool;
+    uint32_t index;
+    pthread_t thread;
+} PoolWorker;
+
+struct TaskPoolObject {
+    int workerCount;
+    PoolWorker workers[TASK_POOL_MAX_WORKERS];
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    int quit;
+    PoolTask *queue[TASK_POOL_MAX_TASKS];   // tasks that may still have unclaimed items
+    int queueCount;
+    PoolTask tasks[TASK_POOL_MAX_TASKS];
+};
+
+/*
+ * task_claim_slice
+ *  - Runs blocks from one slice until it is exhausted.
+ */
+static void task_claim_slice(PoolTask *task, TaskSlice *slice, uint32_t workerIndex) {
+    for (;;) {
+        int start = __atomic_fetch_add(&slice->next, task->blockSize, __ATOMIC_RELAXED);
+        if (start >= slice->end) {
+            return;
+        }
+        int end = start + task->blockSize;
+        if (end > slice->end) {
+            end = slice->end;
+        }
+        task->fn(start, end, workerIndex, task->context);
+        __atomic_fetch_sub(&task->pendingItems, end - start, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * task_run
+ *  - Own slice first, then steal from the others. Returns once no unclaimed
+ *    items remain (other workers may still be finishing claimed blocks).
+ */
+static void task_run(PoolTask *task, uint32_t workerIndex) {
+    int count = task->sliceCount;
+    int first = (int)(workerIndex % (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        task_claim_slice(task, &task->slices[(first + i) % count], workerIndex);
+    }
+}
+
+// Caller must hold pool->mutex
+static void queue_remove(TaskPool *pool, PoolTask *task) {
+    for (int i = 0; i < pool->queueCount; i++) {
+        if (pool->queue[i] == task) {
+            memmove(&pool->queue[i], &pool->queue[i + 1],
+                    (pool->queueCount - i - 1) * sizeof(PoolTask *));
+            pool->queueCount--;
+            return;
+        }
+    }
+}
+
+static void *task_pool_thread(void *arg) {
+    PoolWorker *worker = (PoolWorker *)arg;
+    TaskPool *pool = worker->pool;
+    uint32_t workerIndex = worker->index;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->quit) {
+        if (pool->queueCount == 0) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+            continue;
+        }
+
+        // Oldest task first: Box2D's solver relies on its first task being started
+        PoolTask *task = pool->queue[0];
+        __atomic_fetch_add(&task->users, 1, __ATOMIC_ACQUIRE);
+        pthread_mutex_unlock(&pool->mutex);
+
+        task_run(task, workerIndex);
+
+        pthread_mutex_lock(&pool->mutex);
+        queue_remove(pool, task);
+        __atomic_fetch_sub(&task->users, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+TaskPool *TaskPool_Create(int workerCount) {
+    if (workerCount <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = cpus > 0 ? (int)cpus : 1;
+    }
+    if (workerCount > TASK_POOL_MAX_WORKERS) {
+        workerCount = TASK_POOL_MAX_WORKERS;
+    }
+
+    TaskPool *pool = calloc(1, sizeof(TaskPool));
+    if (pool == NULL) {
+        fprintf(stderr, "TaskPool_Create: out of memory\n");
+        return NULL;
+    }
+    pool->workerCount = workerCount;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    for (int i = 1; i < workerCount; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = (uint32_t)i;
+        if (pthread_create(&pool->workers[i].thread, NULL, task_pool_thread, &pool->workers[i]) != 0) {
+            fprintf(stderr, "TaskPool_Create: failed to start worker %d, using %d workers\n", i, i);
+            pool->workerCount = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void TaskPool_Destroy(TaskPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->workerCount; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+int TaskPool_GetWorkerCount(const TaskPool *pool) {
+    return pool ? pool->workerCount : 1;
+}
+
+void *TaskPool_EnqueueTask(TaskPool *pool, TaskPoolFn *fn, int itemCount, int minRange, void *taskContext) {
+    if (minRange < 1) {
+        minRange = 1;
+    }
+
+    // A single-block task is cheaper to run here than to hand off, except for
+    // single-item tasks: Box2D's solver issues one per worker and expects them
+    // to run concurrently.
+    int runInline = (itemCount > 1 && itemCount <= minRange);
+
+    PoolTask *task = NULL;
+    if (pool != NULL && pool->workerCount > 1 && !runInline) {
+        for (int i = 0; i < TASK_POOL_MAX_TASKS; i++) {
+            if (!pool->tasks[i].inUse) {
+                task = &pool->tasks[i];
+                break;
+            }
+        }
+    }
+    if (task == NULL) {
+        // Single-threaded pool, tiny task or no free slot: run it now
+        fn(0, itemCount, 0, taskContext);
+        return NULL;
+    }
+
+    int sliceCount = itemCount / minRange;
+    if (sliceCount > pool->workerCount) {
+        sliceCount = pool->workerCount;
+    }
+    if (sliceCount < 1) {
+        sliceCount = 1;
+    }
+
+    task->inUse = 1;
+    task->fn = fn;
+    task->context = taskContext;
+    task->blockSize = minRange;
+    task->sliceCount = sliceCount;
+    task->pendingItems = itemCount;
+    task->users = 0;
+    int perSlice = itemCount / sliceCount;
+    int remainder = itemCount % sliceCount;
+    int start = 0;
+    for (int i = 0; i < sliceCount; i++) {
+        int size = perSlice + (i < remainder ? 1 : 0);
+        task->slices[i].next = start;
+        task->slices[i].end = start + size;
+        start += size;
+    }
+
+    // Publishing under the mutex orders the stores above before any worker reads them
+    pthread_mutex_lock(&pool->mutex);
+    pool->queue[pool->queueCount++] = task;
+    if (sliceCount >= pool->workerCount - 1) {
+        pthread_cond_broadcast(&pool->wake);
+    } else {
+        for (int i = 0; i < sliceCount; i++) {
+            pthread_cond_signal(&pool->wake);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return task;
+}
+
+void TaskPool_FinishTask(TaskPool *pool, void *userTask) {
+    PoolTask *task = (PoolTask *)userTask;
+    if (task == NULL) {
+        return;
+    }
+
+    task_run(task, 0);
+
+    // No unclaimed items remain; stop new threads from picking the task up
+    pthread_mutex_lock(&pool->mutex);
+    queue_remove(pool, task);
+    pthread_mutex_unlock(&pool->mutex);
+
+    // Wait for blocks other workers claimed, and for them to leave the task
+    while (__atomic_load_n(&task->pendingItems, __ATOMIC_ACQUIRE) > 0 ||
+           __atomic_load_n(&task->users, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+    task->inUse = 0;
+}
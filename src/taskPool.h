@@ -0,0 +1,38 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <stdint.h>
+
+/*
+ * taskPool.h - Small work-stealing thread pool for parallel-for style tasks
+ *
+ * Built for Box2D's task interface (b2WorldDef.enqueueTask / finishTask) but has
+ * no Box2D dependency. A task covers items [0, itemCount); each worker starts on
+ * its own slice and steals blocks of minRange items from the other slices once
+ * it runs dry. The calling thread is worker 0 and helps in TaskPool_FinishTask,
+ * so a pool of N workers starts N - 1 threads.
+ */
+
+typedef struct TaskPoolObject TaskPool;
+
+// Same signature as Box2D's b2TaskCallback
+typedef void TaskPoolFn(int startIndex, int endIndex, uint32_t workerIndex, void *taskContext);
+
+// Largest supported worker count (including the calling thread)
+#define TASK_POOL_MAX_WORKERS 16
+
+// Create a pool. workerCount <= 0 picks the number of online CPUs.
+// The result is clamped to [1, TASK_POOL_MAX_WORKERS]; 1 runs everything inline.
+TaskPool *TaskPool_Create(int workerCount);
+void TaskPool_Destroy(TaskPool *pool);
+
+int TaskPool_GetWorkerCount(const TaskPool *pool);
+
+// Start a task. Returns a handle for TaskPool_FinishTask, or NULL if the task
+// was small enough (or the pool busy enough) that it already ran inline.
+void *TaskPool_EnqueueTask(TaskPool *pool, TaskPoolFn *fn, int itemCount, int minRange, void *taskContext);
+
+// Help run the task on the calling thread, then wait until every item is done.
+void TaskPool_FinishTask(TaskPool *pool, void *userTask);
+
+#endif // TASK_POOL_H
@@ -0,0 +1,87 @@
+/*
+ * textRun.c - Retained text layout for UI strings drawn every frame (see textRun.h)
+ *
+ * The glyph placement follows raylib's DrawTextEx / DrawTextCodepoint.
+ */
+
+#include "textRun.h"
+#include "rlgl.h"
+#include <string.h>
+
+Vector2 TextRun_Layout(TextRun *run, Font font, const char *text, float fontSize, float spacing) {
+    if (run->fontTexture == font.texture.id && run->fontSize == fontSize &&
+        run->spacing == spacing && strncmp(run->text, text, TEXT_RUN_MAX_CHARS) == 0) {
+        return run->size;
+    }
+
+    strncpy(run->text, text, TEXT_RUN_MAX_CHARS);
+    run->text[TEXT_RUN_MAX_CHARS] = '\0';
+    run->fontTexture = font.texture.id;
+    run->fontSize = fontSize;
+    run->spacing = spacing;
+    run->size = MeasureTextEx(font, run->text, fontSize, spacing);
+    run->numGlyphs = 0;
+
+    float scale = fontSize / font.baseSize;
+    float padding = (float)font.glyphPadding;
+    float textureWidth = (float)font.texture.width;
+    float textureHeight = (float)font.texture.height;
+    float offsetX = 0.0f;
+    int length = (int)strlen(run->text);
+    for (int i = 0; i < length;) {
+        int bytes = 0;
+        int codepoint = GetCodepointNext(&run->text[i], &bytes);
+        int index = GetGlyphIndex(font, codepoint);
+        Rectangle rec = font.recs[index];
+
+        if (codepoint != ' ' && codepoint != '\t') {
+            float *uv = run->uv[run->numGlyphs];
+            uv[0] = (rec.x - padding) / textureWidth;
+            uv[1] = (rec.y - padding) / textureHeight;
+            uv[2] = (rec.x + rec.width + padding) / textureWidth;
+            uv[3] = (rec.y + rec.height + padding) / textureHeight;
+            run->quads[run->numGlyphs] = (Rectangle){
+                offsetX + (font.glyphs[index].offsetX - padding) * scale,
+                (font.glyphs[index].offsetY - padding) * scale,
+                (rec.width + 2.0f * padding) * scale,
+                (rec.height + 2.0f * padding) * scale
+            };
+            run->numGlyphs++;
+        }
+        if (font.glyphs[index].advanceX == 0) {
+            offsetX += rec.width * scale + spacing;
+        } else {
+            offsetX += font.glyphs[index].advanceX * scale + spacing;
+        }
+        i += bytes;
+    }
+    return run->size;
+}
+
+void TextRun_Draw(const TextRun *run, Font font, Vector2 position, Color tint) {
+    if (run->numGlyphs == 0) {
+        return;
+    }
+    rlCheckRenderBatchLimit(4 * run->numGlyphs);
+    rlSetTexture(font.texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+    for (int g = 0; g < run->numGlyphs; g++) {
+        const float *uv = run->uv[g];
+        float x = position.x + run->quads[g].x;
+        float y = position.y + run->quads[g].y;
+        float w = run->quads[g].width;
+        float h = run->quads[g].height;
+        rlTexCoord2f(uv[0], uv[1]);
+        rlVertex2f(x, y);
+        rlTexCoord2f(uv[0], uv[3]);
+        rlVertex2f(x, y + h);
+        rlTexCoord2f(uv[2], uv[3]);
+        rlVertex2f(x + w, y + h);
+        rlTexCoord2f(uv[2], uv[1]);
+        rlVertex2f(x + w, y);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
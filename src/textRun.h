@@ -0,0 +1,40 @@
+#ifndef TEXT_RUN_H
+#define TEXT_RUN_H
+
+#include "raylib.h"
+
+/*
+ * textRun.h - Retained text layout for UI strings drawn every frame
+ *
+ * DrawTextEx looks up every glyph (a linear search of the font) and
+ * MeasureTextEx walks the string again, each frame, for strings that rarely
+ * change: the score table, the game-over name and the launch prompt. A
+ * TextRun keeps one string's glyph quads and size. TextRun_Layout redoes them
+ * only when the text, font or size differ from the last call, and
+ * TextRun_Draw writes the stored quads straight into rlgl's batch.
+ *
+ * Output matches MeasureTextEx / DrawTextEx for single-line text. Text longer
+ * than TEXT_RUN_MAX_CHARS bytes is cut there.
+ */
+
+#define TEXT_RUN_MAX_CHARS 63
+
+typedef struct {
+    char text[TEXT_RUN_MAX_CHARS + 1];
+    unsigned int fontTexture;   // font the run was laid out with (0 = never laid out)
+    float fontSize;
+    float spacing;
+    Vector2 size;               // as MeasureTextEx
+    int numGlyphs;
+    float uv[TEXT_RUN_MAX_CHARS][4];        // u0, v0, u1, v1 in the font texture
+    Rectangle quads[TEXT_RUN_MAX_CHARS];    // relative to the draw position
+} TextRun;
+
+// Lay out text in run unless it already holds this text, font and size.
+// Returns the text's size.
+Vector2 TextRun_Layout(TextRun *run, Font font, const char *text, float fontSize, float spacing);
+
+// Draw the run with its top left at position (font must be the layout's)
+void TextRun_Draw(const TextRun *run, Font font, Vector2 position, Color tint);
+
+#endif // TEXT_RUN_H
@@ -1,6 +1,8 @@
 #include "ui.h"
 #include "constants.h"
+#include "game.h"
 #include "raylib.h"
+#include "textRun.h"
 #include <stdio.h>
 #include <math.h>
 #include <sys/time.h>
@@ -12,75 +14,120 @@ static long long millis() {
     return milliseconds;
 }
 
-void UI_DrawMenu(const GameStruct *game, const Resources *res,
-                 const MenuPinball *menuPinballs, int numMenuPinballs,
-                 ScoreHelper *scores, long long elapsedTimeStart,
-                 float shaderSeconds) {
-    
-    ClearBackground((Color){255,183,0,255});
-    float timeFactor = (millis() - elapsedTimeStart) / 1000.0f;
+// Laid-out text for the strings below (see textRun.h); each is re-laid out
+// only when its text changes, e.g. when the score table is reloaded
+static TextRun topScoresRun;
+static TextRun scoreRuns[10][3];    // rank, name (or "No Score"), value
+static TextRun modeRun;
+static TextRun gameOverRuns[2];     // "Score:", the score
+static TextRun nameRuns[5];
+static TextRun nameBlankRun;
+static TextRun replayRun;
+
+/*
+ * ui_draw_menu_background
+ *  - bgMenu as a quad three times the canvas size, offset and rotated over
+ *    time. menuBackground.fs does the rotation and offset per fragment on a
+ *    canvas-sized quad, so only the visible canvas is shaded (the big quad was
+ *    nine canvases of fragment work). Without the shader, the big quad is drawn.
+ */
+static void ui_draw_menu_background(const Resources *res, float timeFactor) {
     float xOffset = sin(timeFactor) * 50.0f;
     float yOffset = cos(timeFactor) * 50.0f;
     float angle = sin(timeFactor * 2) * 20 + cos(timeFactor / 3) * 25;
     float width = screenWidth * 3;
     float height = screenHeight * 3;
-
-    bool useSwirl = IsShaderValid(res->swirlShader);
-#if defined(PLATFORM_RPI)
-    // On Raspberry Pi with DRM/GLES, swirl shader can be problematic; disable if needed.
-    useSwirl = false;
-#endif
-
-    if (useSwirl) {
-        BeginShaderMode(res->swirlShader);
+    Vector2 center = { xOffset + screenWidth/2, yOffset + screenWidth/2 };
+
+    if (!IsShaderValid(res->menuBgShader)) {
+        DrawTexturePro(res->bgMenu,
+                       (Rectangle){0,0,res->bgMenu.width,res->bgMenu.height},
+                       (Rectangle){center.x,center.y,width,height},
+                       (Vector2){width/2,height/2},
+                       angle,
+                       WHITE);
+        return;
     }
 
+    float size[2] = { width, height };
+    float rotation[2] = { cosf(angle * DEG2RAD), sinf(angle * DEG2RAD) };
+    SetShaderValue(res->menuBgShader, res->menuBgCenterLoc, &center, SHADER_UNIFORM_VEC2);
+    SetShaderValue(res->menuBgShader, res->menuBgSizeLoc, size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(res->menuBgShader, res->menuBgRotationLoc, rotation, SHADER_UNIFORM_VEC2);
+
+    BeginShaderMode(res->menuBgShader);
     DrawTexturePro(res->bgMenu,
                    (Rectangle){0,0,res->bgMenu.width,res->bgMenu.height},
-                   (Rectangle){xOffset + screenWidth/2,yOffset + screenWidth/2,width,height},
-                   (Vector2){width/2,height/2},
-                   angle,
+                   (Rectangle){0,0,screenWidth,screenHeight},
+                   (Vector2){0,0},
+                   0,
                    WHITE);
+    EndShaderMode();
+}
 
-    if (useSwirl) {
-        EndShaderMode();
-    }
+void UI_DrawMenu(const GameStruct *game, const Resources *res,
+                 const MenuPinball *menuPinballs, int numMenuPinballs,
+                 ScoreHelper *scores, long long elapsedTimeStart,
+                 float shaderSeconds) {
+    
+    ClearBackground((Color){255,183,0,255});
+    float timeFactor = (millis() - elapsedTimeStart) / 1000.0f;
+    ui_draw_menu_background(res, timeFactor);
 
     // Render pinballs
     for (int i = 0; i < numMenuPinballs; i++){
-        DrawTexturePro(res->ballTex,(Rectangle){0,0,res->ballTex.width,res->ballTex.height},(Rectangle){menuPinballs[i].px,menuPinballs[i].py,30,30},(Vector2){0,0},0,(Color){255,183,0,255});
+        DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_BALL],(Rectangle){menuPinballs[i].px,menuPinballs[i].py,30,30},(Vector2){0,0},0,(Color){255,183,0,255});
     }
 
     DrawTexturePro(res->menuOverlay1,(Rectangle){0,0,res->titleOverlay.width,res->titleOverlay.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
     DrawTexturePro(res->titleOverlay,(Rectangle){0,0,res->titleOverlay.width,res->titleOverlay.height},(Rectangle){0,12 + sin(timeFactor)*5.0f,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
 
     if (game->menuState == 0){
-        DrawTextEx(res->font1, "Top Scores", (Vector2){153,329}, 36.0, 1.0, WHITE);
+        TextRun_Layout(&topScoresRun, res->font1, "Top Scores", 36.0, 1.0);
+        TextRun_Draw(&topScoresRun, res->font1, (Vector2){153,329}, WHITE);
         float y = 362;
         char tempString[128];
+        // Leader lines are drawn after the text, so all of the table's text
+        // stays in one batch
+        Vector2 lineStart[10];
+        Vector2 lineEnd[10];
+        int numLines = 0;
         for (int i = 1; i <= 10; i++){
+            TextRun *row = scoreRuns[i - 1];
             ScoreObject *score = getRankedScore(scores,i);
+            sprintf(tempString,"%d)",i);
+            float rankWidth = TextRun_Layout(&row[0], res->font1, tempString, 27.0, 1.0).x;
             if (score != NULL){
-                sprintf(tempString,"%d)",i);
-                DrawTextEx(res->font1, tempString, (Vector2){66 - MeasureTextEx(res->font1, tempString, 27.0, 1.0).x,y}, 27.0, 1.0, WHITE);
-                sprintf(tempString,"%s",score->scoreName);
-                DrawTextEx(res->font1, tempString, (Vector2){75,y}, 27.0, 1.0, WHITE);
-                float scoreNameWidth = MeasureTextEx(res->font1, tempString, 27.0, 1.0).x;
+                TextRun_Draw(&row[0], res->font1, (Vector2){66 - rankWidth,y}, WHITE);
+                float scoreNameWidth = TextRun_Layout(&row[1], res->font1, score->scoreName, 27.0, 1.0).x;
+                TextRun_Draw(&row[1], res->font1, (Vector2){75,y}, WHITE);
                 sprintf(tempString,"%d",score->scoreValue);
-                float scoreValueWidth = MeasureTextEx(res->font1, tempString, 27.0, 1.0).x;
-                DrawTextEx(res->font1, tempString, (Vector2){404 - scoreValueWidth,y}, 27.0, 1.0, WHITE);
+                float scoreValueWidth = TextRun_Layout(&row[2], res->font1, tempString, 27.0, 1.0).x;
+                TextRun_Draw(&row[2], res->font1, (Vector2){404 - scoreValueWidth,y}, WHITE);
                 float lineY = y + 27.0 / 2.0f - 1.0f;
-                DrawLineEx((Vector2){75 + (scoreNameWidth + 10),lineY}, (Vector2){404 - (scoreValueWidth + 10),lineY}, 2, (Color){255,255,255,50});
+                lineStart[numLines] = (Vector2){75 + (scoreNameWidth + 10),lineY};
+                lineEnd[numLines] = (Vector2){404 - (scoreValueWidth + 10),lineY};
+                numLines++;
             } else {
-                sprintf(tempString,"%d)",i);
-                DrawTextEx(res->font1, tempString, (Vector2){66 - MeasureTextEx(res->font1, tempString, 27.0, 1.0).x,y}, 27.0, 1.0, GRAY);
-                DrawTextEx(res->font1, "No Score", (Vector2){75,y}, 27.0, 1.0, GRAY);
+                TextRun_Draw(&row[0], res->font1, (Vector2){66 - rankWidth,y}, GRAY);
+                TextRun_Layout(&row[1], res->font1, "No Score", 27.0, 1.0);
+                TextRun_Draw(&row[1], res->font1, (Vector2){75,y}, GRAY);
             }
             y += (27.0 * 0.8) + 2;
         }
+        for (int i = 0; i < numLines; i++){
+            DrawLineEx(lineStart[i], lineEnd[i], 2, (Color){255,255,255,50});
+        }
     } else if (game->menuState == 1){
         DrawTexturePro(res->menuControls,(Rectangle){0,0,res->menuControls.width,res->menuControls.height},(Rectangle){26,320,res->menuControls.width/2,res->menuControls.height/2},(Vector2){0,0},0,WHITE);
     }
+
+    // Game mode; on the controls page, left again cycles it (Menu_Update)
+    char modeString[64];
+    sprintf(modeString, game->menuState == 1 ? "Mode: %s  (left to change)" : "Mode: %s",
+            Game_GetModeName(game->pendingMode));
+    float modeWidth = TextRun_Layout(&modeRun, res->font1, modeString, 27.0, 1.0).x;
+    TextRun_Draw(&modeRun, res->font1, (Vector2){screenWidth/2 - modeWidth/2, screenHeight - 90}, WHITE);
 }
 
 void UI_DrawGameOver(const GameStruct *game, const Resources *res,
@@ -90,35 +137,10 @@ void UI_DrawGameOver(const GameStruct *game, const Resources *res,
     
     ClearBackground((Color){255,183,0,255});
     float timeFactor = (millis() - elapsedTimeStart) / 1000.0f;
-    float xOffset = sin(timeFactor) * 50.0f;
-    float yOffset = cos(timeFactor) * 50.0f;
-    float angle = sin(timeFactor * 2) * 20 + cos(timeFactor / 3) * 25;
-    float width = screenWidth * 3;
-    float height = screenHeight * 3;
-
-    bool useSwirl = IsShaderValid(res->swirlShader);
-#if defined(PLATFORM_RPI)
-    // On Raspberry Pi with DRM/GLES, swirl shader can be problematic; disable if needed.
-    useSwirl = false;
-#endif
-
-    if (useSwirl) {
-        BeginShaderMode(res->swirlShader);
-    }
-
-    DrawTexturePro(res->bgMenu,
-                   (Rectangle){0,0,res->bgMenu.width,res->bgMenu.height},
-                   (Rectangle){xOffset + screenWidth/2,yOffset + screenWidth/2,width,height},
-                   (Vector2){width/2,height/2},
-                   angle,
-                   WHITE);
-
-    if (useSwirl) {
-        EndShaderMode();
-    }
+    ui_draw_menu_background(res, timeFactor);
 
     for (int i = 0; i < numMenuPinballs; i++){
-        DrawTexturePro(res->ballTex,(Rectangle){0,0,res->ballTex.width,res->ballTex.height},(Rectangle){menuPinballs[i].px,menuPinballs[i].py,30,30},(Vector2){0,0},0,(Color){0,0,0,50});
+        DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_BALL],(Rectangle){menuPinballs[i].px,menuPinballs[i].py,30,30},(Vector2){0,0},0,(Color){0,0,0,50});
     }
 
     DrawTexturePro(res->gameOverOverlay1,(Rectangle){0,0,res->gameOverOverlay1.width,res->gameOverOverlay1.height},(Rectangle){0,0,screenWidth,screenHeight},(Vector2){0,0},0,WHITE);
@@ -126,19 +148,44 @@ void UI_DrawGameOver(const GameStruct *game, const Resources *res,
 
     char tempString[128];
     sprintf(tempString,"%ld",game->gameScore);
-    DrawTextEx(res->font2, "Score:", (Vector2){screenWidth/2 - MeasureTextEx(res->font2, "Score:", 60, 1.0).x/2,275}, 60, 1.0, WHITE);
-    DrawTextEx(res->font2, tempString, (Vector2){screenWidth/2 - MeasureTextEx(res->font2, tempString, 60, 1.0).x/2,332}, 60, 1.0, WHITE);
+    float labelWidth = TextRun_Layout(&gameOverRuns[0], res->font2, "Score:", 60, 1.0).x;
+    TextRun_Draw(&gameOverRuns[0], res->font2, (Vector2){screenWidth/2 - labelWidth/2,275}, WHITE);
+    float scoreWidth = TextRun_Layout(&gameOverRuns[1], res->font2, tempString, 60, 1.0).x;
+    TextRun_Draw(&gameOverRuns[1], res->font2, (Vector2){screenWidth/2 - scoreWidth/2,332}, WHITE);
 
+    TextRun_Layout(&nameBlankRun, res->font2, "-", 60, 1.0);
     for (int i =0; i < 5; i++){
         sprintf(tempString,"%c",nameString[i]);
-        float textWidth = MeasureTextEx(res->font2, tempString, 60, 1.0).x;
+        float textWidth = TextRun_Layout(&nameRuns[i], res->font2, tempString, 60, 1.0).x;
         if (nameString[i] == 32){
-            DrawTextEx(res->font2, "-", (Vector2){54 + (i * 62) - textWidth / 2,510}, 60, 1.0, DARKGRAY);
+            TextRun_Draw(&nameBlankRun, res->font2, (Vector2){54 + (i * 62) - textWidth / 2,510}, DARKGRAY);
         } else {
-            DrawTextEx(res->font2, tempString, (Vector2){54 + (i * 62) - textWidth / 2,510}, 60, 1.0, WHITE);
+            TextRun_Draw(&nameRuns[i], res->font2, (Vector2){54 + (i * 62) - textWidth / 2,510}, WHITE);
         }
     }
-    DrawTexturePro(res->arrowRight,(Rectangle){0,0,res->arrowRight.width,res->arrowRight.height},(Rectangle){54 + (game->nameSelectIndex * 62),595+ (5 * sin((millis()-elapsedTimeStart)/200.0f)),32,32},(Vector2){16,16},-90,WHITE);
+    DrawTexturePro(res->spriteAtlas,res->sprites[SPRITE_ARROW_RIGHT],(Rectangle){54 + (game->nameSelectIndex * 62),595+ (5 * sin((millis()-elapsedTimeStart)/200.0f)),32,32},(Vector2){16,16},-90,WHITE);
+}
+
+void UI_DrawReplay(const Resources *res, Texture2D replay, int frame, int numFrames) {
+    // A sixth of the canvas in the bottom right corner, measured from the
+    // canvas edges. Between the score table (or name entry) and the bottom
+    // there is no room for a wider panel, and this one stays right of the
+    // centred mode line (UI_DrawMenu) and below the score values.
+    const float margin = 12.0f;
+    const float width = screenWidth / 6.0f;
+    const float height = screenHeight / 6.0f;
+    const float x = screenWidth - width - margin;
+    const float y = screenHeight - height - margin;
+
+    DrawRectangle(x - 4, y - 4, width + 8, height + 8, (Color){0,0,0,120});
+    // src.height is negative: render textures are stored upside down
+    DrawTexturePro(replay, (Rectangle){0, 0, (float)replay.width, -(float)replay.height},
+                   (Rectangle){x, y, width, height}, (Vector2){0,0}, 0, WHITE);
+
+    float progress = numFrames > 1 ? (float)frame / (numFrames - 1) : 1.0f;
+    DrawRectangle(x, y + height - 4, width * progress, 4, WHITE);
+    TextRun_Layout(&replayRun, res->font1, "Replay", 20.0, 1.0);
+    TextRun_Draw(&replayRun, res->font1, (Vector2){x, y - 26}, WHITE);
 }
 
 void UI_DrawTransition(const GameStruct *game, float shaderSeconds) {
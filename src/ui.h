@@ -22,6 +22,10 @@ void UI_DrawGameOver(const GameStruct *game, const Resources *res,
                      const char *nameString, long long elapsedTimeStart,
                      float shaderSeconds);
 
+// Draws the instant replay panel: `replay` holds a full-size Render_Gameplay
+// frame, shown scaled down in the bottom right corner with a progress bar
+void UI_DrawReplay(const Resources *res, Texture2D replay, int frame, int numFrames);
+
 // Draws transition overlays (screen wipes)
 void UI_DrawTransition(const GameStruct *game, float shaderSeconds);
 
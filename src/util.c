@@ -1,5 +1,6 @@
 #include "util.h"
 #include <sys/time.h>
+#include <time.h>
 #include <stddef.h>
 
 long long millis(void) {
@@ -8,3 +9,9 @@ long long millis(void) {
     long long milliseconds = te.tv_sec*1000LL + te.tv_usec/1000;
     return milliseconds;
 }
+
+long long nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
@@ -4,4 +4,7 @@
 // Get current time in milliseconds since epoch
 long long millis(void);
 
+// Get a monotonic timestamp in nanoseconds (for profiling and fixed timestepping)
+long long nanos(void);
+
 #endif // UTIL_H
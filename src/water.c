@@ -1,5 +1,4 @@
 #include "water.h"
-#include "raylib.h"
 #include <math.h>
 
 void Water_Init(WaterSystem *ws) {
@@ -17,17 +16,23 @@ void Water_AddImpulse(WaterSystem *ws, float xWorld, float impulse) {
     }
 }
 
-void Water_Update(WaterSystem *ws, Resources *res, float dt) {
+void Water_Splash(WaterSystem *ws, float xWorld, float impulse) {
+    Water_AddImpulse(ws, xWorld, impulse);
+    ws->impactIntensity += 0.6f;
+    if (ws->impactIntensity > 1.5f) {
+        ws->impactIntensity = 1.5f;
+    }
+}
+
+void Water_Step(WaterSystem *ws, float time) {
     // Decay water impact intensity
     ws->impactIntensity *= 0.95f;
     if (ws->impactIntensity < 0.0f) ws->impactIntensity = 0.0f;
     if (ws->impactIntensity > 1.0f) ws->impactIntensity = 1.0f;
 
-    float t = GetTime();
-    
     // Add idle wave motion
     for (int i = 0; i < RIPPLE_SAMPLES; i++) {
-        ws->rippleHeight[i] += 0.002f * sinf(t * 1.5f + i * 0.15f);
+        ws->rippleHeight[i] += 0.002f * sinf(time * 1.5f + i * 0.15f);
     }
 
     // Neighbor propagation (spring-like behavior)
@@ -41,18 +46,4 @@ void Water_Update(WaterSystem *ws, Resources *res, float dt) {
         ws->rippleVelocity[i] *= 0.985f;
         ws->rippleHeight[i] += ws->rippleVelocity[i];
     }
-
-    // Update ripple texture
-    unsigned char rippleData[RIPPLE_SAMPLES * 4];
-    for (int i = 0; i < RIPPLE_SAMPLES; i++) {
-        // Convert float height to grayscale byte (centered at 128)
-        int val = (int)(128.0f + ws->rippleHeight[i] * 50.0f);
-        if (val < 0) val = 0;
-        if (val > 255) val = 255;
-        rippleData[i * 4 + 0] = (unsigned char)val;
-        rippleData[i * 4 + 1] = (unsigned char)val;
-        rippleData[i * 4 + 2] = (unsigned char)val;
-        rippleData[i * 4 + 3] = 255;
-    }
-    UpdateTexture(res->rippleTexture, rippleData);
 }
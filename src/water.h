@@ -2,7 +2,6 @@
 #define WATER_H
 
 #include "constants.h"
-#include "resources.h"
 
 typedef struct {
     float rippleHeight[RIPPLE_SAMPLES];
@@ -16,7 +15,10 @@ void Water_Init(WaterSystem *ws);
 // Add impulse to water at a specific x world coordinate
 void Water_AddImpulse(WaterSystem *ws, float xWorld, float impulse);
 
-// Update water simulation and shader parameters
-void Water_Update(WaterSystem *ws, Resources *res, float dt);
+// Add a ripple impulse and kick the impact intensity (ball hitting the surface)
+void Water_Splash(WaterSystem *ws, float xWorld, float impulse);
+
+// Advance the ripple simulation; time drives the idle wave motion
+void Water_Step(WaterSystem *ws, float time);
 
 #endif // WATER_H